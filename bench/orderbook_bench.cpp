@@ -0,0 +1,425 @@
+#include <benchmark/benchmark.h>
+
+#include "MatchingEngine.h"
+#include "MpscRing.h"
+#include "OrderBook.h"
+#include "OrderCommand.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <thread>
+#include <vector>
+
+// Every heap allocation in the process is counted, so each benchmark can
+// report allocations per operation next to its time. The replacements are
+// kept out of line: inlined, GCC would see free() applied to the result of a
+// new-expression and warn about a mismatched pair (-Wmismatched-new-delete).
+namespace
+{
+    std::atomic<uint64_t> g_allocations(0);
+}
+
+__attribute__((noinline)) void *operator new(std::size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size ? size : 1))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+__attribute__((noinline)) void operator delete(void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+namespace
+{
+    constexpr double kMid = 100.0;
+    constexpr double kTick = 0.01;
+
+    // Counts allocations made between construction and report()
+    class AllocationCounter
+    {
+    public:
+        AllocationCounter() : start_(g_allocations.load(std::memory_order_relaxed)) {}
+
+        void report(benchmark::State &state) const
+        {
+            double allocations = static_cast<double>(g_allocations.load(std::memory_order_relaxed) - start_);
+            state.counters["allocs_per_op"] = benchmark::Counter(allocations, benchmark::Counter::kAvgIterations);
+        }
+
+    private:
+        uint64_t start_;
+    };
+
+    // depth levels per side around kMid, orders_per_level orders each
+    void fill_book(OrderBook &book, int depth, int orders_per_level)
+    {
+        for (int level = 1; level <= depth; ++level)
+        {
+            for (int i = 0; i < orders_per_level; ++i)
+            {
+                Order bid(Strategy::OTHER, 10, kMid - level * kTick, OrderSide::BUY, OrderType::LIMIT);
+                Order ask(Strategy::OTHER, 10, kMid + level * kTick, OrderSide::SELL, OrderType::LIMIT);
+                book.add_order(bid);
+                book.add_order(ask);
+            }
+        }
+    }
+
+    // Orders built up front so the timed loop measures the book, not Order's clock reads
+    std::vector<Order> passive_orders(size_t count, int depth, uint32_t seed)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> level(1, std::max(depth, 1));
+        std::vector<Order> orders;
+        orders.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            bool buy = (i & 1) == 0;
+            double price = buy ? kMid - level(rng) * kTick : kMid + level(rng) * kTick;
+            orders.emplace_back(Strategy::OTHER, 10, price, buy ? OrderSide::BUY : OrderSide::SELL, OrderType::LIMIT);
+        }
+        return orders;
+    }
+
+    double percentile(std::vector<int64_t> &samples, double p)
+    {
+        if (samples.empty())
+        {
+            return 0.0;
+        }
+        size_t index = std::min(samples.size() - 1, static_cast<size_t>(p * static_cast<double>(samples.size())));
+        std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+        return static_cast<double>(samples[index]);
+    }
+
+    void report_percentiles(benchmark::State &state, std::vector<int64_t> &samples)
+    {
+        state.counters["p50_ns"] = percentile(samples, 0.50);
+        state.counters["p90_ns"] = percentile(samples, 0.90);
+        state.counters["p99_ns"] = percentile(samples, 0.99);
+        state.counters["p999_ns"] = percentile(samples, 0.999);
+    }
+}
+
+// Resting a non-marketable limit order on a book with range(0) levels per side
+static void BM_AddOrder(benchmark::State &state)
+{
+    const int depth = static_cast<int>(state.range(0));
+    const size_t batch = 4096;
+    OrderBook book(kTick);
+    fill_book(book, depth, 4);
+    std::vector<Order> orders = passive_orders(batch, depth, 1);
+
+    AllocationCounter allocations;
+    size_t next = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(book.add_order(orders[next]));
+        if (++next == batch)
+        {
+            // Take the batch back out so the book stays at the same depth
+            state.PauseTiming();
+            for (const Order &order : orders)
+            {
+                book.cancel_order(order.get_id());
+            }
+            next = 0;
+            state.ResumeTiming();
+        }
+    }
+    allocations.report(state);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AddOrder)->Arg(1)->Arg(10)->Arg(100)->Arg(1000);
+
+// Cancelling by id from a book with range(0) levels per side
+static void BM_CancelOrder(benchmark::State &state)
+{
+    const int depth = static_cast<int>(state.range(0));
+    const size_t batch = 4096;
+    OrderBook book(kTick);
+    fill_book(book, depth, 4);
+    std::vector<Order> orders = passive_orders(batch, depth, 2);
+    for (Order &order : orders)
+    {
+        book.add_order(order);
+    }
+
+    // Cancel in a shuffled order so removals hit the middle of levels
+    std::vector<uint64_t> ids;
+    for (const Order &order : orders)
+    {
+        ids.push_back(order.get_id());
+    }
+    std::shuffle(ids.begin(), ids.end(), std::mt19937(3));
+
+    AllocationCounter allocations;
+    size_t next = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(book.cancel_order(ids[next]));
+        if (++next == batch)
+        {
+            state.PauseTiming();
+            for (Order &order : orders)
+            {
+                book.add_order(order);
+            }
+            next = 0;
+            state.ResumeTiming();
+        }
+    }
+    allocations.report(state);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CancelOrder)->Arg(1)->Arg(10)->Arg(100)->Arg(1000);
+
+// One aggressive order sweeping range(0) ask levels of range(1) orders each
+static void BM_MatchSweep(benchmark::State &state)
+{
+    const int levels = static_cast<int>(state.range(0));
+    const int orders_per_level = static_cast<int>(state.range(1));
+    OrderBook book(kTick);
+    std::vector<Order> asks;
+    for (int level = 1; level <= levels; ++level)
+    {
+        for (int i = 0; i < orders_per_level; ++i)
+        {
+            asks.emplace_back(Strategy::OTHER, 10, kMid + level * kTick, OrderSide::SELL, OrderType::LIMIT);
+        }
+    }
+    const int sweep_quantity = 10 * levels * orders_per_level;
+    Order taker(Strategy::OTHER, sweep_quantity, kMid + levels * kTick, OrderSide::BUY, OrderType::LIMIT);
+
+    // Refilling the book is left out of the manual timing
+    AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        for (Order &ask : asks)
+        {
+            book.add_order(ask);
+        }
+        taker.set_quantity(sweep_quantity);
+
+        auto start = std::chrono::steady_clock::now();
+        book.match_orders(taker);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        benchmark::DoNotOptimize(taker.get_quantity());
+        state.SetIterationTime(std::chrono::duration<double>(elapsed).count());
+    }
+    allocations.report(state);
+    state.SetItemsProcessed(state.iterations() * levels * orders_per_level); // fills
+}
+BENCHMARK(BM_MatchSweep)->ArgsProduct({{1, 4, 16, 64}, {1, 8}})->UseManualTime();
+
+// The same 16-level sweep for each matching kernel: range(0) picks the taker
+// side (0 buy, 1 sell) and range(1) its type (0 limit, 1 market)
+static void BM_MatchKernel(benchmark::State &state)
+{
+    const bool sell = state.range(0) != 0;
+    const OrderType type = state.range(1) != 0 ? OrderType::MARKET : OrderType::LIMIT;
+    const int levels = 16;
+    const int orders_per_level = 4;
+    const OrderSide resting_side = sell ? OrderSide::BUY : OrderSide::SELL;
+    const double step = sell ? -kTick : kTick;
+
+    OrderBook book(kTick);
+    std::vector<Order> resting;
+    for (int level = 1; level <= levels; ++level)
+    {
+        for (int i = 0; i < orders_per_level; ++i)
+        {
+            resting.emplace_back(Strategy::OTHER, 10, kMid + level * step, resting_side, OrderType::LIMIT);
+        }
+    }
+    const int sweep_quantity = 10 * levels * orders_per_level;
+    Order taker(Strategy::OTHER, sweep_quantity, kMid + levels * step, sell ? OrderSide::SELL : OrderSide::BUY, type);
+
+    AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        for (Order &order : resting)
+        {
+            book.add_order(order);
+        }
+        taker.set_quantity(sweep_quantity);
+
+        auto start = std::chrono::steady_clock::now();
+        book.match_orders(taker);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        benchmark::DoNotOptimize(taker.get_quantity());
+        state.SetIterationTime(std::chrono::duration<double>(elapsed).count());
+    }
+    allocations.report(state);
+    state.SetItemsProcessed(state.iterations() * levels * orders_per_level);
+}
+BENCHMARK(BM_MatchKernel)->ArgNames({"sell", "market"})->ArgsProduct({{0, 1}, {0, 1}})->UseManualTime();
+
+// A generated flow of passive adds, cancels and marketable orders, timed per
+// operation for percentiles. range(0) is the book depth, range(1) the percent
+// of cancels and range(2) the percent of marketable orders. Only the book
+// call is timed; generating the next order is not.
+static void BM_OrderMix(benchmark::State &state)
+{
+    const int depth = static_cast<int>(state.range(0));
+    const int cancel_percent = static_cast<int>(state.range(1));
+    const int marketable_percent = static_cast<int>(state.range(2));
+
+    OrderBook book(kTick);
+    fill_book(book, depth, 4);
+
+    std::mt19937 rng(4);
+    std::uniform_int_distribution<int> roll(0, 99);
+    std::uniform_int_distribution<int> level(1, std::max(depth, 1));
+    std::vector<uint64_t> resting;
+    resting.reserve(1 << 20);
+
+    std::vector<int64_t> samples;
+    samples.reserve(1 << 20);
+
+    AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        int kind = roll(rng);
+        bool buy = roll(rng) < 50;
+        bool cancel = kind < cancel_percent && !resting.empty();
+        bool marketable = !cancel && kind < cancel_percent + marketable_percent;
+        double price = marketable ? (buy ? kMid + kTick : kMid - kTick)
+                                  : (buy ? kMid - level(rng) * kTick : kMid + level(rng) * kTick);
+        Order order(Strategy::OTHER, marketable ? 5 : 10, price, buy ? OrderSide::BUY : OrderSide::SELL, OrderType::LIMIT);
+        uint64_t cancel_id = 0;
+        if (cancel)
+        {
+            size_t index = static_cast<size_t>(rng() % resting.size());
+            cancel_id = resting[index];
+            resting[index] = resting.back();
+            resting.pop_back();
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        if (cancel)
+        {
+            book.cancel_order(cancel_id);
+        }
+        else
+        {
+            book.match_orders(order);
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+
+        state.SetIterationTime(std::chrono::duration<double>(elapsed).count());
+        samples.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+        if (!cancel && !marketable)
+        {
+            resting.push_back(order.get_id());
+        }
+    }
+    allocations.report(state);
+    report_percentiles(state, samples);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_OrderMix)
+    ->ArgNames({"depth", "cancel_pct", "marketable_pct"})
+    ->Args({10, 30, 10})
+    ->Args({100, 30, 10})
+    ->Args({100, 45, 25})
+    ->Args({1000, 30, 10})
+    ->UseManualTime();
+
+// Push then pop of one command through the matching ring, single threaded
+static void BM_RingPushPop(benchmark::State &state)
+{
+    MpscRing<OrderCommand> ring(1024, state.range(0) != 0);
+    OrderCommand command{};
+    command.type = CommandType::NEW_ORDER;
+
+    AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        ring.push(command);
+        ring.consume_one([](OrderCommand &popped)
+                         { benchmark::DoNotOptimize(popped.order_id); });
+    }
+    allocations.report(state);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RingPushPop)->ArgName("single_producer")->Arg(0)->Arg(1);
+
+// Commands pushed by range(0) producer threads while one consumer drains
+static void BM_RingContended(benchmark::State &state)
+{
+    static MpscRing<OrderCommand> *ring = nullptr;
+    static std::atomic<bool> draining(false);
+    static std::thread consumer;
+
+    if (state.thread_index() == 0)
+    {
+        ring = new MpscRing<OrderCommand>(65536);
+        draining.store(true);
+        consumer = std::thread([]
+                               {
+            while (draining.load(std::memory_order_relaxed) || ring->has_next())
+            {
+                ring->consume_batch([](OrderCommand &) {}, 256);
+            } });
+    }
+
+    OrderCommand command{};
+    command.type = CommandType::NEW_ORDER;
+    for (auto _ : state)
+    {
+        ring->push(command);
+    }
+    state.SetItemsProcessed(state.iterations());
+
+    if (state.thread_index() == 0)
+    {
+        draining.store(false);
+        consumer.join();
+        delete ring;
+        ring = nullptr;
+    }
+}
+BENCHMARK(BM_RingContended)->ThreadRange(1, 4)->UseRealTime();
+
+// End to end through MatchingEngine: submit, queue, match, per command
+static void BM_EngineThroughput(benchmark::State &state)
+{
+    MatchingEngineConfig config;
+    config.wait_strategy = WaitStrategyType::BUSY_SPIN;
+    config.single_producer = true;
+    MatchingEngine engine(config);
+    std::vector<Order> orders = passive_orders(1 << 16, static_cast<int>(state.range(0)), 5);
+
+    AllocationCounter allocations;
+    size_t next = 0;
+    for (auto _ : state)
+    {
+        engine.process_order(orders[next]);
+        next = (next + 1) & (orders.size() - 1);
+    }
+    // Include the drain so the rate is what the matching thread sustains
+    while (engine.get_stats().commands_processed < static_cast<uint64_t>(state.iterations()))
+    {
+        std::this_thread::yield();
+    }
+    allocations.report(state);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_EngineThroughput)->Arg(10)->Arg(100)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "OrderBook.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// On-disk book snapshot, version 5. Three flat tables follow a 64-byte header:
+//
+//   books   one SnapshotBook per instrument
+//   levels  each book's bid levels then ask levels, best first
+//   orders  each level's resting orders in time priority
+//
+// Tables refer to each other by index, never by pointer, so a mapped file can
+// be read in place, copied to another machine, or mapped at any address.
+// Everything is 8-byte aligned plain data in host byte order.
+
+struct SnapshotFileHeader
+{
+    char magic[8];             // "OBSNAP05"
+    uint32_t version;
+    uint32_t header_size;
+    uint64_t journal_sequence; // last journaled command reflected in the books
+    uint64_t reserved;
+    uint64_t book_count;
+    uint64_t level_count;
+    uint64_t order_count;
+    uint64_t checksum;         // over the three tables
+};
+
+struct SnapshotBook
+{
+    SymbolId symbol_id;
+    uint32_t bid_levels;
+    uint32_t ask_levels;
+    uint32_t reserved;
+    uint64_t first_level; // index of the book's best bid in the level table
+    uint64_t first_order; // index of the book's first order in the order table
+    uint64_t max_price_levels; // the book's price band; recovery refuses another
+    double tick_size;          // the book's tick; recovery refuses another
+};
+
+struct SnapshotLevel
+{
+    int64_t tick;
+    int64_t total_quantity;
+    uint64_t first_order; // index in the order table
+    uint32_t order_count;
+    uint32_t reserved;
+};
+
+// Price and side come from the level
+struct SnapshotOrder
+{
+    uint64_t order_id;
+    int64_t timestamp_ns; // creation time, system clock
+    int32_t quantity; // still open
+    uint8_t strategy; // Strategy
+    uint8_t type;     // OrderType
+    uint16_t reserved;
+};
+
+static_assert(sizeof(SnapshotFileHeader) == 64, "Snapshot header is one cache line");
+static_assert(sizeof(SnapshotBook) == 48 && sizeof(SnapshotLevel) == 32 && sizeof(SnapshotOrder) == 24,
+              "Snapshot tables are packed");
+
+// Writes books to path through a temporary file that is synced and then
+// renamed into place, so a crash leaves either the old snapshot or the new
+// one. The books must not change while this runs. Returns false on I/O error.
+bool write_book_snapshot(const std::string &path, uint64_t journal_sequence,
+                         const std::vector<std::pair<SymbolId, const OrderBook *>> &books);
+
+// Read-only mapping of a snapshot file. Opening checks the header and that
+// the tables fit the file; nothing is parsed per order.
+class MappedBookSnapshot
+{
+public:
+    // Throws std::runtime_error if the file is missing, truncated or not a snapshot
+    explicit MappedBookSnapshot(const std::string &path);
+    ~MappedBookSnapshot();
+
+    MappedBookSnapshot(const MappedBookSnapshot &) = delete;
+    MappedBookSnapshot &operator=(const MappedBookSnapshot &) = delete;
+
+    uint64_t journal_sequence() const;
+
+    size_t book_count() const;
+    size_t level_count() const;
+    size_t order_count() const;
+    const SnapshotBook *books() const;
+    const SnapshotLevel *levels() const;
+    const SnapshotOrder *orders() const;
+
+    // Recomputes the table checksum; one sequential pass over the file
+    bool verify() const;
+
+    // Adds the orders of one book entry to book, preserving time priority and
+    // creation times. Returns false if the book refuses an order (its id is
+    // already resting, or it is outside the book's price band); the orders
+    // before it stay added.
+    bool restore(const SnapshotBook &entry, OrderBook &book) const;
+
+private:
+    int fd_;
+    const char *map_;
+    size_t map_bytes_;
+    const SnapshotFileHeader *header_;
+};
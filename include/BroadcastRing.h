@@ -0,0 +1,171 @@
+#pragma once
+
+#include "WaitStrategy.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+// Single-writer, multi-reader ring for fixed-size records. The writer never
+// waits: it overwrites the oldest record once the ring is full. Every reader
+// keeps its own cursor and reads without locks; a reader that falls a whole
+// ring behind is told it was lapped and skips ahead to the oldest record that
+// is still available.
+//
+// Each slot carries a version (its sequence + 1, or 0 while being written) so
+// a reader can tell whether the record it copied was overwritten underneath
+// it. Payloads are copied as relaxed atomic words, which keeps the scheme
+// free of data races. Readers with nothing to do can park in wait(); the
+// writer wakes them once per run of records rather than per record.
+template <typename T>
+class BroadcastRing
+{
+    static_assert(std::is_trivially_copyable<T>::value, "BroadcastRing records must be trivially copyable");
+    static_assert(sizeof(T) % sizeof(uint64_t) == 0, "BroadcastRing records must be a whole number of words");
+
+public:
+    enum class ReadStatus
+    {
+        OK,     // out holds the record at cursor; cursor advanced
+        EMPTY,  // nothing new has been published
+        LAPPED  // records were overwritten before being read; cursor moved to the oldest available
+    };
+
+    // capacity is rounded up to a power of two
+    explicit BroadcastRing(size_t capacity)
+        : capacity_(2),
+          next_(0),
+          published_(0)
+    {
+        while (capacity_ < capacity)
+        {
+            capacity_ <<= 1;
+        }
+        mask_ = capacity_ - 1;
+
+        slots_.reset(new Slot[capacity_]);
+        for (size_t i = 0; i < capacity_; ++i)
+        {
+            slots_[i].version.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    BroadcastRing(const BroadcastRing &) = delete;
+    BroadcastRing &operator=(const BroadcastRing &) = delete;
+
+    size_t capacity() const
+    {
+        return capacity_;
+    }
+
+    // Writer only. Returns the record's sequence number, starting at 1.
+    uint64_t publish(const T &item)
+    {
+        uint64_t pos = next_++;
+        Slot &slot = slots_[pos & mask_];
+
+        uint64_t words[kWords];
+        std::memcpy(words, &item, sizeof(T));
+
+        slot.version.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < kWords; ++i)
+        {
+            slot.words[i].store(words[i], std::memory_order_relaxed);
+        }
+        slot.version.store(pos + 1, std::memory_order_release);
+        published_.store(pos + 1, std::memory_order_release);
+        return pos + 1;
+    }
+
+    // Sequence of the newest record; a reader starting here sees only new records
+    uint64_t published() const
+    {
+        return published_.load(std::memory_order_acquire);
+    }
+
+    // Writer only, after a run of publishes: wakes readers parked in wait()
+    void notify_readers()
+    {
+        wakeup_.notify_all();
+    }
+
+    // Sleeps until a record after cursor is published, notify_readers() runs,
+    // or timeout passes; returns at once if one is already there
+    void wait(uint64_t cursor, std::chrono::microseconds timeout) const
+    {
+        wakeup_.wait([this, cursor]
+                     { return published_.load(std::memory_order_acquire) > cursor; },
+                     timeout);
+    }
+
+    // cursor is the sequence of the last record this reader consumed (0 to
+    // start from the oldest record still in the ring)
+    ReadStatus read(uint64_t &cursor, T &out) const
+    {
+        uint64_t published_now = published_.load(std::memory_order_acquire);
+        if (cursor >= published_now)
+        {
+            return ReadStatus::EMPTY;
+        }
+        if (published_now - cursor > capacity_)
+        {
+            return skip_to_oldest(cursor, published_now);
+        }
+
+        uint64_t pos = cursor;
+        const Slot &slot = slots_[pos & mask_];
+        uint64_t version = slot.version.load(std::memory_order_acquire);
+        if (version != pos + 1)
+        {
+            return skip_to_oldest(cursor, published_.load(std::memory_order_acquire));
+        }
+
+        uint64_t words[kWords];
+        for (size_t i = 0; i < kWords; ++i)
+        {
+            words[i] = slot.words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.version.load(std::memory_order_relaxed) != version)
+        {
+            return skip_to_oldest(cursor, published_.load(std::memory_order_acquire));
+        }
+
+        std::memcpy(&out, words, sizeof(T));
+        cursor = pos + 1;
+        return ReadStatus::OK;
+    }
+
+private:
+    static constexpr size_t kWords = sizeof(T) / sizeof(uint64_t);
+
+    struct Slot
+    {
+        std::atomic<uint64_t> version;
+        std::atomic<uint64_t> words[kWords];
+    };
+
+    ReadStatus skip_to_oldest(uint64_t &cursor, uint64_t published_now) const
+    {
+        // Leave one slot of slack: the writer may already be rewriting the oldest
+        uint64_t oldest = published_now > capacity_ ? published_now - capacity_ + 1 : 0;
+        if (oldest > cursor)
+        {
+            cursor = oldest;
+        }
+        return ReadStatus::LAPPED;
+    }
+
+    size_t capacity_;
+    size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+
+    uint64_t next_; // writer only
+    alignas(64) std::atomic<uint64_t> published_;
+    mutable ReaderWakeup wakeup_;
+};
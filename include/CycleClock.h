@@ -0,0 +1,58 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define ORDERBOOK_HAVE_RDTSC 1
+#endif
+
+// Cheap monotonic timestamps for latency stamps on hot paths. On x86 this is
+// the time stamp counter, converted to nanoseconds with a rate measured
+// against steady_clock the first time it is needed; elsewhere it falls back to
+// steady_clock nanoseconds. Ticks are only meaningful as differences taken on
+// the same machine.
+class CycleClock
+{
+public:
+    static uint64_t now()
+    {
+#ifdef ORDERBOOK_HAVE_RDTSC
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         std::chrono::steady_clock::now().time_since_epoch())
+                                         .count());
+#endif
+    }
+
+    static uint64_t to_nanoseconds(uint64_t ticks)
+    {
+        return static_cast<uint64_t>(static_cast<double>(ticks) * nanoseconds_per_tick());
+    }
+
+    // Measured once per process (about 10 ms); call at startup to keep the
+    // calibration off the first recorded order
+    static double nanoseconds_per_tick()
+    {
+        static const double rate = calibrate();
+        return rate;
+    }
+
+private:
+    static double calibrate()
+    {
+#ifdef ORDERBOOK_HAVE_RDTSC
+        auto start = std::chrono::steady_clock::now();
+        uint64_t start_ticks = now();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        uint64_t ticks = now() - start_ticks;
+        double nanoseconds = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        return ticks > 0 ? nanoseconds / static_cast<double>(ticks) : 1.0;
+#else
+        return 1.0;
+#endif
+    }
+};
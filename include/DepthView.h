@@ -0,0 +1,56 @@
+#pragma once
+
+#include "MarketData.h"
+#include "OrderBook.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// The best levels of one book, double buffered so any thread can read them
+// without locks while the matching thread keeps publishing. The writer fills
+// the buffer readers are not pointed at and then flips to it; a reader copies
+// the current buffer and checks its version afterwards, so a copy is only
+// retried if the writer published twice while it was being taken.
+//
+// Levels already carry their aggregate quantity and order count, kept up to
+// date by the ladder on every add, fill and cancel, so publishing is a copy of
+// at most `levels` entries per side starting at the cached best level.
+class DepthView
+{
+public:
+    // levels is the most published per side
+    explicit DepthView(size_t levels);
+
+    DepthView(const DepthView &) = delete;
+    DepthView &operator=(const DepthView &) = delete;
+
+    size_t levels() const;
+
+    // Writer only
+    void publish(uint64_t sequence, const OrderBook &book);
+
+    // Any thread. Copies at most max_levels per side (0 = all published).
+    // Returns false if nothing was published yet.
+    bool read(size_t max_levels, DepthSnapshot &out) const;
+
+private:
+    // Each level is three words: price bits, quantity, order count
+    static constexpr size_t kLevelWords = 3;
+    // Header words: sequence, bid count, ask count
+    static constexpr size_t kHeaderWords = 3;
+
+    struct alignas(64) Buffer
+    {
+        std::atomic<uint64_t> version; // publish count that filled it, 0 while being written
+        std::unique_ptr<std::atomic<uint64_t>[]> words;
+    };
+
+    size_t levels_;
+    Buffer buffers_[2];
+    uint64_t next_; // writer only
+    alignas(64) std::atomic<uint64_t> published_;
+
+    void write_side(Buffer &buffer, size_t first_word, OrderSide side, const OrderBook &book, uint64_t &count);
+};
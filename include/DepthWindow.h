@@ -0,0 +1,53 @@
+#pragma once
+
+#include "MarketData.h"
+
+#include <cstddef>
+#include <map>
+#include <vector>
+
+// A market data subscriber's copy of one book, rebuilt from a snapshot of
+// every level plus the level updates published after it, and cut to the best
+// `depth` levels per side. Updates below the window are absorbed. When a level
+// leaves the window, emptied or pushed out by a better one, it is reported
+// with quantity 0 and the level that moves in is reported too, so a client
+// that applies every change holds exactly the best `depth` levels.
+//
+// Owned by one subscriber thread; the matching thread never sees it.
+class DepthWindow
+{
+public:
+    // depth is the levels kept per side; 0 keeps and reports every level
+    explicit DepthWindow(size_t depth);
+
+    size_t depth() const;
+
+    // Starts over from a snapshot of the whole book
+    void reset(const BookSnapshot &snapshot);
+
+    void apply(const LevelUpdate &update);
+
+    // The window as it stands, best level first, for a snapshot message.
+    // Later changes() are relative to it.
+    void window(std::vector<LevelQuantity> &bids, std::vector<LevelQuantity> &asks);
+
+    // Window levels that changed since the last window() or changes() call:
+    // the new quantity, or 0 for a level that left the window. Returns false
+    // if nothing in the window changed.
+    bool changes(std::vector<LevelQuantity> &bids, std::vector<LevelQuantity> &asks);
+
+private:
+    struct Side
+    {
+        std::map<double, int64_t> levels; // every level of the side, by price
+        std::vector<LevelQuantity> sent;  // window as last reported, best first
+        std::vector<LevelQuantity> dirty; // with depth 0: levels updated since then
+    };
+
+    size_t depth_;
+    Side bids_;
+    Side asks_;
+
+    void top(const Side &side, bool descending, std::vector<LevelQuantity> &out) const;
+    void diff(Side &side, bool descending, std::vector<LevelQuantity> &out) const;
+};
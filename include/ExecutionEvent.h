@@ -0,0 +1,37 @@
+#pragma once
+
+#include "BroadcastRing.h"
+#include "Order.h"
+
+#include <cstdint>
+
+enum class ExecutionType : uint8_t
+{
+    FILL,   // taker traded with maker
+    CANCEL, // taker_order_id was cancelled with quantity still open
+    EXPIRE, // unfilled remainder of taker_order_id was dropped (it may not rest)
+    REJECT,        // taker_order_id was refused before trading, e.g. a post-only order that would cross
+                   // or one the journal could not record
+    REPLACE,       // taker_order_id was amended; price and quantity are its new values
+    REPLACE_REJECT, // an amend of taker_order_id was refused; the order, if it still rests, is unchanged
+    CANCEL_REJECT   // a cancel of taker_order_id removed nothing: it was no longer resting on symbol_id
+};
+
+// One fill between an incoming (taker) order and a resting (maker) order, or
+// an order leaving the book without trading. Plain data so it can be copied
+// through the execution stream word by word.
+struct ExecutionEvent
+{
+    uint64_t sequence;       // position in the stream, starting at 1
+    uint64_t taker_order_id;
+    uint64_t maker_order_id;
+    double price;            // maker's price
+    int64_t quantity;        // traded, left for CANCEL / EXPIRE / REJECT, or open after REPLACE
+    int64_t timestamp_ns;    // system clock, nanoseconds since epoch
+    SymbolId symbol_id;
+    OrderSide taker_side;
+    ExecutionType type;
+};
+
+// Execution reports from one matching thread, readable by any number of consumers
+using ExecutionStream = BroadcastRing<ExecutionEvent>;
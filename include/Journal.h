@@ -0,0 +1,160 @@
+#pragma once
+
+#include "Order.h"
+#include "PriceLadder.h"
+#include "TickSizes.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+enum class JournalRecordType : uint8_t
+{
+    SUBMIT = 1,
+    CANCEL = 2,
+    AMEND = 3
+};
+
+// One inbound command as it was handed to the matching thread. Fixed size and
+// plain data, so the journal is an array of these behind a one-record header
+// and record n lives at a computable offset. A record is valid when its
+// sequence follows the previous one and its checksum matches; the first record
+// that is not marks the end of the log.
+struct JournalRecord
+{
+    uint64_t sequence;     // starts at 1, no gaps
+    uint64_t order_id;
+    double price;          // new price for AMEND
+    int64_t timestamp_ns;  // system clock when journaled
+    int32_t quantity;      // new quantity for AMEND
+    SymbolId symbol_id;
+    JournalRecordType type;
+    uint8_t side;          // OrderSide
+    uint8_t order_type;    // OrderType
+    uint8_t strategy;      // Strategy
+    uint8_t reserved[16];
+    uint32_t checksum;     // over every byte before it
+};
+
+static_assert(sizeof(JournalRecord) == 64, "Journal records are one cache line");
+
+uint32_t journal_checksum(const JournalRecord &record);
+
+struct JournalConfig
+{
+    // Log file; empty disables journaling
+    std::string path;
+    // Records the file is pre-allocated for; it doubles when full
+    size_t initial_records = 1 << 20;
+    // Slots in the ring between producers and the journal thread, rounded up to a power of two
+    size_t queue_capacity = 65536;
+    // Most commands written per group commit
+    size_t group_size = 4096;
+    // Flush to disk before commands reach the matching thread; when false the
+    // kernel writes the log back on its own schedule
+    bool fsync = true;
+    // 0 syncs every group commit. Otherwise groups are synced at most this
+    // often (and whenever the journal goes idle), so a crash can lose the
+    // commands accepted within one interval.
+    uint32_t fsync_interval_us = 0;
+    // Rebuild the books from snapshot_path (if it exists) and the journal
+    // records after it before accepting commands
+    bool recover = false;
+    // Book snapshot file; written every snapshot_interval journaled commands (0 = never)
+    std::string snapshot_path;
+    uint64_t snapshot_interval = 0;
+    // Shard layout the log belongs to, recorded in its header; set by
+    // ShardedMatchingEngine. A log written under another shard count is
+    // refused, since its symbols now route to other shards.
+    uint32_t shard_count = 1;
+    uint32_t shard_index = 0;
+};
+
+// Throws std::runtime_error if the log at path was written as another shard
+// of another layout, or for books with another price band or other tick sizes
+// (tick_size_digest is TickSizes::digest()). A missing log, or one from before
+// these were recorded, passes.
+void check_journal_layout(const std::string &path, uint32_t shard_count, uint32_t shard_index,
+                          uint64_t max_price_levels = PriceLadder::kDefaultMaxLevels,
+                          uint64_t tick_size_digest = TickSizes().digest());
+
+// Appends records to a memory-mapped, pre-allocated log file. Opening an
+// existing log continues after its last valid record. Not thread-safe: one
+// thread owns the writer.
+class JournalWriter
+{
+public:
+    // Throws std::runtime_error if the file cannot be opened or mapped, or
+    // was written under another shard layout, price band or tick sizes (see
+    // check_journal_layout)
+    JournalWriter(const std::string &path, size_t initial_records, uint32_t shard_count = 1,
+                  uint32_t shard_index = 0, uint64_t max_price_levels = PriceLadder::kDefaultMaxLevels,
+                  uint64_t tick_size_digest = TickSizes().digest());
+    ~JournalWriter();
+
+    JournalWriter(const JournalWriter &) = delete;
+    JournalWriter &operator=(const JournalWriter &) = delete;
+
+    // Fills in the sequence and checksum and copies the record into the map.
+    // Returns the record's sequence. Throws std::runtime_error if the file
+    // cannot grow.
+    uint64_t append(JournalRecord &record);
+
+    // Flushes everything appended since the last sync. Returns false on I/O error.
+    bool sync();
+
+    // Invalidates the records after sequence, so readers stop at it and the
+    // next append reuses its successor. Works without a mapping, after a
+    // failed grow. Returns false on I/O error.
+    bool discard_after(uint64_t sequence);
+
+    uint64_t last_sequence() const;
+    uint64_t synced_sequence() const;
+    size_t capacity() const;
+
+private:
+    std::string path_;
+    int fd_;
+    char *map_;
+    size_t capacity_; // records the file currently holds room for
+    uint64_t next_sequence_;
+    uint64_t synced_sequence_;
+
+    void map(size_t records);
+    void unmap();
+    JournalRecord *slot(uint64_t sequence) const;
+};
+
+// Reads records back from a log in sequence order, stopping at the first
+// record that is missing, torn or out of sequence.
+class JournalReader
+{
+public:
+    // Throws std::runtime_error if the file is missing or not a journal
+    explicit JournalReader(const std::string &path);
+    ~JournalReader();
+
+    JournalReader(const JournalReader &) = delete;
+    JournalReader &operator=(const JournalReader &) = delete;
+
+    bool next(JournalRecord &record);
+
+    // Positions the reader so next() returns the record after sequence
+    void skip_to(uint64_t sequence);
+
+    uint64_t last_sequence() const; // of the record most recently returned
+
+    // Layout recorded by the writer; shard_count is 0 for an older log
+    uint32_t shard_count() const;
+    uint32_t shard_index() const;
+    // Price band and TickSizes::digest() recorded by the writer; 0 for an older log
+    uint64_t max_price_levels() const;
+    uint64_t tick_size_digest() const;
+
+private:
+    int fd_;
+    const char *map_;
+    size_t map_bytes_;
+    size_t capacity_;
+    uint64_t last_sequence_;
+};
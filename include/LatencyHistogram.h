@@ -0,0 +1,91 @@
+#pragma once
+
+#include "PerThreadSlots.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Log-linear histogram of nanosecond values in the style of HdrHistogram:
+// every power of two is split into 64 linear sub-buckets, so a recorded value
+// is off by less than 1/64 (1.6%) at any magnitude up to about 18 minutes.
+// One thread records; any thread may read or merge it concurrently, seeing
+// each count as of some recent moment.
+class LatencyHistogram
+{
+public:
+    LatencyHistogram();
+
+    LatencyHistogram(const LatencyHistogram &) = delete;
+    LatencyHistogram &operator=(const LatencyHistogram &) = delete;
+
+    // Single writer: plain loads and stores, no locked read-modify-writes
+    void record(uint64_t nanoseconds);
+
+    // Adds other's counts into this histogram; this must not be recorded into concurrently
+    void merge(const LatencyHistogram &other);
+
+    uint64_t count() const;
+    uint64_t max() const;
+
+    // Smallest recorded value that fraction (0..1] of the values do not
+    // exceed, as the upper edge of its bucket; 0 when empty
+    uint64_t percentile(double fraction) const;
+
+private:
+    static constexpr unsigned kSubBucketBits = 7;
+    static constexpr uint64_t kSubBucketCount = 1ull << kSubBucketBits;
+    static constexpr uint64_t kSubBucketHalf = kSubBucketCount / 2;
+    static constexpr unsigned kMaxValueBits = 40;
+    static constexpr size_t kBucketCount = (kMaxValueBits - kSubBucketBits + 2) * kSubBucketHalf;
+
+    static size_t index_for(uint64_t value);
+    static uint64_t highest_value_at(size_t index);
+
+    std::unique_ptr<std::atomic<uint64_t>[]> counts_;
+    std::atomic<uint64_t> total_;
+    std::atomic<uint64_t> max_;
+};
+
+// Points an order passes after it is received, i.e. decoded from the
+// request and stamped, which is where every stage is measured from
+enum class LatencyStage : uint8_t
+{
+    ENQUEUED, // placed on the engine's queue (the journal queue when journaling)
+    DEQUEUED, // taken off the queue by the matching thread
+    MATCHED,  // matching done: filled, rested or cancelled
+    ACKED     // response handed back to the transport
+};
+
+constexpr size_t kLatencyStageCount = 4;
+
+const char *latency_stage_name(LatencyStage stage);
+
+// Per-stage latency, each measured from the order's receive stamp. Every
+// recording thread gets its own set of histograms on first use, so recording
+// never contends; readers merge all threads' histograms on demand. A thread
+// that exits leaves its histograms to the next thread to record.
+class LatencyRecorder
+{
+public:
+    LatencyRecorder();
+    ~LatencyRecorder();
+
+    LatencyRecorder(const LatencyRecorder &) = delete;
+    LatencyRecorder &operator=(const LatencyRecorder &) = delete;
+
+    // received and now are CycleClock ticks
+    void record(LatencyStage stage, uint64_t received, uint64_t now);
+
+    // Sum of every thread's histogram for stage
+    void merge_stage(LatencyStage stage, LatencyHistogram &into) const;
+
+private:
+    struct ThreadHistograms
+    {
+        LatencyHistogram stages[kLatencyStageCount];
+    };
+
+    PerThreadSlots<ThreadHistograms> threads_;
+};
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "BroadcastRing.h"
+#include "Order.h"
+
+#include <cstdint>
+#include <vector>
+
+// New aggregate quantity of one price level after a matching batch. Levels
+// are coalesced per batch, so a level that changed many times in one batch is
+// reported once with its final quantity; 0 means the level is gone.
+struct LevelUpdate
+{
+    enum Flags : uint8_t
+    {
+        LAST_IN_BATCH = 1 // last update for this symbol in its batch
+    };
+
+    uint64_t sequence; // position in the stream, starting at 1
+    uint64_t batch;    // matching batch that produced the update
+    SymbolId symbol_id;
+    OrderSide side;
+    uint8_t flags;
+    double price;
+    int64_t quantity;
+};
+
+// L2 updates from one matching thread, readable by any number of subscribers
+using MarketDataStream = BroadcastRing<LevelUpdate>;
+
+struct LevelQuantity
+{
+    double price;
+    int64_t quantity;
+};
+
+// L2 view of one book, best level first. Applying every LevelUpdate for the
+// symbol published after market_data_sequence brings it up to date.
+struct BookSnapshot
+{
+    SymbolId symbol_id = 0;
+    uint64_t market_data_sequence = 0;
+    std::vector<LevelQuantity> bids;
+    std::vector<LevelQuantity> asks;
+};
+
+// One price level of an aggregated depth view
+struct DepthLevel
+{
+    double price;
+    int64_t quantity;
+    uint32_t order_count;
+    uint32_t reserved;
+};
+
+// Best levels of one book as of the end of a matching batch, best first
+struct DepthSnapshot
+{
+    SymbolId symbol_id = 0;
+    uint64_t sequence = 0; // matching batch that published it
+    std::vector<DepthLevel> bids;
+    std::vector<DepthLevel> asks;
+};
+
+// Best bid and ask of one book as of the end of a matching batch. A side with
+// no orders has has_bid / has_ask false and zero price and quantity.
+struct TopOfBook
+{
+    uint64_t sequence; // matching batch that published it
+    double bid_price;
+    int64_t bid_quantity;
+    double ask_price;
+    int64_t ask_quantity;
+    SymbolId symbol_id;
+    bool has_bid;
+    bool has_ask;
+};
@@ -1,25 +1,263 @@
+#include "DepthView.h"
+#include "Journal.h"
+#include "LatencyHistogram.h"
+#include "MpscRing.h"
 #include "OrderBook.h"
+#include "OrderCommand.h"
+#include "Recovery.h"
+#include "Snapshotter.h"
+#include "TickSizes.h"
+#include "TopOfBook.h"
+#include "WaitStrategy.h"
 
-#include <boost/lockfree/queue.hpp>
 #include <thread>
 #include <atomic>
+#include <chrono>
+#include <functional>
 #include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct MatchingEngineConfig
+{
+    // Slots in the command ring, rounded up to a power of two
+    size_t queue_capacity = 65536;
+    // Set when exactly one thread submits, to skip the atomic sequence claim
+    bool single_producer = false;
+    // What the matching thread does while the queue is empty
+    WaitStrategyType wait_strategy = WaitStrategyType::BLOCKING;
+    // Empty polls spent spinning before yielding or parking
+    uint32_t spin_iterations = 1000;
+    // Most commands drained per wake-up before per-batch work runs
+    size_t batch_size = 256;
+    // Runs on the matching thread after every batch, once for each book the
+    // batch touched, e.g. to publish market data
+    std::function<void(SymbolId, const OrderBook &)> on_batch;
+    // Tick size of each symbol's book, created on first use of the symbol:
+    // tick_sizes.per_symbol where it has an entry, else default_tick_size
+    TickSizes tick_sizes;
+    // Widest price band, in ticks, each side of a book may span; orders that
+    // would rest outside it are rejected rather than grow the book without bound
+    size_t max_price_levels = PriceLadder::kDefaultMaxLevels;
+    // CPU to pin the matching thread to; -1 leaves it to the scheduler
+    int cpu = -1;
+    // Fill events kept for readers of the execution stream, rounded up to a power of two
+    size_t execution_capacity = 65536;
+    // L2 level updates kept for market data subscribers, rounded up to a power of two
+    size_t market_data_capacity = 65536;
+    // Symbols whose best bid/ask can be read from any thread, rounded up to a
+    // power of two; books beyond it still match but publish no top of book
+    size_t top_of_book_capacity = 4096;
+    // Levels per side in each book's lock-free depth view; 0 turns it off
+    size_t depth_levels = 10;
+    // Write-ahead journal of inbound commands; off unless journal.path is set
+    JournalConfig journal;
+    // Per-stage latency of orders and cancels from their receive stamp; not
+    // owned, may be shared by several engines, nullptr turns it off
+    LatencyRecorder *latency = nullptr;
+    // Notified after every batch along with the execution stream, so one
+    // reader can park on several engines at once; not owned, may be nullptr
+    ReaderWakeup *execution_wakeup = nullptr;
+};
+
+// Snapshot of the matching thread's counters
+struct EngineStats
+{
+    uint64_t commands_processed = 0;
+    uint64_t batches = 0;
+    uint64_t last_batch_size = 0;
+    uint64_t max_batch_size = 0;
+    uint64_t batch_size_limit = 0;
+    uint64_t journaled_commands = 0; // sequence of the newest journal record
+    uint64_t journal_syncs = 0;
+    uint64_t snapshots_written = 0;
+    // Set once the journal could not write or sync; from then on commands are refused
+    bool journal_failed = false;
+    uint64_t journal_refused = 0; // commands dropped unmatched because they could not be journaled
+    // Commands waiting for the matching thread, and for the journal thread
+    // when journaling; depths are approximate
+    uint64_t queue_depth = 0;
+    uint64_t queue_capacity = 0;
+    uint64_t journal_queue_depth = 0;
+    uint64_t journal_queue_capacity = 0;
+};
 
 class MatchingEngine
 {
 public:
-    MatchingEngine();
+    explicit MatchingEngine(const MatchingEngineConfig &config = MatchingEngineConfig());
     ~MatchingEngine();
 
-    void process_order(Order &order);
+    // received_at is the CycleClock stamp taken when the request arrived; 0
+    // stamps it here. Only read when a latency recorder is configured.
+    // All submitters return false, queueing nothing, once the journal has
+    // failed: a command that cannot be made durable is never matched. Ones
+    // already queued when it fails are reported refused on the execution
+    // stream instead: REJECT for an order, CANCEL_REJECT for a cancel and
+    // REPLACE_REJECT for an amend.
+    bool process_order(Order &order, uint64_t received_at = 0);
+    // The outcome is published on the execution stream as CANCEL, or
+    // CANCEL_REJECT when the order is not resting on symbol_id.
+    bool cancel_order(uint64_t order_id, SymbolId symbol_id = 0, uint64_t received_at = 0);
+    // See OrderBook::amend_order. The outcome is published on the execution
+    // stream as REPLACE, or REPLACE_REJECT when the order is no longer resting
+    // or the amend is refused.
+    bool amend_order(uint64_t order_id, SymbolId symbol_id, double price, int quantity, uint64_t received_at = 0);
+
+    // Submits the order and waits until the matching thread has dealt with
+    // it, spinning briefly and then sleeping on a futex. Returns false on
+    // timeout; the order may still be matched afterwards.
+    bool process_order_sync(Order &order, OrderOutcome &outcome,
+                            std::chrono::microseconds timeout = std::chrono::seconds(5), uint64_t received_at = 0);
+
+    // Cancels and waits like process_order_sync. The outcome is CANCELLED if
+    // the order was removed, or REJECTED if it is not resting on symbol_id.
+    bool cancel_order_sync(uint64_t order_id, SymbolId symbol_id, OrderOutcome &outcome,
+                           std::chrono::microseconds timeout = std::chrono::seconds(5), uint64_t received_at = 0);
+
+    // Amends and waits like process_order_sync. The outcome is REJECTED if the
+    // amend was refused, else PENDING with the quantity still resting, or
+    // FILLED if a crossing amend traded the whole order.
+    bool amend_order_sync(uint64_t order_id, SymbolId symbol_id, double price, int quantity, OrderOutcome &outcome,
+                          std::chrono::microseconds timeout = std::chrono::seconds(5), uint64_t received_at = 0);
+
+    // Submit like the _sync calls but return at once. The outcome is
+    // published to completion under ticket (armed by the caller): by the
+    // matching thread, or before these return when the command is refused.
+    // For callers told through a CompletionListener instead of waiting.
+    void process_order_async(Order &order, OrderCompletion &completion, uint32_t ticket, uint64_t received_at = 0);
+    void cancel_order_async(uint64_t order_id, SymbolId symbol_id, OrderCompletion &completion, uint32_t ticket,
+                            uint64_t received_at = 0);
+    void amend_order_async(uint64_t order_id, SymbolId symbol_id, double price, int quantity,
+                           OrderCompletion &completion, uint32_t ticket, uint64_t received_at = 0);
+
+    // Looks an order up on the matching thread, in sequence with everything
+    // queued before it. The outcome is PENDING with the resting quantity, or
+    // CANCELLED if the order is not in the book (filled, cancelled or never
+    // rested); execution_sequence is the execution stream position it
+    // reflects. Returns false on timeout.
+    bool query_order(uint64_t order_id, SymbolId symbol_id, OrderOutcome &outcome,
+                     std::chrono::microseconds timeout = std::chrono::seconds(5));
+
+    EngineStats get_stats() const;
+
+    // What was restored at construction when journal.recover is set
+    const RecoveryStats &get_recovery_stats() const;
+
+    // Fills from every book on this engine; readers keep their own cursor
+    const ExecutionStream &get_execution_stream() const;
+
+    // Per-level L2 updates, coalesced per batch, for every book on this engine
+    const MarketDataStream &get_market_data_stream() const;
+
+    // Asks the matching thread for an L2 snapshot of one book (max_levels per
+    // side, 0 = all) and waits for it. Returns false on timeout, or when 64
+    // requests are already waiting on this engine.
+    bool get_snapshot(SymbolId symbol_id, size_t max_levels, BookSnapshot &snapshot,
+                      std::chrono::milliseconds timeout = std::chrono::seconds(5));
+
+    // Best bid/ask of one book as of the last batch that touched it. Lock-free
+    // and safe from any thread; returns false if the symbol has no book yet.
+    bool get_top_of_book(SymbolId symbol_id, TopOfBook &top) const;
+
+    // Up to max_levels per side (0 = all of depth_levels) of one book as of
+    // the last batch that touched it. Lock-free like get_top_of_book.
+    bool get_depth(SymbolId symbol_id, size_t max_levels, DepthSnapshot &depth) const;
 
 private:
-    // Lock-free queue for order pointers (capacity must be power of 2)
-    boost::lockfree::queue<Order *> order_queue_;
+    struct SymbolBook
+    {
+        SymbolBook(SymbolId symbol_id, double tick_size, size_t max_price_levels)
+            : symbol_id(symbol_id), book(tick_size, max_price_levels), touched(false), top_slot(TopOfBookTable::kNoSlot) {}
+
+        SymbolId symbol_id;
+        OrderBook book;
+        bool touched;    // changed in the current batch
+        size_t top_slot; // cell in top_of_book_, or kNoSlot
+        std::unique_ptr<DepthView> depth;
+    };
+
+    // Commands are stored by value in the ring; only the matching thread consumes
+    MpscRing<OrderCommand> order_queue_;
+
+    // With journaling on, producers feed journal_queue_ instead and the journal
+    // thread forwards each group to order_queue_ once it is written (and synced)
+    std::unique_ptr<JournalWriter> journal_;
+    std::unique_ptr<MpscRing<OrderCommand>> journal_queue_;
+    WaitStrategy journal_wait_strategy_;
+    size_t journal_group_size_;
+    bool journal_fsync_;
+    std::chrono::microseconds journal_fsync_interval_;
+    std::vector<OrderCommand> journal_group_; // owned by the journal thread
+    std::atomic<bool> stop_journal_;
+    alignas(64) std::atomic<uint64_t> journaled_commands_;
+    std::atomic<uint64_t> journal_syncs_;
+    std::thread journal_thread_;
+
+    // Newest journal record that is durable: synced, or just written when
+    // syncing is off. Snapshots never run ahead of it.
+    std::atomic<uint64_t> journal_durable_;
+    ReaderWakeup journal_durable_advanced_; // notified after each store to journal_durable_
+    // Once set the journal thread drops every group and producers are refused
+    std::atomic<bool> journal_failed_;
+    std::atomic<uint64_t> journal_refused_;
+    std::unique_ptr<Snapshotter> snapshotter_; // reads the journal, never the live books
+    RecoveryStats recovery_stats_;
+
+    ExecutionStream execution_stream_;   // written only by the matching thread
+    MarketDataStream market_data_stream_; // written only by the matching thread
+    TopOfBookTable top_of_book_;          // written only by the matching thread
+    size_t depth_levels_;
+    // Snapshot requests in flight; commands point into it, so it lives as long as the engine
+    static constexpr size_t kSnapshotSlots = 64;
+    std::unique_ptr<SnapshotSlot[]> snapshot_slots_;
+    // Each book's depth view by top_of_book_ slot; set once when the book is created
+    std::unique_ptr<std::atomic<const DepthView *>[]> depth_views_;
     std::atomic<bool> stop_matching_engine_;
+    WaitStrategy wait_strategy_;
+    size_t batch_size_;
+    std::function<void(SymbolId, const OrderBook &)> on_batch_;
+    TickSizes tick_sizes_;
+    size_t max_price_levels_;
+    int cpu_;
+    LatencyRecorder *latency_;
+    ReaderWakeup *execution_wakeup_;
+
+    // Written only by the matching thread, once per batch
+    alignas(64) std::atomic<uint64_t> commands_processed_;
+    std::atomic<uint64_t> batches_;
+    std::atomic<uint64_t> last_batch_size_;
+    std::atomic<uint64_t> max_batch_size_;
+
     std::thread matching_engine_thread_;
 
-    OrderBook order_book_;
+    // Owned and touched only by the matching thread
+    std::unordered_map<SymbolId, std::unique_ptr<SymbolBook>> books_;
+    SymbolBook *last_book_;
+    std::vector<SymbolBook *> touched_books_;
+    bool replaying_; // books created during recovery publish nothing
 
+    bool submit_command(OrderCommand &&command);
+    void enqueue_for_matching(OrderCommand &&command);
+    bool journal_command(const OrderCommand &command);
+    bool sync_journal();
+    void fail_journal(const std::string &reason);
+    // Hands a group that could not be made durable to the matching thread
+    // unmatched, which reports each write command as refused
+    void refuse_group();
+    void report_refused(const OrderCommand &command);
+    void journal_loop();
+    void recover(const JournalConfig &config);
+    void execute_command(OrderCommand &command);
+    void complete_order(const OrderCommand &command, const OrderBook &book, const MatchResult &result);
+    void publish_rejected(const OrderCommand &command, ExecutionType type);
+    SymbolBook *find_book(SymbolId symbol_id);
+    SymbolBook *book_for(SymbolId symbol_id);
+    void mark_touched(SymbolBook *symbol_book);
+    void take_snapshot(SnapshotSlot &slot, SymbolId symbol_id);
+    void publish_book_views(SymbolBook *symbol_book, uint64_t batch);
+    void finish_batch();
+    void record_batch(size_t batch_size);
     void match_loop();
 };
\ No newline at end of file
@@ -0,0 +1,220 @@
+#pragma once
+
+#include "WaitStrategy.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+// Bounded multi-producer / single-consumer ring that stores items by value.
+//
+// Producers claim a sequence number (fetch_add on the shared tail, or a plain
+// store when the ring is built for a single producer), construct the item in
+// the slot and publish it by bumping the slot's sequence. The one consumer
+// owns the head outright and never does an atomic read-modify-write; it only
+// checks the next slot's sequence, and stores the head relaxed so other
+// threads can estimate the depth. Each slot's sequence tells both sides which
+// lap of the ring it is on:
+//   sequence == pos            slot is free for the producer claiming pos
+//   sequence == pos + 1        slot holds the item published at pos
+template <typename T>
+class MpscRing
+{
+public:
+    // capacity is rounded up to a power of two
+    explicit MpscRing(size_t capacity, bool single_producer = false)
+        : capacity_(2),
+          single_producer_(single_producer),
+          tail_(0),
+          head_(0)
+    {
+        while (capacity_ < capacity)
+        {
+            capacity_ <<= 1;
+        }
+        mask_ = capacity_ - 1;
+
+        slots_.reset(new Slot[capacity_]);
+        for (size_t i = 0; i < capacity_; ++i)
+        {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~MpscRing()
+    {
+        // Destroy whatever was published but never consumed
+        while (consume_one([](T &) {}))
+        {
+        }
+    }
+
+    MpscRing(const MpscRing &) = delete;
+    MpscRing &operator=(const MpscRing &) = delete;
+
+    size_t capacity() const
+    {
+        return capacity_;
+    }
+
+    // Any thread. Items claimed and not yet consumed, as of some recent
+    // moment; producers waiting on a full ring count as a full ring.
+    size_t size_approx() const
+    {
+        const uint64_t head = head_.load(std::memory_order_relaxed);
+        const uint64_t tail = tail_.load(std::memory_order_relaxed);
+        return tail > head ? static_cast<size_t>(std::min<uint64_t>(tail - head, capacity_)) : 0;
+    }
+
+    // Claims the next sequence and waits for its slot if the ring is full.
+    // A claim cannot be abandoned, so this is the path for producers that
+    // must not drop work; a full ring means the consumer is behind.
+    template <typename... Args>
+    void push(Args &&...args)
+    {
+        uint64_t pos;
+        if (single_producer_)
+        {
+            pos = tail_.load(std::memory_order_relaxed);
+            tail_.store(pos + 1, std::memory_order_relaxed);
+        }
+        else
+        {
+            pos = tail_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        Slot &slot = slots_[pos & mask_];
+        uint32_t spins = 0;
+        while (slot.sequence.load(std::memory_order_acquire) != pos)
+        {
+            if (++spins < kSpinsBeforeYield)
+            {
+                cpu_relax();
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        publish(slot, pos, std::forward<Args>(args)...);
+    }
+
+    // Claims a slot only if one is free right now
+    template <typename... Args>
+    bool try_push(Args &&...args)
+    {
+        uint64_t pos = tail_.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            Slot &slot = slots_[pos & mask_];
+            int64_t diff = static_cast<int64_t>(slot.sequence.load(std::memory_order_acquire) - pos);
+            if (diff < 0)
+            {
+                return false; // still holds an item from the previous lap
+            }
+            if (diff > 0)
+            {
+                pos = tail_.load(std::memory_order_relaxed); // lost a race, reload
+                continue;
+            }
+            if (single_producer_)
+            {
+                tail_.store(pos + 1, std::memory_order_relaxed);
+                break;
+            }
+            if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+
+        publish(slots_[pos & mask_], pos, std::forward<Args>(args)...);
+        return true;
+    }
+
+    // Consumer only. True if the next item has been published.
+    bool has_next() const
+    {
+        const uint64_t head = head_.load(std::memory_order_relaxed);
+        const Slot &slot = slots_[head & mask_];
+        return slot.sequence.load(std::memory_order_acquire) == head + 1;
+    }
+
+    // Consumer only. Hands the next item to fn in place, then frees its slot.
+    template <typename Fn>
+    bool consume_one(Fn &&fn)
+    {
+        const uint64_t head = head_.load(std::memory_order_relaxed);
+        Slot &slot = slots_[head & mask_];
+        if (slot.sequence.load(std::memory_order_acquire) != head + 1)
+        {
+            return false;
+        }
+
+        T *item = slot.item();
+        fn(*item);
+        item->~T();
+
+        slot.sequence.store(head + capacity_, std::memory_order_release);
+        head_.store(head + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Consumer only. Hands up to max_items published items to fn in order and
+    // returns how many were consumed.
+    template <typename Fn>
+    size_t consume_batch(Fn &&fn, size_t max_items)
+    {
+        size_t count = 0;
+        while (count < max_items && consume_one(fn))
+        {
+            ++count;
+        }
+        return count;
+    }
+
+    // Consumer only
+    bool try_pop(T &out)
+    {
+        return consume_one([&out](T &item)
+                           { out = std::move(item); });
+    }
+
+private:
+    static constexpr uint32_t kSpinsBeforeYield = 1000;
+
+    struct Slot
+    {
+        std::atomic<uint64_t> sequence;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+
+        T *item()
+        {
+            return std::launder(reinterpret_cast<T *>(&storage));
+        }
+    };
+
+    template <typename... Args>
+    void publish(Slot &slot, uint64_t pos, Args &&...args)
+    {
+        new (&slot.storage) T(std::forward<Args>(args)...);
+        slot.sequence.store(pos + 1, std::memory_order_release);
+    }
+
+    size_t capacity_;
+    size_t mask_;
+    bool single_producer_;
+    std::unique_ptr<Slot[]> slots_;
+
+    // Producers and the consumer write these; keep them on separate lines
+    alignas(64) std::atomic<uint64_t> tail_;
+    alignas(64) std::atomic<uint64_t> head_; // written by the consumer only
+};
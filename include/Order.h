@@ -2,21 +2,29 @@
 
 #include <string>
 #include <chrono>
+#include <cstdint>
 #include "Strategy.h"
 
-enum class OrderType
+// Instrument identifier; every order belongs to exactly one book
+using SymbolId = uint32_t;
+
+// Values are journaled, so new types go at the end
+enum class OrderType : uint8_t
 {
     MARKET,
-    LIMIT
+    LIMIT,
+    IOC,       // limit price; any unfilled remainder expires instead of resting
+    FOK,       // limit price; fills completely at once or expires untouched
+    POST_ONLY  // limit price; rejected instead of trading if it would cross
 };
 
-enum class OrderSide
+enum class OrderSide : uint8_t
 {
     BUY,
     SELL
 };
 
-enum class OrderStatus
+enum class OrderStatus : uint8_t
 {
     PENDING,
     FILLED,
@@ -27,8 +35,12 @@ enum class OrderStatus
 class Order
 {
 public:
-    Order(Strategy strategy, int quantity, double price, OrderSide side, OrderType type);
-    Order();
+    // Takes a fresh id from OrderIdAllocator
+    Order(Strategy strategy, int quantity, double price, OrderSide side, OrderType type, SymbolId symbol_id = 0);
+    // Rebuilds an order that already has an id, e.g. from the journal; reads no clocks
+    Order(uint64_t id, Strategy strategy, int quantity, double price, OrderSide side, OrderType type,
+          SymbolId symbol_id, std::chrono::system_clock::time_point created_at);
+    Order(); // placeholder with id 0
     Order(const Order &other); // Copy constructor
     ~Order();
 
@@ -39,19 +51,25 @@ public:
     OrderSide get_side() const;
     OrderType get_type() const;
     OrderStatus get_status() const;
+    SymbolId get_symbol_id() const;
 
     void set_quantity(int quantity);
     void set_price(double price);
     void set_type(OrderType type);
     void set_status(OrderStatus status);
+    void set_symbol_id(SymbolId symbol_id);
+
+    std::chrono::system_clock::time_point get_created_at() const;
 
 private:
+    // Widest first so the one-byte enums pack into the tail: 40 bytes
     uint64_t id;
-    Strategy strategy;
-    int quantity;
     double price;
+    std::chrono::system_clock::time_point created_at;
+    int quantity;
+    SymbolId symbol_id;
+    Strategy strategy;
     OrderSide side;
     OrderType type;
     OrderStatus status;
-    std::chrono::system_clock::time_point created_at;
 };
\ No newline at end of file
@@ -1,36 +1,170 @@
 #pragma once
 
+#include "ExecutionEvent.h"
+#include "MarketData.h"
 #include "Order.h"
+#include "OrderIndex.h"
+#include "OrderPool.h"
+#include "PriceLadder.h"
 
-#include <map>
-#include <deque>
+#include <algorithm>
+#include <vector>
 
-using OrderQueue = std::deque<Order>;
+using OrderQueue = std::vector<Order>;
+
+// What match_orders did with one incoming order
+struct MatchResult
+{
+    int64_t filled_quantity = 0;
+    Tick filled_notional_ticks = 0; // sum of maker tick * traded quantity
+    int64_t resting_quantity = 0;   // left on the book
+    int64_t expired_quantity = 0;   // unfilled remainder that may not rest
+    bool rejected = false;          // not accepted, e.g. its id is already resting
+};
 
 class OrderBook
 {
 public:
-    OrderBook();
+    // Prices are snapped to integer ticks of tick_size (per instrument). Each
+    // side spans at most max_levels_per_side ticks; orders that would rest
+    // outside that band are rejected.
+    explicit OrderBook(double tick_size = 0.01, size_t max_levels_per_side = PriceLadder::kDefaultMaxLevels);
     ~OrderBook();
 
-    void add_order(Order &order);
+    OrderBook(const OrderBook &) = delete;
+    OrderBook &operator=(const OrderBook &) = delete;
+
+    // Returns false if an order with the same id is already resting, or its
+    // price is not a valid limit price for this book (see limit_tick)
+    bool add_order(Order &order);
     void remove_order(Order &order);
     void update_order(Order &order);
     void cancel_order(Order &order);
 
+    // O(1) lookup and cancel through the order id index
+    bool cancel_order(uint64_t order_id);
+
+    // Changes a resting order's price and quantity. A smaller quantity at the
+    // same price is applied in place and keeps time priority; anything else
+    // relinks the node at the back of its new level, as a new order would
+    // queue. A price through the opposite touch trades first and rests any
+    // remainder. Returns false if the order is not resting, quantity is not
+    // positive, the price is not a valid limit price for this book, or a
+    // post-only order would cross. A successful amend publishes REPLACE ahead
+    // of any fills it causes; a refusal publishes nothing and changes nothing.
+    bool amend_order(uint64_t order_id, double price, int quantity);
+    const RestingOrder *find_order(uint64_t order_id) const;
+    size_t order_count() const;
+
     double get_best_bid() const;
     double get_best_ask() const;
 
+    // Fills the price and quantity fields of top; never throws on an empty side
+    void get_top_of_book(TopOfBook &top) const;
+
+    // Resting orders at a level rebuilt as full Orders, in time priority
     OrderQueue get_bids(double price) const;
     OrderQueue get_asks(double price) const;
 
-    void match_orders(Order &order);
+    // Matches the order, then rests any LIMIT or POST_ONLY remainder; IOC and
+    // MARKET remainders expire. A FOK that cannot fill in full expires, and a
+    // POST_ONLY that would cross is rejected, both before the book changes.
+    // The result is cheap to fill in, so callers that do not need it ignore it.
+    MatchResult match_orders(Order &order);
+
+    // Matches a node taken from get_order_pool(). The book takes ownership: the
+    // node rests as-is if any quantity remains, otherwise it goes back to the pool
+    void match_orders(OrderNode *node);
+    OrderPool &get_order_pool();
+
+    // Fills are published here as they happen; nullptr (the default) drops them.
+    // The stream must outlive the book and only the matching thread may write it.
+    void set_execution_stream(ExecutionStream *stream);
+
+    // Aggregate quantity per level, best first, at most max_levels per side (0 = all)
+    void get_depth(size_t max_levels, std::vector<LevelQuantity> &bid_levels, std::vector<LevelQuantity> &ask_levels) const;
+
+    // Visits the non-empty levels of one side as fn(tick, level), best first,
+    // at most max_levels of them (0 = all); each level's orders are linked
+    // from level.head in time priority
+    template <typename Fn>
+    void for_each_level(OrderSide side, Fn fn, size_t max_levels = 0) const
+    {
+        (side == OrderSide::BUY ? bids : asks).for_each_level(max_levels, fn);
+    }
+    size_t level_count(OrderSide side) const;
+
+    // When enabled, the book remembers which levels changed until the next
+    // drain_level_changes(), which reports each once as fn(side, price, quantity)
+    void set_level_tracking(bool enabled);
+
+    template <typename Fn>
+    void drain_level_changes(Fn fn)
+    {
+        std::sort(changed_levels.begin(), changed_levels.end());
+        auto end = std::unique(changed_levels.begin(), changed_levels.end());
+        for (auto it = changed_levels.begin(); it != end; ++it)
+        {
+            const PriceLevel *level = ladder_for(it->side).find_level(it->tick);
+            int64_t quantity = level && level->head ? level->total_quantity : 0;
+            fn(it->side, tick_to_price(it->tick), quantity);
+        }
+        changed_levels.clear();
+    }
+
+    double get_tick_size() const;
+    // The band passed at construction; books replaying each other's commands
+    // must agree on it, or they accept different orders
+    size_t get_max_levels_per_side() const;
+    Tick price_to_tick(double price) const;
+    // price_to_tick for a limit price; 0 if it is not finite, not positive,
+    // or too large to be a tick
+    Tick limit_tick(double price) const;
+    double tick_to_price(Tick tick) const;
 
 private:
-    std::map<double, OrderQueue, std::greater<double>> bids;
-    std::map<double, OrderQueue, std::less<double>> asks;
+    double tick_size;
+    size_t max_levels_per_side;
+    OrderPool order_pool; // declared first so it outlives every node
+    PriceLadder bids;
+    PriceLadder asks;
+    OrderIndex order_index;
+    ExecutionStream *execution_stream;
+
+    struct ChangedLevel
+    {
+        OrderSide side;
+        Tick tick;
 
-    void add_order_to_book(Order &order);
-    void remove_order_from_book(Order &order);
+        bool operator<(const ChangedLevel &other) const
+        {
+            return side != other.side ? side < other.side : tick < other.tick;
+        }
+        bool operator==(const ChangedLevel &other) const
+        {
+            return side == other.side && tick == other.tick;
+        }
+    };
+    bool track_level_changes;
+    std::vector<ChangedLevel> changed_levels;
+
+    bool add_order_to_book(Order &order);
+    bool rest_node(OrderNode *node);
+    // Duplicate id, price, FOK and post-only pre-checks; false (with result and the event
+    // filled in) if the order must not match at all
+    bool admit(const RestingOrder &taker, SymbolId symbol_id, MatchResult &result);
+    static bool rests(OrderType type);
+    void match_against_book(RestingOrder &taker, SymbolId symbol_id, MatchResult &result);
+    // The fill loop for one taker side and type, chosen once per order by
+    // match_against_book; Limit is false for market orders, which never stop on price
+    template <OrderSide Side, bool Limit>
+    void match_kernel(RestingOrder &taker, SymbolId symbol_id, MatchResult &result, int64_t timestamp_ns);
+    void mark_level_changed(OrderSide side, Tick tick);
+    void publish_fill(const RestingOrder &taker, SymbolId symbol_id, const OrderNode *maker, int quantity, int64_t timestamp_ns);
+    void publish_done(ExecutionType type, const RestingOrder &order, SymbolId symbol_id);
+    bool remove_order_from_book(uint64_t order_id);
     void update_order_in_book(Order &order);
-};
\ No newline at end of file
+
+    PriceLadder &ladder_for(OrderSide side);
+    OrderQueue copy_level(const PriceLevel *level) const;
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "MarketData.h"
+#include "Order.h"
+#include "OrderCompletion.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+enum class CommandType
+{
+    NEW_ORDER,
+    CANCEL_ORDER,
+    AMEND_ORDER,
+    SNAPSHOT,
+    QUERY_ORDER
+};
+
+// Reads leave the books unchanged: they are never journaled, and are still
+// served once the journal has failed
+inline bool is_read_command(CommandType type)
+{
+    return type == CommandType::SNAPSHOT || type == CommandType::QUERY_ORDER;
+}
+
+// One in-flight snapshot request, in a table the engine owns for its whole
+// life. The requester claims a free slot and the matching thread fills it
+// between two commands, so it is consistent with the market data stream
+// position recorded in it. A requester that gives up marks the slot abandoned
+// and the matching thread frees it when it gets there, so a late result never
+// lands in a later request.
+struct SnapshotSlot
+{
+    enum class State
+    {
+        FREE,
+        PENDING,
+        DONE,
+        ABANDONED
+    };
+
+    std::mutex mutex;
+    std::condition_variable done;
+    State state = State::FREE; // guarded by mutex
+    size_t max_levels = 0;     // set by the requester before the command is queued
+    BookSnapshot snapshot;
+};
+
+// Unit of work handed from producers to the matching thread. Fixed size and
+// stored by value in the command ring, so submitting an order never allocates.
+struct OrderCommand
+{
+    CommandType type;
+    SymbolId symbol_id; // book the command applies to
+    uint64_t order_id;  // order to cancel, amend or look up
+    Order order;        // order to match for NEW_ORDER; new price and quantity for AMEND_ORDER
+    SnapshotSlot *snapshot;       // only set for SNAPSHOT; a slot in the engine's table
+    uint64_t received_at;         // CycleClock ticks; 0 when latency is not recorded
+    OrderCompletion *completion;  // set for QUERY_ORDER and for waiting NEW / CANCEL / AMEND submitters
+    uint32_t completion_ticket;
+    bool refused;                 // dropped by a failed journal; the matching thread only reports it
+};
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "Order.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+class OrderCompletion;
+
+// Told on the matching thread when a completion's outcome is published, for
+// a submitter that does not wait on the futex. Must return quickly and never
+// block: the matching thread stalls until it does.
+class CompletionListener
+{
+public:
+    virtual void completed(OrderCompletion &completion) = 0;
+
+protected:
+    ~CompletionListener() = default;
+};
+
+// How the matching thread dealt with one order, for a submitter that waits
+struct OrderOutcome
+{
+    uint64_t order_id = 0;
+    int64_t filled_quantity = 0;
+    double average_price = 0.0; // of the fills; 0 when nothing filled
+    int64_t resting_quantity = 0;
+    OrderStatus status = OrderStatus::PENDING; // PENDING while any quantity rests
+    uint64_t execution_sequence = 0;           // QUERY_ORDER: execution stream position it reflects
+};
+
+// Hands one OrderOutcome from the matching thread to the thread that
+// submitted the order, without a mutex or condition variable. The submitter
+// arms a ticket, sends it with the command and waits; the matching thread
+// completes that ticket. A single futex word carries ticket * 4 + phase, so a
+// late completion for a ticket the submitter gave up on is recognised and
+// dropped instead of overwriting the next request's outcome.
+//
+// A slot serves one request at a time, so each submitting thread has its own
+// (for_this_thread). A thread hands its slot back when it exits and the next
+// new thread reuses it, so slots never outnumber the threads submitting at
+// once. They are never freed: a completion may arrive after the submitter
+// stopped waiting, even after its thread exited. An exiting thread abandons a
+// ticket still pending, and the next owner's tickets continue the slot's
+// sequence, so such a completion is dropped like any other late one.
+//
+// A completion built with a listener is not waited on: the listener is told
+// once the outcome is published and its owner collects it with take().
+class OrderCompletion
+{
+public:
+    explicit OrderCompletion(CompletionListener *listener = nullptr);
+
+    OrderCompletion(const OrderCompletion &) = delete;
+    OrderCompletion &operator=(const OrderCompletion &) = delete;
+
+    // Submitter: starts a new request and returns its ticket
+    uint32_t arm();
+
+    // Matching thread: publishes the outcome unless ticket was abandoned
+    void complete(uint32_t ticket, const OrderOutcome &outcome);
+
+    // Submitter: spins briefly, then sleeps on the futex until the outcome
+    // arrives. Returns false on timeout, after which the ticket is abandoned.
+    bool wait(uint32_t ticket, OrderOutcome &outcome, std::chrono::microseconds timeout);
+
+    // Submitter: copies the outcome out without waiting; false while ticket
+    // is still pending
+    bool take(uint32_t ticket, OrderOutcome &outcome) const;
+
+    static OrderCompletion &for_this_thread();
+
+private:
+    enum Phase : uint32_t
+    {
+        PENDING = 0,
+        WRITING = 1,
+        DONE = 2,
+        ABANDONED = 3
+    };
+
+    alignas(64) std::atomic<uint32_t> state_;
+    std::atomic<bool> sleeping_;
+    CompletionListener *listener_;
+    OrderOutcome outcome_; // written in WRITING, read after DONE
+
+    void sleep(uint32_t expected, std::chrono::nanoseconds timeout);
+    void wake();
+};
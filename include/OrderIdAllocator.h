@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+
+// Process-wide source of order ids. Each thread takes a block of kBlockSize
+// ids from one shared atomic and then hands them out with a thread-local
+// increment, so ids are unique, dense and increasing per thread, and the
+// shared counter is touched once per block rather than once per order.
+// Id 0 is never handed out.
+class OrderIdAllocator
+{
+public:
+    static constexpr uint64_t kBlockSize = 1024;
+
+    static uint64_t next();
+
+    // Ids up to and including id are never handed out from now on. Called
+    // after recovery with the highest id already in the books or journal;
+    // blocks threads already hold are dropped on their next call.
+    static void reserve_through(uint64_t id);
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "PriceLadder.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Open-addressing hash map from order id to resting node. Linear probing with
+// backward-shift deletion keeps it tombstone-free, and entries live in one flat
+// array so inserts and erases never allocate outside of a resize.
+class OrderIndex
+{
+public:
+    explicit OrderIndex(size_t initial_capacity = 1024);
+
+    OrderNode *find(uint64_t order_id) const;
+    // Returns false if order_id is already present
+    bool insert(uint64_t order_id, OrderNode *node);
+    // Returns the removed node, or nullptr if order_id was not present
+    OrderNode *erase(uint64_t order_id);
+
+    size_t size() const;
+
+    template <typename Fn>
+    void for_each(Fn fn) const
+    {
+        for (const Entry &entry : entries)
+        {
+            if (entry.node)
+            {
+                fn(entry.node);
+            }
+        }
+    }
+
+private:
+    struct Entry
+    {
+        uint64_t order_id;
+        OrderNode *node; // nullptr marks an empty slot
+    };
+
+    std::vector<Entry> entries;
+    size_t mask;
+    size_t count;
+
+    size_t home_slot(uint64_t order_id) const;
+    size_t find_slot(uint64_t order_id) const;
+    void grow();
+};
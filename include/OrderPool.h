@@ -0,0 +1,65 @@
+#pragma once
+
+#include "PriceLadder.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// Slab allocator for order nodes. Slabs are cache-line aligned, allocated up
+// front and only grown when exhausted, so the steady state never touches
+// malloc. Each book owns its pool and only the thread matching that book
+// acquires and releases, so released slots go on a plain intrusive free list:
+// no atomics, no locks. Each slot is one cache line; the OrderDetails of every
+// slot sit in a side table at the end of its slab, so walking a level never
+// pulls them in.
+class OrderPool
+{
+public:
+    // slab_nodes is rounded up to a power of two; prefault touches every page
+    // of a slab when it is allocated instead of on first use
+    explicit OrderPool(size_t slab_nodes = 4096, bool prefault = false);
+    ~OrderPool();
+
+    OrderPool(const OrderPool &) = delete;
+    OrderPool &operator=(const OrderPool &) = delete;
+
+    // Constructs a node holding the hot fields of order at price tick and
+    // stores the rest in the node's details
+    OrderNode *acquire(const Order &order, Tick tick);
+    void release(OrderNode *node);
+
+    const OrderDetails &details(const OrderNode *node) const;
+
+    size_t capacity() const;
+    size_t in_use() const;
+
+private:
+    struct alignas(64) Slot
+    {
+        OrderNode node;
+        uint32_t next_free; // index + 1 of the next free slot, 0 ends the list
+        uint32_t index;
+    };
+
+    static constexpr size_t kMaxSlabs = 4096;
+
+    size_t slab_nodes_;
+    size_t slab_shift_;
+    bool prefault_;
+
+    Slot *slabs_[kMaxSlabs];
+    size_t slab_count_;
+
+    // Released slots, most recent first, so a reused node is likely still cached
+    uint32_t free_head_; // index + 1, 0 when empty
+    // Slots past this index have never been handed out
+    uint64_t next_unused_;
+    size_t in_use_;
+
+    static_assert(sizeof(Slot) == 64, "Order pool slots are one cache line");
+
+    Slot *slot_at(uint64_t index) const;
+    OrderDetails *details_at(uint64_t index) const;
+    Slot *pop_free();
+    void add_slab();
+};
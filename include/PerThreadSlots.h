@@ -0,0 +1,132 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// One T per thread using the owner, for single-writer statistics such as
+// counters and histograms. A thread claims a slot on first use, the only time
+// it takes the lock, and hands it back when it exits. The next thread to
+// arrive reuses it, values and all, so totals survive thread churn and the
+// slot count never exceeds the most threads that were using the owner at once.
+//
+// A slot outlives its owner until the thread holding it exits, so a thread may
+// record into an owner that is being destroyed without touching freed memory.
+template <typename T>
+class PerThreadSlots
+{
+public:
+    PerThreadSlots()
+        : pool_(std::make_shared<Pool>())
+    {
+    }
+
+    ~PerThreadSlots()
+    {
+        std::lock_guard<std::mutex> lock(pool_->mutex);
+        pool_->retired = true;
+    }
+
+    PerThreadSlots(const PerThreadSlots &) = delete;
+    PerThreadSlots &operator=(const PerThreadSlots &) = delete;
+
+    // The calling thread's slot; only this thread may write to it
+    T &local()
+    {
+        for (const Claim &claim : claims().held)
+        {
+            if (claim.pool.get() == pool_.get())
+            {
+                return *claim.slot;
+            }
+        }
+        return claim();
+    }
+
+    // Calls visit on every slot, held or free, under the lock
+    template <typename Visit>
+    void for_each(Visit &&visit) const
+    {
+        std::lock_guard<std::mutex> lock(pool_->mutex);
+        for (const auto &slot : pool_->slots)
+        {
+            visit(static_cast<const T &>(*slot));
+        }
+    }
+
+private:
+    struct Pool
+    {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<T>> slots;
+        std::vector<T *> free; // released by threads that exited
+        bool retired = false;  // the owner is gone
+    };
+
+    // A held claim keeps its pool alive, so no later pool can share its address
+    struct Claim
+    {
+        std::shared_ptr<Pool> pool;
+        T *slot;
+    };
+
+    // Every slot this thread holds, in any owner; returned when the thread exits
+    struct Claims
+    {
+        std::vector<Claim> held;
+
+        ~Claims()
+        {
+            for (const Claim &claim : held)
+            {
+                std::lock_guard<std::mutex> lock(claim.pool->mutex);
+                if (!claim.pool->retired)
+                {
+                    claim.pool->free.push_back(claim.slot);
+                }
+            }
+        }
+    };
+
+    static Claims &claims()
+    {
+        thread_local Claims claims;
+        return claims;
+    }
+
+    T &claim()
+    {
+        std::vector<Claim> &held = claims().held;
+
+        // Claims on owners that are gone only pin memory; drop them here
+        for (auto it = held.begin(); it != held.end();)
+        {
+            bool retired;
+            {
+                std::lock_guard<std::mutex> lock(it->pool->mutex);
+                retired = it->pool->retired;
+            }
+            // Unlocked first: erasing may free the pool along with its mutex
+            it = retired ? held.erase(it) : it + 1;
+        }
+
+        T *slot;
+        {
+            std::lock_guard<std::mutex> lock(pool_->mutex);
+            if (!pool_->free.empty())
+            {
+                slot = pool_->free.back();
+                pool_->free.pop_back();
+            }
+            else
+            {
+                pool_->slots.push_back(std::make_unique<T>());
+                slot = pool_->slots.back().get();
+            }
+        }
+        held.push_back(Claim{pool_, slot});
+        return *slot;
+    }
+
+    std::shared_ptr<Pool> pool_;
+};
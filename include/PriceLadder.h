@@ -0,0 +1,122 @@
+#pragma once
+
+#include "Order.h"
+
+#include <cstdint>
+#include <vector>
+
+using Tick = int64_t;
+
+// The fields matching reads and writes, packed into half a cache line. Price
+// is an integer tick of the owning book; timestamp_ns is the order's creation
+// time, read once by the producer, so resting an order reads no clock.
+struct RestingOrder
+{
+    uint64_t id;
+    Tick tick;
+    int64_t timestamp_ns;
+    int32_t quantity;
+    OrderSide side;
+    OrderType type;
+    OrderStatus status;
+    Strategy strategy;
+};
+
+// Fields only needed to rebuild a full Order, kept out of the node
+struct OrderDetails
+{
+    SymbolId symbol_id;
+};
+
+// A resting order linked into its price level's FIFO. The book owns the node;
+// prev/next are intrusive so unlinking from the middle of a level is O(1).
+struct OrderNode
+{
+    RestingOrder order;
+    OrderNode *prev;
+    OrderNode *next;
+};
+
+static_assert(sizeof(RestingOrder) == 32, "Resting order record is half a cache line");
+
+struct PriceLevel
+{
+    OrderNode *head;
+    OrderNode *tail;
+    int64_t total_quantity;
+    uint32_t order_count;
+};
+
+// One side of the book as a contiguous array of price levels indexed by tick
+// offset from a base tick. The best level is cached as an index, so reaching the
+// touch never searches. The window grows when a price falls outside it and
+// slides to the new price when the side is empty. It never spans more than
+// max_levels ticks; prices that would need a wider window are refused by
+// can_hold, so one far-away order cannot make the book allocate without bound.
+class PriceLadder
+{
+public:
+    static constexpr size_t kDefaultMaxLevels = size_t(1) << 20;
+
+    explicit PriceLadder(OrderSide side, size_t initial_levels = 256, size_t max_levels = kDefaultMaxLevels);
+    ~PriceLadder();
+
+    bool empty() const;
+    size_t level_count() const;
+
+    // Only valid while the side is not empty
+    Tick best_tick() const;
+    PriceLevel &best_level();
+
+    PriceLevel *find_level(Tick tick);
+    const PriceLevel *find_level(Tick tick) const;
+
+    // Total quantity resting at limit or better, stopping as soon as it
+    // reaches wanted; reads only the levels it counts
+    int64_t quantity_through(Tick limit, int64_t wanted) const;
+
+    // Whether push_back at tick keeps the window within max_levels
+    bool can_hold(Tick tick) const;
+
+    // Links node at the back of the level at node->order.tick; the caller
+    // checks can_hold first
+    void push_back(OrderNode *node);
+
+    // Unlinks node from its level, moving the best level on if it empties
+    void unlink(OrderNode *node);
+
+    // Visits non-empty levels from the touch outwards as fn(tick, level),
+    // stopping after max_levels of them (0 visits every level)
+    template <typename Fn>
+    void for_each_level(size_t max_levels, Fn fn) const
+    {
+        size_t visited = 0;
+        size_t index = best_index;
+        while (visited < non_empty_levels && (max_levels == 0 || visited < max_levels))
+        {
+            const PriceLevel &level = levels[index];
+            if (level.head)
+            {
+                fn(base_tick + static_cast<Tick>(index), level);
+                ++visited;
+            }
+            // Levels further from the touch are lower for bids, higher for asks
+            index = side == OrderSide::BUY ? index - 1 : index + 1;
+        }
+    }
+
+private:
+    OrderSide side;
+    size_t initial_levels;
+    size_t max_levels;
+    Tick base_tick;
+    std::vector<PriceLevel> levels;
+    size_t best_index;
+    size_t non_empty_levels;
+
+    bool is_better(size_t lhs, size_t rhs) const;
+    bool in_window(Tick tick) const;
+    void ensure_window(Tick tick);
+    void regrow(size_t front_levels, size_t back_levels);
+    void find_next_best();
+};
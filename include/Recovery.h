@@ -0,0 +1,39 @@
+#pragma once
+
+#include "BookSnapshotFile.h"
+#include "Journal.h"
+#include "OrderBook.h"
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+
+// Rebuilds the order a SUBMIT record was journaled from
+Order order_from_record(const JournalRecord &record);
+
+// Applies one journal record to its book exactly as the matching thread
+// applied the original command
+void apply_journal_record(OrderBook &book, const JournalRecord &record);
+
+struct RecoveryStats
+{
+    uint64_t snapshot_sequence = 0; // journal sequence the snapshot covered
+    uint64_t snapshot_orders = 0;
+    uint64_t replayed_commands = 0; // journal tail applied after the snapshot
+    uint64_t last_sequence = 0;     // newest command now reflected in the books
+    uint64_t max_order_id = 0;      // highest id in the snapshot or the replayed journal
+    double seconds = 0.0;
+};
+
+// Restores books from the snapshot at snapshot_path (skipped if empty or
+// missing), then replays every journal record after it straight into the
+// books: one thread, no queue, no waiting. book_for returns the book for a
+// symbol, creating it if needed, with its tick from tick_sizes and
+// max_price_levels per side. Replay stops after record up_to. Throws
+// std::runtime_error if the snapshot is damaged, it is newer than the journal
+// or a book refuses one of its orders, or if the snapshot or journal was
+// written for books of another price band or other tick sizes.
+RecoveryStats recover_books(const std::string &snapshot_path, const std::string &journal_path,
+                            const TickSizes &tick_sizes, size_t max_price_levels, const std::function<OrderBook &(SymbolId)> &book_for,
+                            uint64_t up_to = std::numeric_limits<uint64_t>::max());
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "MatchingEngine.h"
+
+#include <memory>
+#include <vector>
+
+struct ShardedEngineConfig
+{
+    // Matching threads; each owns the books of the symbols routed to it
+    size_t shard_count = 1;
+    // Optional CPU per shard; shards past the end of the list are not pinned
+    std::vector<int> cpus;
+    // Applied to every shard (its cpu field is overridden from cpus). With more
+    // than one shard, shard i journals to journal.path + "." + i and
+    // snapshots to journal.snapshot_path + "." + i
+    MatchingEngineConfig engine;
+};
+
+// Partitions instruments across independent MatchingEngines. A symbol always
+// maps to the same shard, so every book keeps a single writer and matches
+// deterministically, while different symbols match in parallel.
+class ShardedMatchingEngine
+{
+public:
+    explicit ShardedMatchingEngine(const ShardedEngineConfig &config = ShardedEngineConfig());
+
+    ShardedMatchingEngine(const ShardedMatchingEngine &) = delete;
+    ShardedMatchingEngine &operator=(const ShardedMatchingEngine &) = delete;
+
+    // received_at as in MatchingEngine::process_order
+    bool process_order(Order &order, uint64_t received_at = 0);
+    bool cancel_order(uint64_t order_id, SymbolId symbol_id, uint64_t received_at = 0);
+    bool amend_order(uint64_t order_id, SymbolId symbol_id, double price, int quantity, uint64_t received_at = 0);
+    bool process_order_sync(Order &order, OrderOutcome &outcome,
+                            std::chrono::microseconds timeout = std::chrono::seconds(5), uint64_t received_at = 0);
+    bool cancel_order_sync(uint64_t order_id, SymbolId symbol_id, OrderOutcome &outcome,
+                           std::chrono::microseconds timeout = std::chrono::seconds(5), uint64_t received_at = 0);
+    bool amend_order_sync(uint64_t order_id, SymbolId symbol_id, double price, int quantity, OrderOutcome &outcome,
+                          std::chrono::microseconds timeout = std::chrono::seconds(5), uint64_t received_at = 0);
+    void process_order_async(Order &order, OrderCompletion &completion, uint32_t ticket, uint64_t received_at = 0);
+    void cancel_order_async(uint64_t order_id, SymbolId symbol_id, OrderCompletion &completion, uint32_t ticket,
+                            uint64_t received_at = 0);
+    void amend_order_async(uint64_t order_id, SymbolId symbol_id, double price, int quantity,
+                           OrderCompletion &completion, uint32_t ticket, uint64_t received_at = 0);
+    bool query_order(uint64_t order_id, SymbolId symbol_id, OrderOutcome &outcome,
+                     std::chrono::microseconds timeout = std::chrono::seconds(5));
+
+    size_t shard_count() const;
+    size_t shard_for(SymbolId symbol_id) const;
+    MatchingEngine &get_shard(size_t shard);
+
+    // Sleeps until any shard publishes past its cursor (one per shard, as read
+    // from get_shard(i).get_execution_stream()), or timeout passes
+    void wait_for_executions(const std::vector<uint64_t> &cursors, std::chrono::microseconds timeout) const;
+
+    // Market data for a symbol lives on the stream of the shard that owns it
+    const MarketDataStream &get_market_data_stream(SymbolId symbol_id) const;
+    bool get_snapshot(SymbolId symbol_id, size_t max_levels, BookSnapshot &snapshot);
+    // Lock-free; see MatchingEngine::get_top_of_book and get_depth
+    bool get_top_of_book(SymbolId symbol_id, TopOfBook &top) const;
+    bool get_depth(SymbolId symbol_id, size_t max_levels, DepthSnapshot &depth) const;
+
+    // Counters summed over all shards; last_batch_size is the largest of the
+    // shards' last batches
+    EngineStats get_stats() const;
+
+private:
+    mutable ReaderWakeup execution_wakeup_; // every shard notifies it; outlives them
+    std::vector<std::unique_ptr<MatchingEngine>> shards_;
+};
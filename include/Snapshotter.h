@@ -0,0 +1,63 @@
+#pragma once
+
+#include "OrderBook.h"
+#include "TickSizes.h"
+#include "WaitStrategy.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+// Writes book snapshots without touching the matching thread. It keeps a
+// second copy of the books, built on its own thread by replaying the journal
+// the same way recovery does, and snapshots that copy every interval journaled
+// commands. Between two commands the copy is exactly the live book as of that
+// sequence, so each snapshot is a consistent cut; matching pays nothing and
+// the cost is a second copy of the books in memory.
+class Snapshotter
+{
+public:
+    // durable_sequence returns the newest journal record that may be read:
+    // written, and synced when the journal syncs, so a snapshot never covers
+    // commands a crash could still lose; durable_advanced is notified each
+    // time it moves, and the thread parks on it while caught up. tick_sizes
+    // and max_price_levels must match the live books, or the copy accepts
+    // orders they rejected.
+    Snapshotter(const std::string &journal_path, const std::string &snapshot_path, const TickSizes &tick_sizes,
+                size_t max_price_levels, uint64_t interval, std::function<uint64_t()> durable_sequence,
+                ReaderWakeup &durable_advanced);
+    ~Snapshotter();
+
+    Snapshotter(const Snapshotter &) = delete;
+    Snapshotter &operator=(const Snapshotter &) = delete;
+
+    uint64_t snapshots_written() const;
+    // Journal sequence covered by the newest snapshot on disk
+    uint64_t snapshot_sequence() const;
+
+private:
+    std::string journal_path_;
+    std::string snapshot_path_;
+    TickSizes tick_sizes_;
+    size_t max_price_levels_;
+    uint64_t interval_;
+    std::function<uint64_t()> durable_sequence_;
+    ReaderWakeup &durable_advanced_;
+
+    // Owned by the snapshot thread
+    std::unordered_map<SymbolId, std::unique_ptr<OrderBook>> books_;
+    uint64_t applied_sequence_;
+
+    std::atomic<uint64_t> snapshots_written_;
+    std::atomic<uint64_t> snapshot_sequence_;
+    std::atomic<bool> stop_;
+    std::thread thread_;
+
+    OrderBook &book_for(SymbolId symbol_id);
+    void write_snapshot();
+    void run();
+};
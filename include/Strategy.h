@@ -1,8 +1,9 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 
-enum class Strategy
+enum class Strategy : uint8_t
 {
     QUANT_LONG_TERM,
     HIGH_FREQUENCY,
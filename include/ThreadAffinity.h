@@ -0,0 +1,5 @@
+#pragma once
+
+// Pins the calling thread to one CPU. Returns false if the platform does not
+// support it or the CPU is not available to this process.
+bool pin_current_thread(int cpu);
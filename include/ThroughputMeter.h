@@ -0,0 +1,73 @@
+#pragma once
+
+#include "PerThreadSlots.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+// Rates over the trailing windows, in events per second. A window that
+// reaches back past the meter's start covers only the time since the start.
+struct ThroughputStats
+{
+    uint64_t total = 0;
+    double per_second_1s = 0.0;
+    double per_second_10s = 0.0;
+    double per_second_60s = 0.0;
+    double peak_per_second = 0.0; // highest 1s window seen since start
+};
+
+// Counts events from many threads without sharing a cache line between them:
+// each thread increments its own padded counter, claimed on first use and
+// left to the next thread when it exits. A sampler thread sums the counters every sample_interval and turns the
+// samples into sliding-window rates, so readers get real recent rates
+// instead of a lifetime average.
+class ThroughputMeter
+{
+public:
+    explicit ThroughputMeter(std::chrono::milliseconds sample_interval = std::chrono::milliseconds(100));
+    ~ThroughputMeter();
+
+    ThroughputMeter(const ThroughputMeter &) = delete;
+    ThroughputMeter &operator=(const ThroughputMeter &) = delete;
+
+    // Touches only the calling thread's counter
+    void add(uint64_t count = 1);
+
+    // Sum of all counters right now
+    uint64_t total() const;
+
+    // As of the last sample, except total, which is current
+    ThroughputStats stats() const;
+
+private:
+    struct alignas(64) Counter
+    {
+        std::atomic<uint64_t> value{0};
+    };
+
+    struct Sample
+    {
+        std::chrono::steady_clock::time_point at;
+        uint64_t total;
+    };
+
+    double rate_over(std::chrono::steady_clock::time_point now, uint64_t total, std::chrono::seconds window) const;
+    void sample();
+    void run();
+
+    const std::chrono::milliseconds sample_interval_;
+
+    PerThreadSlots<Counter> counters_;
+
+    // Owned by the sampler thread; the published stats are guarded by stats_mutex_
+    std::deque<Sample> samples_;
+    mutable std::mutex stats_mutex_;
+    ThroughputStats stats_;
+
+    std::atomic<bool> stop_;
+    std::thread sampler_thread_;
+};
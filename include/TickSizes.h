@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Order.h"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+// Tick size of every instrument. Most share default_tick_size; per_symbol
+// overrides the ones quoted on another price grid.
+struct TickSizes
+{
+    double default_tick_size = 0.01;
+    std::unordered_map<SymbolId, double> per_symbol;
+
+    double for_symbol(SymbolId symbol_id) const;
+
+    // Whether every tick size is positive and finite
+    bool valid() const;
+
+    // Parses "SYMBOL=TICK" into per_symbol; false if malformed
+    bool add_override(const std::string &spec);
+
+    // Identifies the whole table, independent of insertion order. Journals
+    // record it so a log is never replayed into books on another grid.
+    uint64_t digest() const;
+};
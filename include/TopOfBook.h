@@ -0,0 +1,163 @@
+#pragma once
+
+#include "MarketData.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+// Latest TopOfBook per symbol, written by one matching thread and readable
+// from any thread without locks. Each symbol owns one cache-line cell guarded
+// by a seqlock: the writer makes the version odd, stores the payload as
+// relaxed atomic words and makes it even again; a reader retries until it
+// sees the same even version before and after copying. Readers never block
+// the writer and never see a torn record.
+//
+// Cells are found by open addressing on the symbol id. Only the writer claims
+// cells, so the table needs no locks to grow; it is sized up front instead.
+// Slot numbers are stable, so other per-symbol views can be indexed by them.
+class TopOfBookTable
+{
+public:
+    static constexpr size_t kNoSlot = static_cast<size_t>(-1);
+
+    // capacity is rounded up to a power of two
+    explicit TopOfBookTable(size_t capacity)
+        : capacity_(2)
+    {
+        while (capacity_ < capacity)
+        {
+            capacity_ <<= 1;
+        }
+        mask_ = capacity_ - 1;
+
+        cells_.reset(new Cell[capacity_]);
+        for (size_t i = 0; i < capacity_; ++i)
+        {
+            cells_[i].key.store(0, std::memory_order_relaxed);
+            cells_[i].version.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    TopOfBookTable(const TopOfBookTable &) = delete;
+    TopOfBookTable &operator=(const TopOfBookTable &) = delete;
+
+    size_t capacity() const
+    {
+        return capacity_;
+    }
+
+    // Writer only. Returns the cell for symbol_id, claiming one on first use,
+    // or kNoSlot when the table is full.
+    size_t claim(SymbolId symbol_id)
+    {
+        const uint64_t key = static_cast<uint64_t>(symbol_id) + 1;
+        size_t index = home_slot(symbol_id);
+        for (size_t probes = 0; probes < capacity_; ++probes, index = (index + 1) & mask_)
+        {
+            uint64_t current = cells_[index].key.load(std::memory_order_relaxed);
+            if (current == key)
+            {
+                return index;
+            }
+            if (current == 0)
+            {
+                cells_[index].key.store(key, std::memory_order_release);
+                return index;
+            }
+        }
+        return kNoSlot;
+    }
+
+    // Writer only
+    void publish(size_t slot, const TopOfBook &top)
+    {
+        Cell &cell = cells_[slot];
+
+        uint64_t words[kWords];
+        std::memcpy(words, &top, sizeof(TopOfBook));
+
+        uint64_t version = cell.version.load(std::memory_order_relaxed);
+        cell.version.store(version + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < kWords; ++i)
+        {
+            cell.words[i].store(words[i], std::memory_order_relaxed);
+        }
+        cell.version.store(version + 2, std::memory_order_release);
+    }
+
+    // Any thread. Returns the cell claimed for symbol_id, or kNoSlot.
+    size_t find(SymbolId symbol_id) const
+    {
+        const uint64_t key = static_cast<uint64_t>(symbol_id) + 1;
+        size_t index = home_slot(symbol_id);
+        for (size_t probes = 0; probes < capacity_; ++probes, index = (index + 1) & mask_)
+        {
+            uint64_t current = cells_[index].key.load(std::memory_order_acquire);
+            if (current == key)
+            {
+                return index;
+            }
+            if (current == 0)
+            {
+                return kNoSlot;
+            }
+        }
+        return kNoSlot;
+    }
+
+    // Any thread. Returns false if nothing was published for symbol_id yet.
+    bool read(SymbolId symbol_id, TopOfBook &out) const
+    {
+        size_t slot = find(symbol_id);
+        if (slot == kNoSlot)
+        {
+            return false;
+        }
+        const Cell *cell = &cells_[slot];
+
+        uint64_t words[kWords];
+        uint64_t version;
+        do
+        {
+            version = cell->version.load(std::memory_order_acquire);
+            if (version == 0)
+            {
+                return false;
+            }
+            for (size_t i = 0; i < kWords; ++i)
+            {
+                words[i] = cell->words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+        } while ((version & 1) != 0 || cell->version.load(std::memory_order_relaxed) != version);
+
+        std::memcpy(&out, words, sizeof(TopOfBook));
+        return true;
+    }
+
+private:
+    static constexpr size_t kWords = sizeof(TopOfBook) / sizeof(uint64_t);
+    static_assert(sizeof(TopOfBook) % sizeof(uint64_t) == 0, "TopOfBook must be a whole number of words");
+
+    struct alignas(64) Cell
+    {
+        std::atomic<uint64_t> key; // symbol_id + 1; 0 while unclaimed
+        std::atomic<uint64_t> version;
+        std::atomic<uint64_t> words[kWords];
+    };
+    static_assert(sizeof(Cell) == 64, "Top of book cells are one cache line");
+
+    size_t home_slot(SymbolId symbol_id) const
+    {
+        // Fibonacci hashing spreads consecutive symbol ids
+        return static_cast<size_t>((static_cast<uint64_t>(symbol_id) * 11400714819323198485ull) >> 32) & mask_;
+    }
+
+    size_t capacity_;
+    size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+};
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+enum class WaitStrategyType
+{
+    BUSY_SPIN,  // lowest wake-up latency, burns a core while idle
+    SPIN_YIELD, // spins briefly, then yields the core to other threads
+    BLOCKING    // spins briefly, then parks on a futex until a producer signals
+};
+
+bool parse_wait_strategy(const std::string &name, WaitStrategyType &type);
+const char *wait_strategy_name(WaitStrategyType type);
+
+inline void cpu_relax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+// Decides what the consumer does when its queue is empty, and how producers
+// wake it. Producers call notify() after every publish; it is a single relaxed
+// load unless the consumer is actually parked.
+class WaitStrategy
+{
+public:
+    explicit WaitStrategy(WaitStrategyType type, uint32_t spin_iterations = 1000);
+
+    WaitStrategyType get_type() const;
+
+    // Consumer side, once per empty poll. idle_rounds counts consecutive empty
+    // polls. has_work is re-checked after announcing that we are about to
+    // park, so a publish racing with the decision to sleep is never lost.
+    template <typename HasWork>
+    void idle(uint32_t idle_rounds, HasWork has_work)
+    {
+        if (type_ == WaitStrategyType::BUSY_SPIN || idle_rounds < spin_iterations_)
+        {
+            cpu_relax();
+            return;
+        }
+
+        if (type_ == WaitStrategyType::SPIN_YIELD)
+        {
+            std::this_thread::yield();
+            return;
+        }
+
+        uint32_t seq = wake_seq_.load(std::memory_order_acquire);
+        sleeping_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!has_work())
+        {
+            park(seq);
+        }
+        sleeping_.store(false, std::memory_order_relaxed);
+    }
+
+    // Producer side, after publishing work
+    void notify()
+    {
+        if (type_ != WaitStrategyType::BLOCKING)
+        {
+            return;
+        }
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleeping_.load(std::memory_order_relaxed))
+        {
+            wake();
+        }
+    }
+
+    // Unconditional wake-up, used on shutdown
+    void wake();
+
+private:
+    WaitStrategyType type_;
+    uint32_t spin_iterations_;
+
+    alignas(64) std::atomic<uint32_t> wake_seq_;
+    alignas(64) std::atomic<bool> sleeping_;
+
+    void park(uint32_t seq);
+};
+
+// Lets any number of reader threads sleep until a single writer has published
+// something, for streams that many threads follow. Readers park with a timeout
+// so they can also notice cancellation. The writer's notify_all() is a fence
+// and one relaxed load unless a reader is actually parked.
+class ReaderWakeup
+{
+public:
+    ReaderWakeup();
+
+    // Reader side. has_data is re-checked after registering as a waiter, so a
+    // publish racing with the decision to sleep is never lost.
+    template <typename HasData>
+    void wait(HasData has_data, std::chrono::microseconds timeout)
+    {
+        uint32_t seq = wake_seq_.load(std::memory_order_acquire);
+        waiters_.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!has_data())
+        {
+            park(seq, timeout);
+        }
+        waiters_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // Writer side, after publishing
+    void notify_all()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters_.load(std::memory_order_relaxed) != 0)
+        {
+            wake_all();
+        }
+    }
+
+private:
+    alignas(64) std::atomic<uint32_t> wake_seq_;
+    alignas(64) std::atomic<uint32_t> waiters_;
+
+    void park(uint32_t seq, std::chrono::microseconds timeout);
+    void wake_all();
+};
@@ -2,7 +2,7 @@
 # Generated by the protocol buffer compiler.  DO NOT EDIT!
 # NO CHECKED-IN PROTOBUF GENCODE
 # source: orderbook_service.proto
-# Protobuf Python Version: 6.31.0
+# Protobuf Python Version: 7.35.1
 """Generated protocol buffer code."""
 from google.protobuf import descriptor as _descriptor
 from google.protobuf import descriptor_pool as _descriptor_pool
@@ -11,9 +11,9 @@ from google.protobuf import symbol_database as _symbol_database
 from google.protobuf.internal import builder as _builder
 _runtime_version.ValidateProtobufRuntimeVersion(
     _runtime_version.Domain.PUBLIC,
-    6,
-    31,
-    0,
+    7,
+    35,
+    1,
     '',
     'orderbook_service.proto'
 )
@@ -24,51 +24,75 @@ _sym_db = _symbol_database.Default()
 
 
 
-DESCRIPTOR = _descriptor_pool.Default().AddSerializedFile(b'\n\x17orderbook_service.proto\x12\torderbook\"\xdf\x01\n\x05Order\x12\n\n\x02id\x18\x01 \x01(\x04\x12%\n\x08strategy\x18\x02 \x01(\x0e\x32\x13.orderbook.Strategy\x12\x10\n\x08quantity\x18\x03 \x01(\x05\x12\r\n\x05price\x18\x04 \x01(\x01\x12\"\n\x04side\x18\x05 \x01(\x0e\x32\x14.orderbook.OrderSide\x12\"\n\x04type\x18\x06 \x01(\x0e\x32\x14.orderbook.OrderType\x12&\n\x06status\x18\x07 \x01(\x0e\x32\x16.orderbook.OrderStatus\x12\x12\n\ncreated_at\x18\x08 \x01(\x03\"\xa4\x01\n\x12SubmitOrderRequest\x12%\n\x08strategy\x18\x01 \x01(\x0e\x32\x13.orderbook.Strategy\x12\x10\n\x08quantity\x18\x02 \x01(\x05\x12\r\n\x05price\x18\x03 \x01(\x01\x12\"\n\x04side\x18\x04 \x01(\x0e\x32\x14.orderbook.OrderSide\x12\"\n\x04type\x18\x05 \x01(\x0e\x32\x14.orderbook.OrderType\"I\n\x13SubmitOrderResponse\x12\x0f\n\x07success\x18\x01 \x01(\x08\x12\x0f\n\x07message\x18\x02 \x01(\t\x12\x10\n\x08order_id\x18\x03 \x01(\x04\"\x13\n\x11GetBestBidRequest\"E\n\x12GetBestBidResponse\x12\x0f\n\x07success\x18\x01 \x01(\x08\x12\r\n\x05price\x18\x02 \x01(\x01\x12\x0f\n\x07message\x18\x03 \x01(\t\"\x13\n\x11GetBestAskRequest\"E\n\x12GetBestAskResponse\x12\x0f\n\x07success\x18\x01 \x01(\x08\x12\r\n\x05price\x18\x02 \x01(\x01\x12\x0f\n\x07message\x18\x03 \x01(\t\"L\n\x17GetOrdersAtPriceRequest\x12\r\n\x05price\x18\x01 \x01(\x01\x12\"\n\x04side\x18\x02 \x01(\x0e\x32\x14.orderbook.OrderSide\"^\n\x18GetOrdersAtPriceResponse\x12\x0f\n\x07success\x18\x01 \x01(\x08\x12 \n\x06orders\x18\x02 \x03(\x0b\x32\x10.orderbook.Order\x12\x0f\n\x07message\x18\x03 \x01(\t\"&\n\x12\x43\x61ncelOrderRequest\x12\x10\n\x08order_id\x18\x01 \x01(\x04\"7\n\x13\x43\x61ncelOrderResponse\x12\x0f\n\x07success\x18\x01 \x01(\x08\x12\x0f\n\x07message\x18\x02 \x01(\t\"\x14\n\x12HealthCheckRequest\"\x85\x01\n\x13HealthCheckResponse\x12\x0f\n\x07healthy\x18\x01 \x01(\x08\x12\x0e\n\x06status\x18\x02 \x01(\t\x12\x16\n\x0euptime_seconds\x18\x03 \x01(\x03\x12\x15\n\ractive_orders\x18\x04 \x01(\x05\x12\x1e\n\x16total_orders_processed\x18\x05 \x01(\x03\"\x1c\n\x1aGetPerformanceStatsRequest\"\xdf\x01\n\x1bGetPerformanceStatsResponse\x12\x0f\n\x07success\x18\x01 \x01(\x08\x12\x1e\n\x16total_orders_processed\x18\x02 \x01(\x03\x12!\n\x19orders_per_second_current\x18\x03 \x01(\x01\x12\x1e\n\x16orders_per_second_peak\x18\x04 \x01(\x01\x12\x1b\n\x13queue_depth_current\x18\x05 \x01(\x05\x12\x17\n\x0fqueue_depth_max\x18\x06 \x01(\x05\x12\x16\n\x0euptime_seconds\x18\x07 \x01(\x03*L\n\tOrderSide\x12\x16\n\x12ORDER_SIDE_UNKNOWN\x10\x00\x12\x12\n\x0eORDER_SIDE_BUY\x10\x01\x12\x13\n\x0fORDER_SIDE_SELL\x10\x02*P\n\tOrderType\x12\x16\n\x12ORDER_TYPE_UNKNOWN\x10\x00\x12\x15\n\x11ORDER_TYPE_MARKET\x10\x01\x12\x14\n\x10ORDER_TYPE_LIMIT\x10\x02*\x91\x01\n\x0bOrderStatus\x12\x18\n\x14ORDER_STATUS_UNKNOWN\x10\x00\x12\x18\n\x14ORDER_STATUS_PENDING\x10\x01\x12\x17\n\x13ORDER_STATUS_FILLED\x10\x02\x12\x1a\n\x16ORDER_STATUS_CANCELLED\x10\x03\x12\x19\n\x15ORDER_STATUS_REJECTED\x10\x04*\x83\x02\n\x08Strategy\x12\x14\n\x10STRATEGY_UNKNOWN\x10\x00\x12\x1c\n\x18STRATEGY_QUANT_LONG_TERM\x10\x01\x12\x1b\n\x17STRATEGY_HIGH_FREQUENCY\x10\x02\x12\x17\n\x13STRATEGY_HEDGE_FUND\x10\x03\x12 \n\x1cSTRATEGY_ALGORITHMIC_TRADING\x10\x04\x12\x1c\n\x18STRATEGY_INVESTMENT_BANK\x10\x05\x12\x19\n\x15STRATEGY_PENSION_FUND\x10\x06\x12\x1e\n\x1aSTRATEGY_INSURANCE_COMPANY\x10\x07\x12\x12\n\x0eSTRATEGY_OTHER\x10\x08\x32\xd5\x04\n\x10OrderBookService\x12L\n\x0bSubmitOrder\x12\x1d.orderbook.SubmitOrderRequest\x1a\x1e.orderbook.SubmitOrderResponse\x12I\n\nGetBestBid\x12\x1c.orderbook.GetBestBidRequest\x1a\x1d.orderbook.GetBestBidResponse\x12I\n\nGetBestAsk\x12\x1c.orderbook.GetBestAskRequest\x1a\x1d.orderbook.GetBestAskResponse\x12[\n\x10GetOrdersAtPrice\x12\".orderbook.GetOrdersAtPriceRequest\x1a#.orderbook.GetOrdersAtPriceResponse\x12L\n\x0b\x43\x61ncelOrder\x12\x1d.orderbook.CancelOrderRequest\x1a\x1e.orderbook.CancelOrderResponse\x12L\n\x0bHealthCheck\x12\x1d.orderbook.HealthCheckRequest\x1a\x1e.orderbook.HealthCheckResponse\x12\x64\n\x13GetPerformanceStats\x12%.orderbook.GetPerformanceStatsRequest\x1a&.orderbook.GetPerformanceStatsResponseb\x06proto3')
+DESCRIPTOR = _descriptor_pool.Default().AddSerializedFile(b'\n\x17orderbook_service.proto\x12\torderbook\"\xf2\x01\n\x05Order\x12\n\n\x02id\x18\x01 \x01(\x04\x12%\n\x08strategy\x18\x02 \x01(\x0e\x32\x13.orderbook.Strategy\x12\x10\n\x08quantity\x18\x03 \x01(\x05\x12\r\n\x05price\x18\x04 \x01(\x01\x12\"\n\x04side\x18\x05 \x01(\x0e\x32\x14.orderbook.OrderSide\x12\"\n\x04type\x18\x06 \x01(\x0e\x32\x14.orderbook.OrderType\x12&\n\x06status\x18\x07 \x01(\x0e\x32\x16.orderbook.OrderStatus\x12\x12\n\ncreated_at\x18\x08 \x01(\x03\x12\x11\n\tsymbol_id\x18\t \x01(\r\"\xd0\x01\n\x12SubmitOrderRequest\x12%\n\x08strategy\x18\x01 \x01(\x0e\x32\x13.orderbook.Strategy\x12\x10\n\x08quantity\x18\x02 \x01(\x05\x12\r\n\x05price\x18\x03 \x01(\x01\x12\"\n\x04side\x18\x04 \x01(\x0e\x32\x14.orderbook.OrderSide\x12\"\n\x04type\x18\x05 \x01(\x0e\x32\x14.orderbook.OrderType\x12\x11\n\tsymbol_id\x18\x06 \x01(\r\x12\x17\n\x0fwait_for_result\x18\x07 \x01(\x08\"\xbb\x01\n\x13SubmitOrderResponse\x12\x0f\n\x07success\x18\x01 \x01(\x08\x12\x0f\n\x07message\x18\x02 \x01(\t\x12\x10\n\x08order_id\x18\x03 \x01(\x04\x12\x17\n\x0f\x66illed_quantity\x18\x04 \x01(\x03\x12\x15\n\raverage_price\x18\x05 \x01(\x01\x12\x18\n\x10resting_quantity\x18\x06 \x01(\x03\x12&\n\x06status\x18\x07 \x01(\x0e\x32\x16.orderbook.OrderStatus\"&\n\x11GetBestBidRequest\x12\x11\n\tsymbol_id\x18\x01 \x01(\r\"i\n\x12GetBestBidResponse\x12\x0f\n\x07success\x18\x01 \x01(\x08\x12\r\n\x05price\x18\x02 \x01(\x01\x12\x0f\n\x07message\x18\x03 \x01(\t\x12\x10\n\x08quantity\x18\x04 \x01(\x03\x12\x10\n\x08sequence\x18\x05 \x01(\x04\"&\n\x11GetBestAskRequest\x12\x11\n\tsymbol_id\x18\x01 \x01(\r\"i\n\x12GetBestAskResponse\x12\x0f\n\x07success\x18\x01 \x01(\x08\x12\r\n\x05price\x18\x02 \x01(\x01\x12\x0f\n\x07message\x18\x03 \x01(\t\x12\x10\n\x08quantity\x18\x04 \x01(\x03\x12\x10\n\x08sequence\x18\x05 \x01(\x04\"4\n\x0fGetDepthRequest\x12\x11\n\tsymbol_id\x18\x01 \x01(\r\x12\x0e\n\x06levels\x18\x02 \x01(\r\"B\n\nDepthLevel\x12\r\n\x05price\x18\x01 \x01(\x01\x12\x10\n\x08quantity\x18\x02 \x01(\x03\x12\x13\n\x0border_count\x18\x03 \x01(\r\"\x90\x01\n\x10GetDepthResponse\x12\x0f\n\x07success\x18\x01 \x01(\x08\x12\x0f\n\x07message\x18\x02 \x01(\t\x12\x10\n\x08sequence\x18\x03 \x01(\x04\x12#\n\x04\x62ids\x18\x04 \x03(\x0b\x32\x15.orderbook.DepthLevel\x12#\n\x04\x61sks\x18\x05 \x03(\x0b\x32\x15.orderbook.DepthLevel\"L\n\x17GetOrdersAtPriceRequest\x12\r\n\x05price\x18\x01 \x01(\x01\x12\"\n\x04side\x18\x02 \x01(\x0e\x32\x14.orderbook.OrderSide\"^\n\x18GetOrdersAtPriceResponse\x12\x0f\n\x07success\x18\x01 \x01(\x08\x12 \n\x06orders\x18\x02 \x03(\x0b\x32\x10.orderbook.Order\x12\x0f\n\x07message\x18\x03 \x01(\t\"9\n\x12\x43\x61ncelOrderRequest\x12\x10\n\x08order_id\x18\x01 \x01(\x04\x12\x11\n\tsymbol_id\x18\x02 \x01(\r\"7\n\x13\x43\x61ncelOrderResponse\x12\x0f\n\x07success\x18\x01 \x01(\x08\x12\x0f\n\x07message\x18\x02 \x01(\t\"\x14\n\x12HealthCheckRequest\"\x85\x01\n\x13HealthCheckResponse\x12\x0f\n\x07healthy\x18\x01 \x01(\x08\x12\x0e\n\x06status\x18\x02 \x01(\t\x12\x16\n\x0euptime_seconds\x18\x03 \x01(\x03\x12\x15\n\ractive_orders\x18\x04 \x01(\x05\x12\x1e\n\x16total_orders_processed\x18\x05 \x01(\x03\"\x1c\n\x1aGetPerformanceStatsRequest\"\x88\x05\n\x1bGetPerformanceStatsResponse\x12\x0f\n\x07success\x18\x01 \x01(\x08\x12\x1e\n\x16total_orders_processed\x18\x02 \x01(\x03\x12!\n\x19orders_per_second_current\x18\x03 \x01(\x01\x12\x1e\n\x16orders_per_second_peak\x18\x04 \x01(\x01\x12\x1b\n\x13queue_depth_current\x18\x05 \x01(\x05\x12\x17\n\x0fqueue_depth_max\x18\x06 \x01(\x05\x12\x16\n\x0euptime_seconds\x18\x07 \x01(\x03\x12\x30\n\x0fstage_latencies\x18\x08 \x03(\x0b\x32\x17.orderbook.StageLatency\x12\x1d\n\x15orders_per_second_10s\x18\t \x01(\x01\x12\x1d\n\x15orders_per_second_60s\x18\n \x01(\x01\x12\x1f\n\x17total_requests_received\x18\x0b \x01(\x03\x12\x0f\n\x07\x62\x61tches\x18\x0c \x01(\x03\x12\x17\n\x0flast_batch_size\x18\r \x01(\x03\x12\x16\n\x0emax_batch_size\x18\x0e \x01(\x03\x12\x18\n\x10\x62\x61tch_size_limit\x18\x0f \x01(\x03\x12\x1a\n\x12journaled_commands\x18\x10 \x01(\x03\x12\x15\n\rjournal_syncs\x18\x11 \x01(\x03\x12\x19\n\x11snapshots_written\x18\x12 \x01(\x03\x12\x16\n\x0ejournal_failed\x18\x13 \x01(\x08\x12\x17\n\x0fjournal_refused\x18\x14 \x01(\x03\x12\x1b\n\x13journal_queue_depth\x18\x15 \x01(\x05\x12\x1e\n\x16journal_queue_capacity\x18\x16 \x01(\x05\"m\n\x0cStageLatency\x12\r\n\x05stage\x18\x01 \x01(\t\x12\r\n\x05\x63ount\x18\x02 \x01(\x04\x12\x0e\n\x06p50_ns\x18\x03 \x01(\x04\x12\x0e\n\x06p99_ns\x18\x04 \x01(\x04\x12\x0f\n\x07p999_ns\x18\x05 \x01(\x04\x12\x0e\n\x06max_ns\x18\x06 \x01(\x04\">\n\x1aSubscribeMarketDataRequest\x12\x11\n\tsymbol_id\x18\x01 \x01(\r\x12\r\n\x05\x64\x65pth\x18\x02 \x01(\r\"5\n\x12PriceLevelQuantity\x12\r\n\x05price\x18\x01 \x01(\x01\x12\x10\n\x08quantity\x18\x02 \x01(\x03\"\xa6\x01\n\x10MarketDataUpdate\x12\x11\n\tsymbol_id\x18\x01 \x01(\r\x12\x13\n\x0bis_snapshot\x18\x02 \x01(\x08\x12\x10\n\x08sequence\x18\x03 \x01(\x04\x12+\n\x04\x62ids\x18\x04 \x03(\x0b\x32\x1d.orderbook.PriceLevelQuantity\x12+\n\x04\x61sks\x18\x05 \x03(\x0b\x32\x1d.orderbook.PriceLevelQuantity\"Y\n\x11\x41mendOrderRequest\x12\x10\n\x08order_id\x18\x01 \x01(\x04\x12\x11\n\tsymbol_id\x18\x02 \x01(\r\x12\r\n\x05price\x18\x03 \x01(\x01\x12\x10\n\x08quantity\x18\x04 \x01(\x05\"x\n\x12\x41mendOrderResponse\x12\x0f\n\x07success\x18\x01 \x01(\x08\x12\x0f\n\x07message\x18\x02 \x01(\t\x12\x18\n\x10resting_quantity\x18\x03 \x01(\x05\x12&\n\x06status\x18\x04 \x01(\x0e\x32\x16.orderbook.OrderStatus\"\xc7\x01\n\x11OrderEntryRequest\x12\x17\n\x0f\x63lient_order_id\x18\x01 \x01(\x04\x12/\n\x06submit\x18\x02 \x01(\x0b\x32\x1d.orderbook.SubmitOrderRequestH\x00\x12/\n\x06\x63\x61ncel\x18\x03 \x01(\x0b\x32\x1d.orderbook.CancelOrderRequestH\x00\x12-\n\x05\x61mend\x18\x04 \x01(\x0b\x32\x1c.orderbook.AmendOrderRequestH\x00\x42\x08\n\x06\x61\x63tion\"\xe6\x01\n\x12OrderEntryResponse\x12\x17\n\x0f\x63lient_order_id\x18\x01 \x01(\x04\x12,\n\x04type\x18\x02 \x01(\x0e\x32\x1e.orderbook.ExecutionReportType\x12\x10\n\x08order_id\x18\x03 \x01(\x04\x12\r\n\x05price\x18\x04 \x01(\x01\x12\x10\n\x08quantity\x18\x05 \x01(\x05\x12\x17\n\x0fleaves_quantity\x18\x06 \x01(\x05\x12\x10\n\x08is_maker\x18\x07 \x01(\x08\x12\x1a\n\x12\x65xecution_sequence\x18\x08 \x01(\x04\x12\x0f\n\x07message\x18\t \x01(\t*L\n\tOrderSide\x12\x16\n\x12ORDER_SIDE_UNKNOWN\x10\x00\x12\x12\n\x0eORDER_SIDE_BUY\x10\x01\x12\x13\n\x0fORDER_SIDE_SELL\x10\x02*\x92\x01\n\tOrderType\x12\x16\n\x12ORDER_TYPE_UNKNOWN\x10\x00\x12\x15\n\x11ORDER_TYPE_MARKET\x10\x01\x12\x14\n\x10ORDER_TYPE_LIMIT\x10\x02\x12\x12\n\x0eORDER_TYPE_IOC\x10\x03\x12\x12\n\x0eORDER_TYPE_FOK\x10\x04\x12\x18\n\x14ORDER_TYPE_POST_ONLY\x10\x05*\x91\x01\n\x0bOrderStatus\x12\x18\n\x14ORDER_STATUS_UNKNOWN\x10\x00\x12\x18\n\x14ORDER_STATUS_PENDING\x10\x01\x12\x17\n\x13ORDER_STATUS_FILLED\x10\x02\x12\x1a\n\x16ORDER_STATUS_CANCELLED\x10\x03\x12\x19\n\x15ORDER_STATUS_REJECTED\x10\x04*\x83\x02\n\x08Strategy\x12\x14\n\x10STRATEGY_UNKNOWN\x10\x00\x12\x1c\n\x18STRATEGY_QUANT_LONG_TERM\x10\x01\x12\x1b\n\x17STRATEGY_HIGH_FREQUENCY\x10\x02\x12\x17\n\x13STRATEGY_HEDGE_FUND\x10\x03\x12 \n\x1cSTRATEGY_ALGORITHMIC_TRADING\x10\x04\x12\x1c\n\x18STRATEGY_INVESTMENT_BANK\x10\x05\x12\x19\n\x15STRATEGY_PENSION_FUND\x10\x06\x12\x1e\n\x1aSTRATEGY_INSURANCE_COMPANY\x10\x07\x12\x12\n\x0eSTRATEGY_OTHER\x10\x08*\xac\x01\n\x13\x45xecutionReportType\x12\x12\n\x0eREPORT_UNKNOWN\x10\x00\x12\x0e\n\nREPORT_ACK\x10\x01\x12\x11\n\rREPORT_REJECT\x10\x02\x12\x0f\n\x0bREPORT_FILL\x10\x03\x12\x14\n\x10REPORT_CANCELLED\x10\x04\x12\x12\n\x0eREPORT_EXPIRED\x10\x05\x12\x0e\n\nREPORT_GAP\x10\x06\x12\x13\n\x0fREPORT_REPLACED\x10\x07\x32\x97\x07\n\x10OrderBookService\x12L\n\x0bSubmitOrder\x12\x1d.orderbook.SubmitOrderRequest\x1a\x1e.orderbook.SubmitOrderResponse\x12I\n\nGetBestBid\x12\x1c.orderbook.GetBestBidRequest\x1a\x1d.orderbook.GetBestBidResponse\x12I\n\nGetBestAsk\x12\x1c.orderbook.GetBestAskRequest\x1a\x1d.orderbook.GetBestAskResponse\x12\x43\n\x08GetDepth\x12\x1a.orderbook.GetDepthRequest\x1a\x1b.orderbook.GetDepthResponse\x12[\n\x10GetOrdersAtPrice\x12\".orderbook.GetOrdersAtPriceRequest\x1a#.orderbook.GetOrdersAtPriceResponse\x12L\n\x0b\x43\x61ncelOrder\x12\x1d.orderbook.CancelOrderRequest\x1a\x1e.orderbook.CancelOrderResponse\x12I\n\nAmendOrder\x12\x1c.orderbook.AmendOrderRequest\x1a\x1d.orderbook.AmendOrderResponse\x12L\n\x0bHealthCheck\x12\x1d.orderbook.HealthCheckRequest\x1a\x1e.orderbook.HealthCheckResponse\x12\x64\n\x13GetPerformanceStats\x12%.orderbook.GetPerformanceStatsRequest\x1a&.orderbook.GetPerformanceStatsResponse\x12[\n\x13SubscribeMarketData\x12%.orderbook.SubscribeMarketDataRequest\x1a\x1b.orderbook.MarketDataUpdate0\x01\x12S\n\x10OrderEntryStream\x12\x1c.orderbook.OrderEntryRequest\x1a\x1d.orderbook.OrderEntryResponse(\x01\x30\x01\x62\x06proto3')
 
 _globals = globals()
 _builder.BuildMessageAndEnumDescriptors(DESCRIPTOR, _globals)
 _builder.BuildTopDescriptorsAndMessages(DESCRIPTOR, 'orderbook_service_pb2', _globals)
 if not _descriptor._USE_C_DESCRIPTORS:
   DESCRIPTOR._loaded_options = None
-  _globals['_ORDERSIDE']._serialized_start=1375
-  _globals['_ORDERSIDE']._serialized_end=1451
-  _globals['_ORDERTYPE']._serialized_start=1453
-  _globals['_ORDERTYPE']._serialized_end=1533
-  _globals['_ORDERSTATUS']._serialized_start=1536
-  _globals['_ORDERSTATUS']._serialized_end=1681
-  _globals['_STRATEGY']._serialized_start=1684
-  _globals['_STRATEGY']._serialized_end=1943
+  _globals['_ORDERSIDE']._serialized_start=3423
+  _globals['_ORDERSIDE']._serialized_end=3499
+  _globals['_ORDERTYPE']._serialized_start=3502
+  _globals['_ORDERTYPE']._serialized_end=3648
+  _globals['_ORDERSTATUS']._serialized_start=3651
+  _globals['_ORDERSTATUS']._serialized_end=3796
+  _globals['_STRATEGY']._serialized_start=3799
+  _globals['_STRATEGY']._serialized_end=4058
+  _globals['_EXECUTIONREPORTTYPE']._serialized_start=4061
+  _globals['_EXECUTIONREPORTTYPE']._serialized_end=4233
   _globals['_ORDER']._serialized_start=39
-  _globals['_ORDER']._serialized_end=262
-  _globals['_SUBMITORDERREQUEST']._serialized_start=265
-  _globals['_SUBMITORDERREQUEST']._serialized_end=429
-  _globals['_SUBMITORDERRESPONSE']._serialized_start=431
-  _globals['_SUBMITORDERRESPONSE']._serialized_end=504
-  _globals['_GETBESTBIDREQUEST']._serialized_start=506
-  _globals['_GETBESTBIDREQUEST']._serialized_end=525
-  _globals['_GETBESTBIDRESPONSE']._serialized_start=527
-  _globals['_GETBESTBIDRESPONSE']._serialized_end=596
-  _globals['_GETBESTASKREQUEST']._serialized_start=598
-  _globals['_GETBESTASKREQUEST']._serialized_end=617
-  _globals['_GETBESTASKRESPONSE']._serialized_start=619
-  _globals['_GETBESTASKRESPONSE']._serialized_end=688
-  _globals['_GETORDERSATPRICEREQUEST']._serialized_start=690
-  _globals['_GETORDERSATPRICEREQUEST']._serialized_end=766
-  _globals['_GETORDERSATPRICERESPONSE']._serialized_start=768
-  _globals['_GETORDERSATPRICERESPONSE']._serialized_end=862
-  _globals['_CANCELORDERREQUEST']._serialized_start=864
-  _globals['_CANCELORDERREQUEST']._serialized_end=902
-  _globals['_CANCELORDERRESPONSE']._serialized_start=904
-  _globals['_CANCELORDERRESPONSE']._serialized_end=959
-  _globals['_HEALTHCHECKREQUEST']._serialized_start=961
-  _globals['_HEALTHCHECKREQUEST']._serialized_end=981
-  _globals['_HEALTHCHECKRESPONSE']._serialized_start=984
-  _globals['_HEALTHCHECKRESPONSE']._serialized_end=1117
-  _globals['_GETPERFORMANCESTATSREQUEST']._serialized_start=1119
-  _globals['_GETPERFORMANCESTATSREQUEST']._serialized_end=1147
-  _globals['_GETPERFORMANCESTATSRESPONSE']._serialized_start=1150
-  _globals['_GETPERFORMANCESTATSRESPONSE']._serialized_end=1373
-  _globals['_ORDERBOOKSERVICE']._serialized_start=1946
-  _globals['_ORDERBOOKSERVICE']._serialized_end=2543
+  _globals['_ORDER']._serialized_end=281
+  _globals['_SUBMITORDERREQUEST']._serialized_start=284
+  _globals['_SUBMITORDERREQUEST']._serialized_end=492
+  _globals['_SUBMITORDERRESPONSE']._serialized_start=495
+  _globals['_SUBMITORDERRESPONSE']._serialized_end=682
+  _globals['_GETBESTBIDREQUEST']._serialized_start=684
+  _globals['_GETBESTBIDREQUEST']._serialized_end=722
+  _globals['_GETBESTBIDRESPONSE']._serialized_start=724
+  _globals['_GETBESTBIDRESPONSE']._serialized_end=829
+  _globals['_GETBESTASKREQUEST']._serialized_start=831
+  _globals['_GETBESTASKREQUEST']._serialized_end=869
+  _globals['_GETBESTASKRESPONSE']._serialized_start=871
+  _globals['_GETBESTASKRESPONSE']._serialized_end=976
+  _globals['_GETDEPTHREQUEST']._serialized_start=978
+  _globals['_GETDEPTHREQUEST']._serialized_end=1030
+  _globals['_DEPTHLEVEL']._serialized_start=1032
+  _globals['_DEPTHLEVEL']._serialized_end=1098
+  _globals['_GETDEPTHRESPONSE']._serialized_start=1101
+  _globals['_GETDEPTHRESPONSE']._serialized_end=1245
+  _globals['_GETORDERSATPRICEREQUEST']._serialized_start=1247
+  _globals['_GETORDERSATPRICEREQUEST']._serialized_end=1323
+  _globals['_GETORDERSATPRICERESPONSE']._serialized_start=1325
+  _globals['_GETORDERSATPRICERESPONSE']._serialized_end=1419
+  _globals['_CANCELORDERREQUEST']._serialized_start=1421
+  _globals['_CANCELORDERREQUEST']._serialized_end=1478
+  _globals['_CANCELORDERRESPONSE']._serialized_start=1480
+  _globals['_CANCELORDERRESPONSE']._serialized_end=1535
+  _globals['_HEALTHCHECKREQUEST']._serialized_start=1537
+  _globals['_HEALTHCHECKREQUEST']._serialized_end=1557
+  _globals['_HEALTHCHECKRESPONSE']._serialized_start=1560
+  _globals['_HEALTHCHECKRESPONSE']._serialized_end=1693
+  _globals['_GETPERFORMANCESTATSREQUEST']._serialized_start=1695
+  _globals['_GETPERFORMANCESTATSREQUEST']._serialized_end=1723
+  _globals['_GETPERFORMANCESTATSRESPONSE']._serialized_start=1726
+  _globals['_GETPERFORMANCESTATSRESPONSE']._serialized_end=2374
+  _globals['_STAGELATENCY']._serialized_start=2376
+  _globals['_STAGELATENCY']._serialized_end=2485
+  _globals['_SUBSCRIBEMARKETDATAREQUEST']._serialized_start=2487
+  _globals['_SUBSCRIBEMARKETDATAREQUEST']._serialized_end=2549
+  _globals['_PRICELEVELQUANTITY']._serialized_start=2551
+  _globals['_PRICELEVELQUANTITY']._serialized_end=2604
+  _globals['_MARKETDATAUPDATE']._serialized_start=2607
+  _globals['_MARKETDATAUPDATE']._serialized_end=2773
+  _globals['_AMENDORDERREQUEST']._serialized_start=2775
+  _globals['_AMENDORDERREQUEST']._serialized_end=2864
+  _globals['_AMENDORDERRESPONSE']._serialized_start=2866
+  _globals['_AMENDORDERRESPONSE']._serialized_end=2986
+  _globals['_ORDERENTRYREQUEST']._serialized_start=2989
+  _globals['_ORDERENTRYREQUEST']._serialized_end=3188
+  _globals['_ORDERENTRYRESPONSE']._serialized_start=3191
+  _globals['_ORDERENTRYRESPONSE']._serialized_end=3421
+  _globals['_ORDERBOOKSERVICE']._serialized_start=4236
+  _globals['_ORDERBOOKSERVICE']._serialized_end=5155
 # @@protoc_insertion_point(module_scope)
@@ -5,7 +5,7 @@ import warnings
 
 import orderbook_service_pb2 as orderbook__service__pb2
 
-GRPC_GENERATED_VERSION = '1.73.1'
+GRPC_GENERATED_VERSION = '1.84.0'
 GRPC_VERSION = grpc.__version__
 _version_not_supported = False
 
@@ -18,14 +18,14 @@ except ImportError:
 if _version_not_supported:
     raise RuntimeError(
         f'The grpc package installed is at version {GRPC_VERSION},'
-        + f' but the generated code in orderbook_service_pb2_grpc.py depends on'
+        + ' but the generated code in orderbook_service_pb2_grpc.py depends on'
         + f' grpcio>={GRPC_GENERATED_VERSION}.'
         + f' Please upgrade your grpc module to grpcio>={GRPC_GENERATED_VERSION}'
         + f' or downgrade your generated code using grpcio-tools<={GRPC_VERSION}.'
     )
 
 
-class OrderBookServiceStub(object):
+class OrderBookServiceStub:
     """OrderBook gRPC Service Definition
     """
 
@@ -50,6 +50,11 @@ class OrderBookServiceStub(object):
                 request_serializer=orderbook__service__pb2.GetBestAskRequest.SerializeToString,
                 response_deserializer=orderbook__service__pb2.GetBestAskResponse.FromString,
                 _registered_method=True)
+        self.GetDepth = channel.unary_unary(
+                '/orderbook.OrderBookService/GetDepth',
+                request_serializer=orderbook__service__pb2.GetDepthRequest.SerializeToString,
+                response_deserializer=orderbook__service__pb2.GetDepthResponse.FromString,
+                _registered_method=True)
         self.GetOrdersAtPrice = channel.unary_unary(
                 '/orderbook.OrderBookService/GetOrdersAtPrice',
                 request_serializer=orderbook__service__pb2.GetOrdersAtPriceRequest.SerializeToString,
@@ -60,6 +65,11 @@ class OrderBookServiceStub(object):
                 request_serializer=orderbook__service__pb2.CancelOrderRequest.SerializeToString,
                 response_deserializer=orderbook__service__pb2.CancelOrderResponse.FromString,
                 _registered_method=True)
+        self.AmendOrder = channel.unary_unary(
+                '/orderbook.OrderBookService/AmendOrder',
+                request_serializer=orderbook__service__pb2.AmendOrderRequest.SerializeToString,
+                response_deserializer=orderbook__service__pb2.AmendOrderResponse.FromString,
+                _registered_method=True)
         self.HealthCheck = channel.unary_unary(
                 '/orderbook.OrderBookService/HealthCheck',
                 request_serializer=orderbook__service__pb2.HealthCheckRequest.SerializeToString,
@@ -70,9 +80,19 @@ class OrderBookServiceStub(object):
                 request_serializer=orderbook__service__pb2.GetPerformanceStatsRequest.SerializeToString,
                 response_deserializer=orderbook__service__pb2.GetPerformanceStatsResponse.FromString,
                 _registered_method=True)
+        self.SubscribeMarketData = channel.unary_stream(
+                '/orderbook.OrderBookService/SubscribeMarketData',
+                request_serializer=orderbook__service__pb2.SubscribeMarketDataRequest.SerializeToString,
+                response_deserializer=orderbook__service__pb2.MarketDataUpdate.FromString,
+                _registered_method=True)
+        self.OrderEntryStream = channel.stream_stream(
+                '/orderbook.OrderBookService/OrderEntryStream',
+                request_serializer=orderbook__service__pb2.OrderEntryRequest.SerializeToString,
+                response_deserializer=orderbook__service__pb2.OrderEntryResponse.FromString,
+                _registered_method=True)
 
 
-class OrderBookServiceServicer(object):
+class OrderBookServiceServicer:
     """OrderBook gRPC Service Definition
     """
 
@@ -97,6 +117,13 @@ class OrderBookServiceServicer(object):
         context.set_details('Method not implemented!')
         raise NotImplementedError('Method not implemented!')
 
+    def GetDepth(self, request, context):
+        """Get aggregated price levels (price, quantity, order count) per side
+        """
+        context.set_code(grpc.StatusCode.UNIMPLEMENTED)
+        context.set_details('Method not implemented!')
+        raise NotImplementedError('Method not implemented!')
+
     def GetOrdersAtPrice(self, request, context):
         """Get all orders at a specific price level
         """
@@ -111,6 +138,14 @@ class OrderBookServiceServicer(object):
         context.set_details('Method not implemented!')
         raise NotImplementedError('Method not implemented!')
 
+    def AmendOrder(self, request, context):
+        """Change price and/or quantity of a resting order; a smaller quantity at
+        the same price keeps time priority
+        """
+        context.set_code(grpc.StatusCode.UNIMPLEMENTED)
+        context.set_details('Method not implemented!')
+        raise NotImplementedError('Method not implemented!')
+
     def HealthCheck(self, request, context):
         """Health check endpoint
         """
@@ -125,6 +160,20 @@ class OrderBookServiceServicer(object):
         context.set_details('Method not implemented!')
         raise NotImplementedError('Method not implemented!')
 
+    def SubscribeMarketData(self, request, context):
+        """Stream an L2 snapshot followed by per-batch level deltas
+        """
+        context.set_code(grpc.StatusCode.UNIMPLEMENTED)
+        context.set_details('Method not implemented!')
+        raise NotImplementedError('Method not implemented!')
+
+    def OrderEntryStream(self, request_iterator, context):
+        """Pipelined submits, cancels and amends with asynchronous acks and fills
+        """
+        context.set_code(grpc.StatusCode.UNIMPLEMENTED)
+        context.set_details('Method not implemented!')
+        raise NotImplementedError('Method not implemented!')
+
 
 def add_OrderBookServiceServicer_to_server(servicer, server):
     rpc_method_handlers = {
@@ -143,6 +192,11 @@ def add_OrderBookServiceServicer_to_server(servicer, server):
                     request_deserializer=orderbook__service__pb2.GetBestAskRequest.FromString,
                     response_serializer=orderbook__service__pb2.GetBestAskResponse.SerializeToString,
             ),
+            'GetDepth': grpc.unary_unary_rpc_method_handler(
+                    servicer.GetDepth,
+                    request_deserializer=orderbook__service__pb2.GetDepthRequest.FromString,
+                    response_serializer=orderbook__service__pb2.GetDepthResponse.SerializeToString,
+            ),
             'GetOrdersAtPrice': grpc.unary_unary_rpc_method_handler(
                     servicer.GetOrdersAtPrice,
                     request_deserializer=orderbook__service__pb2.GetOrdersAtPriceRequest.FromString,
@@ -153,6 +207,11 @@ def add_OrderBookServiceServicer_to_server(servicer, server):
                     request_deserializer=orderbook__service__pb2.CancelOrderRequest.FromString,
                     response_serializer=orderbook__service__pb2.CancelOrderResponse.SerializeToString,
             ),
+            'AmendOrder': grpc.unary_unary_rpc_method_handler(
+                    servicer.AmendOrder,
+                    request_deserializer=orderbook__service__pb2.AmendOrderRequest.FromString,
+                    response_serializer=orderbook__service__pb2.AmendOrderResponse.SerializeToString,
+            ),
             'HealthCheck': grpc.unary_unary_rpc_method_handler(
                     servicer.HealthCheck,
                     request_deserializer=orderbook__service__pb2.HealthCheckRequest.FromString,
@@ -163,6 +222,16 @@ def add_OrderBookServiceServicer_to_server(servicer, server):
                     request_deserializer=orderbook__service__pb2.GetPerformanceStatsRequest.FromString,
                     response_serializer=orderbook__service__pb2.GetPerformanceStatsResponse.SerializeToString,
             ),
+            'SubscribeMarketData': grpc.unary_stream_rpc_method_handler(
+                    servicer.SubscribeMarketData,
+                    request_deserializer=orderbook__service__pb2.SubscribeMarketDataRequest.FromString,
+                    response_serializer=orderbook__service__pb2.MarketDataUpdate.SerializeToString,
+            ),
+            'OrderEntryStream': grpc.stream_stream_rpc_method_handler(
+                    servicer.OrderEntryStream,
+                    request_deserializer=orderbook__service__pb2.OrderEntryRequest.FromString,
+                    response_serializer=orderbook__service__pb2.OrderEntryResponse.SerializeToString,
+            ),
     }
     generic_handler = grpc.method_handlers_generic_handler(
             'orderbook.OrderBookService', rpc_method_handlers)
@@ -171,7 +240,7 @@ def add_OrderBookServiceServicer_to_server(servicer, server):
 
 
  # This class is part of an EXPERIMENTAL API.
-class OrderBookService(object):
+class OrderBookService:
     """OrderBook gRPC Service Definition
     """
 
@@ -256,6 +325,33 @@ class OrderBookService(object):
             metadata,
             _registered_method=True)
 
+    @staticmethod
+    def GetDepth(request,
+            target,
+            options=(),
+            channel_credentials=None,
+            call_credentials=None,
+            insecure=False,
+            compression=None,
+            wait_for_ready=None,
+            timeout=None,
+            metadata=None):
+        return grpc.experimental.unary_unary(
+            request,
+            target,
+            '/orderbook.OrderBookService/GetDepth',
+            orderbook__service__pb2.GetDepthRequest.SerializeToString,
+            orderbook__service__pb2.GetDepthResponse.FromString,
+            options,
+            channel_credentials,
+            insecure,
+            call_credentials,
+            compression,
+            wait_for_ready,
+            timeout,
+            metadata,
+            _registered_method=True)
+
     @staticmethod
     def GetOrdersAtPrice(request,
             target,
@@ -310,6 +406,33 @@ class OrderBookService(object):
             metadata,
             _registered_method=True)
 
+    @staticmethod
+    def AmendOrder(request,
+            target,
+            options=(),
+            channel_credentials=None,
+            call_credentials=None,
+            insecure=False,
+            compression=None,
+            wait_for_ready=None,
+            timeout=None,
+            metadata=None):
+        return grpc.experimental.unary_unary(
+            request,
+            target,
+            '/orderbook.OrderBookService/AmendOrder',
+            orderbook__service__pb2.AmendOrderRequest.SerializeToString,
+            orderbook__service__pb2.AmendOrderResponse.FromString,
+            options,
+            channel_credentials,
+            insecure,
+            call_credentials,
+            compression,
+            wait_for_ready,
+            timeout,
+            metadata,
+            _registered_method=True)
+
     @staticmethod
     def HealthCheck(request,
             target,
@@ -363,3 +486,57 @@ class OrderBookService(object):
             timeout,
             metadata,
             _registered_method=True)
+
+    @staticmethod
+    def SubscribeMarketData(request,
+            target,
+            options=(),
+            channel_credentials=None,
+            call_credentials=None,
+            insecure=False,
+            compression=None,
+            wait_for_ready=None,
+            timeout=None,
+            metadata=None):
+        return grpc.experimental.unary_stream(
+            request,
+            target,
+            '/orderbook.OrderBookService/SubscribeMarketData',
+            orderbook__service__pb2.SubscribeMarketDataRequest.SerializeToString,
+            orderbook__service__pb2.MarketDataUpdate.FromString,
+            options,
+            channel_credentials,
+            insecure,
+            call_credentials,
+            compression,
+            wait_for_ready,
+            timeout,
+            metadata,
+            _registered_method=True)
+
+    @staticmethod
+    def OrderEntryStream(request_iterator,
+            target,
+            options=(),
+            channel_credentials=None,
+            call_credentials=None,
+            insecure=False,
+            compression=None,
+            wait_for_ready=None,
+            timeout=None,
+            metadata=None):
+        return grpc.experimental.stream_stream(
+            request_iterator,
+            target,
+            '/orderbook.OrderBookService/OrderEntryStream',
+            orderbook__service__pb2.OrderEntryRequest.SerializeToString,
+            orderbook__service__pb2.OrderEntryResponse.FromString,
+            options,
+            channel_credentials,
+            insecure,
+            call_credentials,
+            compression,
+            wait_for_ready,
+            timeout,
+            metadata,
+            _registered_method=True)
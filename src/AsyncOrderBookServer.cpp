@@ -0,0 +1,481 @@
+#include "AsyncOrderBookServer.h"
+#include "CycleClock.h"
+#include "ThreadAffinity.h"
+#include <grpc++/alarm.h>
+#include <iostream>
+#include <optional>
+
+namespace
+{
+    using AsyncUnaryService =
+        orderbook::OrderBookService::WithAsyncMethod_SubmitOrder<
+            orderbook::OrderBookService::WithAsyncMethod_GetBestBid<
+                orderbook::OrderBookService::WithAsyncMethod_GetBestAsk<
+                    orderbook::OrderBookService::WithAsyncMethod_GetDepth<
+                        orderbook::OrderBookService::WithAsyncMethod_GetOrdersAtPrice<
+                            orderbook::OrderBookService::WithAsyncMethod_CancelOrder<
+                                orderbook::OrderBookService::WithAsyncMethod_AmendOrder<
+                                    orderbook::OrderBookService::WithAsyncMethod_HealthCheck<
+                                        orderbook::OrderBookService::WithAsyncMethod_GetPerformanceStats<
+                                            orderbook::OrderBookService::Service>>>>>>>>>;
+}
+
+// Unary methods are served from the completion queues; the streaming methods
+// are forwarded to the synchronous implementation
+class AsyncOrderBookServer::HybridService final : public AsyncUnaryService
+{
+public:
+    explicit HybridService(OrderBookServiceImpl &impl) : impl_(impl) {}
+
+    grpc::Status SubscribeMarketData(grpc::ServerContext *context,
+                                     const orderbook::SubscribeMarketDataRequest *request,
+                                     grpc::ServerWriter<orderbook::MarketDataUpdate> *writer) override
+    {
+        return impl_.SubscribeMarketData(context, request, writer);
+    }
+
+    grpc::Status OrderEntryStream(grpc::ServerContext *context,
+                                  grpc::ServerReaderWriter<orderbook::OrderEntryResponse, orderbook::OrderEntryRequest> *stream) override
+    {
+        return impl_.OrderEntryStream(context, stream);
+    }
+
+private:
+    OrderBookServiceImpl &impl_;
+};
+
+// A completion queue tag; proceed() runs on a poller thread when the call's
+// last queued operation completes
+class AsyncOrderBookServer::CallBase
+{
+public:
+    virtual ~CallBase() = default;
+    virtual void proceed(bool ok) = 0;
+    // A matching thread answered the call's command; runs on a poller
+    virtual void answered() {}
+
+    CallBase *next_answered = nullptr; // link in its queue's inbox
+};
+
+// Hands calls the matching threads have answered back to one queue's
+// pollers. Answers push onto a lock-free stack; only the push that finds it
+// empty sets the alarm, and the poller that alarm wakes takes the whole
+// stack, so a burst of answers costs one completion queue event.
+class AsyncOrderBookServer::Inbox final : public CallBase
+{
+public:
+    explicit Inbox(Queue &queue) : queue_(queue), head_(nullptr) {}
+
+    // Matching thread
+    void push(CallBase *call)
+    {
+        CallBase *head = head_.load(std::memory_order_relaxed);
+        do
+        {
+            call->next_answered = head;
+        } while (!head_.compare_exchange_weak(head, call, std::memory_order_release, std::memory_order_relaxed));
+        if (head != nullptr)
+        {
+            return; // the alarm is already set and has yet to fire
+        }
+
+        std::lock_guard<std::mutex> lock(queue_.mutex);
+        if (!queue_.shut_down)
+        {
+            // Already due, so it fires as soon as a poller asks for work
+            alarm_.Set(queue_.cq.get(), gpr_now(GPR_CLOCK_MONOTONIC), this);
+        }
+    }
+
+    void proceed(bool) override
+    {
+        // Taken before the first call runs, so a push from here on sets the
+        // alarm again, which has fired and may be reused
+        CallBase *call = head_.exchange(nullptr, std::memory_order_acquire);
+        while (call != nullptr)
+        {
+            CallBase *next = call->next_answered;
+            call->answered();
+            call = next;
+        }
+    }
+
+private:
+    Queue &queue_;
+    std::atomic<CallBase *> head_;
+    grpc::Alarm alarm_;
+};
+
+AsyncOrderBookServer::Queue::Queue() : inbox(std::make_unique<Inbox>(*this)) {}
+
+AsyncOrderBookServer::Queue::~Queue() = default;
+
+// Handlers that answer on the poller: they enqueue or read counters
+template <typename Request, typename Response>
+class AsyncOrderBookServer::UnaryCall final : public CallBase
+{
+public:
+    using RequestFn = void (HybridService::*)(grpc::ServerContext *, Request *,
+                                              grpc::ServerAsyncResponseWriter<Response> *,
+                                              grpc::CompletionQueue *, grpc::ServerCompletionQueue *, void *);
+    using HandlerFn = grpc::Status (OrderBookServiceImpl::*)(grpc::ServerContext *, const Request *, Response *);
+
+    UnaryCall(AsyncOrderBookServer &, HybridService &service, OrderBookServiceImpl &impl, Queue &queue,
+              RequestFn request_fn, HandlerFn handler)
+        : service_(service), impl_(impl), queue_(queue),
+          request_fn_(request_fn), handler_(handler), finishing_(false) {}
+
+    // Resets the call state in place and posts it for the next incoming call
+    void arm()
+    {
+        responder_.reset();
+        context_.emplace();
+        responder_.emplace(&*context_);
+        request_.Clear();
+        response_.Clear();
+        finishing_ = false;
+
+        std::lock_guard<std::mutex> lock(queue_.mutex);
+        if (queue_.shut_down)
+        {
+            return;
+        }
+        (service_.*request_fn_)(&*context_, &request_, &*responder_, queue_.cq.get(), queue_.cq.get(), this);
+    }
+
+    void proceed(bool ok) override
+    {
+        if (finishing_)
+        {
+            // Response sent (or the client went away): recycle for the next call
+            arm();
+            return;
+        }
+        if (!ok)
+        {
+            // The server is shutting down; the call is not re-posted
+            return;
+        }
+
+        grpc::Status status = (impl_.*handler_)(&*context_, &request_, &response_);
+        finishing_ = true;
+        responder_->Finish(response_, status, this);
+    }
+
+private:
+    HybridService &service_;
+    OrderBookServiceImpl &impl_;
+    Queue &queue_;
+    RequestFn request_fn_;
+    HandlerFn handler_;
+
+    std::optional<grpc::ServerContext> context_;
+    std::optional<grpc::ServerAsyncResponseWriter<Response>> responder_;
+    Request request_;
+    Response response_;
+    bool finishing_;
+};
+
+// Handlers that report a matching result. begin queues the command and the
+// poller moves on; the matching thread's completion pushes the call onto its
+// queue's inbox and whichever poller takes it finishes the response. The
+// call's own completion slot carries the outcome, so nothing is allocated
+// per call and no thread waits on the matching thread.
+template <typename Request, typename Response>
+class AsyncOrderBookServer::MatchedCall final : public CallBase, public CompletionListener
+{
+public:
+    using RequestFn = typename UnaryCall<Request, Response>::RequestFn;
+    using BeginFn = bool (OrderBookServiceImpl::*)(const Request *, Response *, OrderCompletion &, uint32_t, uint64_t);
+    using FinishFn = void (OrderBookServiceImpl::*)(const OrderOutcome &, uint64_t, Response *);
+
+    MatchedCall(AsyncOrderBookServer &server, HybridService &service, OrderBookServiceImpl &impl, Queue &queue,
+                RequestFn request_fn, BeginFn begin, FinishFn finish)
+        : server_(server), service_(service), impl_(impl), queue_(queue),
+          request_fn_(request_fn), begin_(begin), finish_(finish),
+          completion_(this), ticket_(0), received_at_(0), state_(State::REQUESTED) {}
+
+    // Resets the call state in place and posts it for the next incoming call
+    void arm()
+    {
+        responder_.reset();
+        context_.emplace();
+        responder_.emplace(&*context_);
+        request_.Clear();
+        response_.Clear();
+        state_ = State::REQUESTED;
+
+        std::lock_guard<std::mutex> lock(queue_.mutex);
+        if (queue_.shut_down)
+        {
+            return;
+        }
+        (service_.*request_fn_)(&*context_, &request_, &*responder_, queue_.cq.get(), queue_.cq.get(), this);
+    }
+
+    void proceed(bool ok) override
+    {
+        if (state_ == State::FINISHING)
+        {
+            // Response sent (or the client went away): recycle for the next call
+            arm();
+            return;
+        }
+        if (!ok)
+        {
+            // The server is shutting down; the call is not re-posted
+            return;
+        }
+
+        received_at_ = CycleClock::now();
+        ticket_ = completion_.arm();
+        // Set before the command is queued: its answer may reach another
+        // poller before begin returns, and the call is not touched after
+        state_ = State::MATCHING;
+        server_.calls_matching_.fetch_add(1, std::memory_order_relaxed);
+        if ((impl_.*begin_)(&request_, &response_, completion_, ticket_, received_at_))
+        {
+            return;
+        }
+        server_.call_answered(); // answered without queueing anything
+        finish();
+    }
+
+    // Matching thread: the outcome is in completion_
+    void completed(OrderCompletion &) override
+    {
+        queue_.inbox->push(this);
+        server_.call_answered(); // last touch: the server may be torn down after it
+    }
+
+    void answered() override
+    {
+        OrderOutcome outcome;
+        completion_.take(ticket_, outcome); // published before the call reached the inbox
+        (impl_.*finish_)(outcome, received_at_, &response_);
+        finish();
+    }
+
+private:
+    enum class State
+    {
+        REQUESTED, // posted, waiting for a client
+        MATCHING,  // command queued, waiting for the matching thread
+        FINISHING  // response sent
+    };
+
+    AsyncOrderBookServer &server_;
+    HybridService &service_;
+    OrderBookServiceImpl &impl_;
+    Queue &queue_;
+    RequestFn request_fn_;
+    BeginFn begin_;
+    FinishFn finish_;
+
+    std::optional<grpc::ServerContext> context_;
+    std::optional<grpc::ServerAsyncResponseWriter<Response>> responder_;
+    Request request_;
+    Response response_;
+    OrderCompletion completion_;
+    uint32_t ticket_;
+    uint64_t received_at_;
+    State state_;
+
+    void finish()
+    {
+        state_ = State::FINISHING;
+        responder_->Finish(response_, grpc::Status::OK, this);
+    }
+};
+
+AsyncOrderBookServer::AsyncOrderBookServer(const std::string &server_address,
+                                           const ShardedEngineConfig &engine_config,
+                                           const AsyncServerConfig &config)
+    : server_address_(server_address),
+      config_(config),
+      impl_(engine_config),
+      service_(std::make_unique<HybridService>(impl_)),
+      shutting_down_(false),
+      calls_matching_(0)
+{
+    config_.completion_queues = config_.completion_queues > 0 ? config_.completion_queues : 1;
+    config_.pollers_per_queue = config_.pollers_per_queue > 0 ? config_.pollers_per_queue : 1;
+    config_.calls_per_method = config_.calls_per_method > 0 ? config_.calls_per_method : 1;
+}
+
+AsyncOrderBookServer::~AsyncOrderBookServer()
+{
+    shutdown(std::chrono::system_clock::now());
+
+    bool polled = !pollers_.empty();
+    join_pollers();
+    if (!polled)
+    {
+        // A queue must be drained before it is destroyed; normally the pollers do it
+        for (auto &queue : queues_)
+        {
+            void *tag;
+            bool ok;
+            while (queue->cq->Next(&tag, &ok))
+            {
+            }
+        }
+    }
+
+    // A poller may have queued a command after shutdown() waited; its call
+    // and queue must outlive the answer
+    wait_for_matching_calls();
+}
+
+bool AsyncOrderBookServer::start()
+{
+    grpc::ServerBuilder builder;
+    builder.AddListeningPort(server_address_, grpc::InsecureServerCredentials());
+    builder.RegisterService(service_.get());
+    builder.SetMaxReceiveMessageSize(4 * 1024 * 1024); // 4MB
+    builder.SetMaxSendMessageSize(4 * 1024 * 1024);    // 4MB
+
+    for (size_t i = 0; i < config_.completion_queues; ++i)
+    {
+        auto queue = std::make_unique<Queue>();
+        queue->cq = builder.AddCompletionQueue();
+        queues_.push_back(std::move(queue));
+    }
+
+    server_ = builder.BuildAndStart();
+    if (!server_)
+    {
+        return false;
+    }
+
+    for (auto &queue : queues_)
+    {
+        post_calls<MatchedCall<orderbook::SubmitOrderRequest, orderbook::SubmitOrderResponse>>(
+            *queue, &HybridService::RequestSubmitOrder, &OrderBookServiceImpl::beginSubmitOrder,
+            &OrderBookServiceImpl::finishSubmitOrder);
+        post_calls<MatchedCall<orderbook::CancelOrderRequest, orderbook::CancelOrderResponse>>(
+            *queue, &HybridService::RequestCancelOrder, &OrderBookServiceImpl::beginCancelOrder,
+            &OrderBookServiceImpl::finishCancelOrder);
+        post_calls<MatchedCall<orderbook::AmendOrderRequest, orderbook::AmendOrderResponse>>(
+            *queue, &HybridService::RequestAmendOrder, &OrderBookServiceImpl::beginAmendOrder,
+            &OrderBookServiceImpl::finishAmendOrder);
+        post_calls<UnaryCall<orderbook::GetBestBidRequest, orderbook::GetBestBidResponse>>(
+            *queue, &HybridService::RequestGetBestBid, &OrderBookServiceImpl::GetBestBid);
+        post_calls<UnaryCall<orderbook::GetBestAskRequest, orderbook::GetBestAskResponse>>(
+            *queue, &HybridService::RequestGetBestAsk, &OrderBookServiceImpl::GetBestAsk);
+        post_calls<UnaryCall<orderbook::GetDepthRequest, orderbook::GetDepthResponse>>(
+            *queue, &HybridService::RequestGetDepth, &OrderBookServiceImpl::GetDepth);
+        post_calls<UnaryCall<orderbook::GetOrdersAtPriceRequest, orderbook::GetOrdersAtPriceResponse>>(
+            *queue, &HybridService::RequestGetOrdersAtPrice, &OrderBookServiceImpl::GetOrdersAtPrice);
+        post_calls<UnaryCall<orderbook::HealthCheckRequest, orderbook::HealthCheckResponse>>(
+            *queue, &HybridService::RequestHealthCheck, &OrderBookServiceImpl::HealthCheck);
+        post_calls<UnaryCall<orderbook::GetPerformanceStatsRequest, orderbook::GetPerformanceStatsResponse>>(
+            *queue, &HybridService::RequestGetPerformanceStats, &OrderBookServiceImpl::GetPerformanceStats);
+    }
+
+    size_t poller_index = 0;
+    for (auto &queue : queues_)
+    {
+        for (size_t i = 0; i < config_.pollers_per_queue; ++i, ++poller_index)
+        {
+            int cpu = poller_index < config_.cpus.size() ? config_.cpus[poller_index] : -1;
+            pollers_.emplace_back(&AsyncOrderBookServer::poll, this, std::ref(*queue), cpu);
+        }
+    }
+    return true;
+}
+
+void AsyncOrderBookServer::wait()
+{
+    if (server_)
+    {
+        server_->Wait();
+    }
+    join_pollers();
+}
+
+void AsyncOrderBookServer::shutdown(std::chrono::system_clock::time_point deadline)
+{
+    if (shutting_down_.exchange(true))
+    {
+        return;
+    }
+
+    if (server_)
+    {
+        server_->Shutdown(deadline);
+    }
+
+    // Answered calls still finish on their queues, so every answer arrives
+    // before the queues are shut down
+    wait_for_matching_calls();
+
+    // Only after the server: calls may not be posted to a queue that is shut down
+    for (auto &queue : queues_)
+    {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        queue->shut_down = true;
+        queue->cq->Shutdown();
+    }
+}
+
+const AsyncServerConfig &AsyncOrderBookServer::get_config() const
+{
+    return config_;
+}
+
+template <typename Call, typename RequestFn, typename... HandlerFns>
+void AsyncOrderBookServer::post_calls(Queue &queue, RequestFn request_fn, HandlerFns... handlers)
+{
+    for (size_t i = 0; i < config_.calls_per_method; ++i)
+    {
+        auto call = std::make_unique<Call>(*this, *service_, impl_, queue, request_fn, handlers...);
+        call->arm();
+        calls_.push_back(std::move(call));
+    }
+}
+
+void AsyncOrderBookServer::poll(Queue &queue, int cpu)
+{
+    if (cpu >= 0 && !pin_current_thread(cpu))
+    {
+        std::cerr << "AsyncOrderBookServer: could not pin poller thread to CPU " << cpu << std::endl;
+    }
+
+    // Next() blocks, so idle pollers sleep rather than spin
+    void *tag;
+    bool ok;
+    while (queue.cq->Next(&tag, &ok))
+    {
+        static_cast<CallBase *>(tag)->proceed(ok);
+    }
+}
+
+void AsyncOrderBookServer::join_pollers()
+{
+    for (auto &poller : pollers_)
+    {
+        if (poller.joinable())
+        {
+            poller.join();
+        }
+    }
+    pollers_.clear();
+}
+
+void AsyncOrderBookServer::call_answered()
+{
+    // Only a shutdown waits for the count, so the common case takes no lock
+    if (calls_matching_.fetch_sub(1) == 1 && shutting_down_.load())
+    {
+        std::lock_guard<std::mutex> lock(matching_mutex_);
+        matching_done_.notify_all();
+    }
+}
+
+void AsyncOrderBookServer::wait_for_matching_calls()
+{
+    // shutting_down_ is set first, so the answer that empties the count sees it and notifies
+    std::unique_lock<std::mutex> lock(matching_mutex_);
+    matching_done_.wait(lock, [this] { return calls_matching_.load() == 0; });
+}
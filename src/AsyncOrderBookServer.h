@@ -0,0 +1,103 @@
+#pragma once
+
+#include "OrderBookServiceImpl.h"
+#include <grpc++/grpc++.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct AsyncServerConfig
+{
+    // Completion queues, each drained by its own poller threads
+    size_t completion_queues = 1;
+    // Threads polling each completion queue
+    size_t pollers_per_queue = 1;
+    // CPU for each poller thread in creation order; empty leaves them unpinned
+    std::vector<int> cpus;
+    // Call objects kept posted per unary method on each queue; bounds how many
+    // calls of one method a queue can have accepted at once
+    size_t calls_per_method = 64;
+};
+
+// Serves the unary RPCs from gRPC completion queues, so a fixed set of poller
+// threads handles any number of in-flight calls. Per-call state (context,
+// messages, responder) lives in call objects that are re-posted once their
+// call finishes instead of being allocated per request. Handlers that only
+// enqueue or read counters answer on the pollers. Calls that report a
+// matching result (cancels, amends, submits with wait_for_result) queue their
+// command and return the poller to the queue; the matching thread's
+// completion hands the call back through its queue's inbox and a poller
+// sends the response, so no thread waits on matching. The streaming RPCs keep
+// their synchronous handlers: each one holds a thread for the life of the
+// stream either way.
+class AsyncOrderBookServer
+{
+public:
+    AsyncOrderBookServer(const std::string &server_address,
+                         const ShardedEngineConfig &engine_config,
+                         const AsyncServerConfig &config = AsyncServerConfig());
+    ~AsyncOrderBookServer();
+
+    AsyncOrderBookServer(const AsyncOrderBookServer &) = delete;
+    AsyncOrderBookServer &operator=(const AsyncOrderBookServer &) = delete;
+
+    // Binds the port, posts the call objects and starts the pollers.
+    // Returns false if the server could not be started.
+    bool start();
+
+    // Blocks until shutdown() has been called and the pollers have drained
+    void wait();
+
+    // Stops accepting calls; in-flight calls get until the deadline to finish
+    void shutdown(std::chrono::system_clock::time_point deadline);
+
+    const AsyncServerConfig &get_config() const;
+
+private:
+    class HybridService;
+    class CallBase;
+    class Inbox;
+    template <typename Request, typename Response>
+    class UnaryCall;
+    template <typename Request, typename Response>
+    class MatchedCall;
+
+    struct Queue
+    {
+        Queue();
+        ~Queue();
+
+        std::unique_ptr<grpc::ServerCompletionQueue> cq;
+        std::mutex mutex; // orders re-posting calls and waking the inbox against shutting the queue down
+        bool shut_down = false;
+        std::unique_ptr<Inbox> inbox; // calls the matching threads have answered
+    };
+
+    std::string server_address_;
+    AsyncServerConfig config_;
+    OrderBookServiceImpl impl_;
+    std::unique_ptr<HybridService> service_;
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::unique_ptr<CallBase>> calls_;
+    std::unique_ptr<grpc::Server> server_;
+    std::vector<std::thread> pollers_;
+    std::atomic<bool> shutting_down_;
+
+    // Calls whose command a matching thread has yet to answer. The answer
+    // touches the call and its queue, so shutdown waits for the count to drain.
+    std::atomic<size_t> calls_matching_;
+    std::mutex matching_mutex_;
+    std::condition_variable matching_done_;
+
+    template <typename Call, typename RequestFn, typename... HandlerFns>
+    void post_calls(Queue &queue, RequestFn request_fn, HandlerFns... handlers);
+    void poll(Queue &queue, int cpu);
+    void join_pollers();
+    void call_answered();
+    void wait_for_matching_calls();
+};
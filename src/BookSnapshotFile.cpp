@@ -0,0 +1,239 @@
+#include "BookSnapshotFile.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    constexpr char kMagic[8] = {'O', 'B', 'S', 'N', 'A', 'P', '0', '5'};
+    constexpr uint32_t kVersion = 5;
+
+    // Word-at-a-time FNV-style hash; every table is a whole number of words
+    uint64_t table_checksum(const char *data, size_t bytes)
+    {
+        uint64_t hash = 14695981039346656037ull;
+        for (size_t i = 0; i + sizeof(uint64_t) <= bytes; i += sizeof(uint64_t))
+        {
+            uint64_t word;
+            std::memcpy(&word, data + i, sizeof(word));
+            hash = (hash ^ word) * 1099511628211ull;
+        }
+        return hash;
+    }
+
+    size_t file_size(const SnapshotFileHeader &header)
+    {
+        return sizeof(SnapshotFileHeader) +
+               header.book_count * sizeof(SnapshotBook) +
+               header.level_count * sizeof(SnapshotLevel) +
+               header.order_count * sizeof(SnapshotOrder);
+    }
+}
+
+bool write_book_snapshot(const std::string &path, uint64_t journal_sequence,
+                         const std::vector<std::pair<SymbolId, const OrderBook *>> &books)
+{
+    SnapshotFileHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.header_size = sizeof(SnapshotFileHeader);
+    header.journal_sequence = journal_sequence;
+    header.book_count = books.size();
+    for (const auto &entry : books)
+    {
+        header.level_count += entry.second->level_count(OrderSide::BUY) + entry.second->level_count(OrderSide::SELL);
+        header.order_count += entry.second->order_count();
+    }
+    const size_t bytes = file_size(header);
+
+    // Sized up front and filled through a mapping: no per-record write calls
+    std::string temp_path = path + ".tmp";
+    int fd = ::open(temp_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        return false;
+    }
+    void *map = ::ftruncate(fd, bytes) == 0 ? ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+    if (map == MAP_FAILED)
+    {
+        ::close(fd);
+        std::remove(temp_path.c_str());
+        return false;
+    }
+
+    char *base = static_cast<char *>(map);
+    SnapshotBook *book_table = reinterpret_cast<SnapshotBook *>(base + sizeof(SnapshotFileHeader));
+    SnapshotLevel *level_table = reinterpret_cast<SnapshotLevel *>(book_table + header.book_count);
+    SnapshotOrder *order_table = reinterpret_cast<SnapshotOrder *>(level_table + header.level_count);
+
+    uint64_t level_index = 0;
+    uint64_t order_index = 0;
+    for (size_t b = 0; b < books.size(); ++b)
+    {
+        const OrderBook &book = *books[b].second;
+        SnapshotBook &entry = book_table[b];
+        entry = SnapshotBook{};
+        entry.symbol_id = books[b].first;
+        entry.bid_levels = static_cast<uint32_t>(book.level_count(OrderSide::BUY));
+        entry.ask_levels = static_cast<uint32_t>(book.level_count(OrderSide::SELL));
+        entry.first_level = level_index;
+        entry.first_order = order_index;
+        entry.max_price_levels = book.get_max_levels_per_side();
+        entry.tick_size = book.get_tick_size();
+
+        auto write_level = [&](Tick tick, const PriceLevel &level)
+        {
+            SnapshotLevel &out = level_table[level_index++];
+            out = SnapshotLevel{};
+            out.tick = tick;
+            out.total_quantity = level.total_quantity;
+            out.first_order = order_index;
+            for (const OrderNode *node = level.head; node; node = node->next)
+            {
+                SnapshotOrder &order = order_table[order_index++];
+                order = SnapshotOrder{};
+                order.order_id = node->order.id;
+                order.timestamp_ns = node->order.timestamp_ns;
+                order.quantity = node->order.quantity;
+                order.strategy = static_cast<uint8_t>(node->order.strategy);
+                order.type = static_cast<uint8_t>(node->order.type);
+                ++out.order_count;
+            }
+        };
+        book.for_each_level(OrderSide::BUY, write_level);
+        book.for_each_level(OrderSide::SELL, write_level);
+    }
+
+    header.checksum = table_checksum(base + sizeof(SnapshotFileHeader), bytes - sizeof(SnapshotFileHeader));
+    std::memcpy(base, &header, sizeof(header));
+
+    bool ok = ::msync(map, bytes, MS_SYNC) == 0;
+    ::munmap(map, bytes);
+    ok = ::close(fd) == 0 && ok;
+    if (!ok || std::rename(temp_path.c_str(), path.c_str()) != 0)
+    {
+        std::remove(temp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+MappedBookSnapshot::MappedBookSnapshot(const std::string &path)
+    : fd_(-1),
+      map_(nullptr),
+      map_bytes_(0),
+      header_(nullptr)
+{
+    fd_ = ::open(path.c_str(), O_RDONLY);
+    if (fd_ < 0)
+    {
+        throw std::runtime_error("Snapshot " + path + ": cannot open (" + std::strerror(errno) + ")");
+    }
+
+    struct stat st;
+    if (::fstat(fd_, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(SnapshotFileHeader)))
+    {
+        ::close(fd_);
+        throw std::runtime_error("Snapshot " + path + ": not a snapshot file");
+    }
+
+    void *map = ::mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd_, 0);
+    if (map == MAP_FAILED)
+    {
+        ::close(fd_);
+        throw std::runtime_error("Snapshot " + path + ": cannot map (" + std::strerror(errno) + ")");
+    }
+    map_ = static_cast<const char *>(map);
+    map_bytes_ = st.st_size;
+    header_ = reinterpret_cast<const SnapshotFileHeader *>(map_);
+
+    bool ok = std::memcmp(header_->magic, kMagic, sizeof(kMagic)) == 0 &&
+              header_->version == kVersion &&
+              header_->header_size == sizeof(SnapshotFileHeader) &&
+              file_size(*header_) == map_bytes_;
+    if (!ok)
+    {
+        ::munmap(const_cast<char *>(map_), map_bytes_);
+        ::close(fd_);
+        throw std::runtime_error("Snapshot " + path + ": not a version " + std::to_string(kVersion) + " snapshot or truncated");
+    }
+}
+
+MappedBookSnapshot::~MappedBookSnapshot()
+{
+    ::munmap(const_cast<char *>(map_), map_bytes_);
+    ::close(fd_);
+}
+
+uint64_t MappedBookSnapshot::journal_sequence() const
+{
+    return header_->journal_sequence;
+}
+
+size_t MappedBookSnapshot::book_count() const
+{
+    return header_->book_count;
+}
+
+size_t MappedBookSnapshot::level_count() const
+{
+    return header_->level_count;
+}
+
+size_t MappedBookSnapshot::order_count() const
+{
+    return header_->order_count;
+}
+
+const SnapshotBook *MappedBookSnapshot::books() const
+{
+    return reinterpret_cast<const SnapshotBook *>(map_ + sizeof(SnapshotFileHeader));
+}
+
+const SnapshotLevel *MappedBookSnapshot::levels() const
+{
+    return reinterpret_cast<const SnapshotLevel *>(books() + header_->book_count);
+}
+
+const SnapshotOrder *MappedBookSnapshot::orders() const
+{
+    return reinterpret_cast<const SnapshotOrder *>(levels() + header_->level_count);
+}
+
+bool MappedBookSnapshot::verify() const
+{
+    return table_checksum(map_ + sizeof(SnapshotFileHeader), map_bytes_ - sizeof(SnapshotFileHeader)) == header_->checksum;
+}
+
+bool MappedBookSnapshot::restore(const SnapshotBook &entry, OrderBook &book) const
+{
+    const SnapshotLevel *level = levels() + entry.first_level;
+    const uint64_t level_count = static_cast<uint64_t>(entry.bid_levels) + entry.ask_levels;
+    for (uint64_t i = 0; i < level_count; ++i, ++level)
+    {
+        OrderSide side = i < entry.bid_levels ? OrderSide::BUY : OrderSide::SELL;
+        double price = book.tick_to_price(level->tick);
+        const SnapshotOrder *order = orders() + level->first_order;
+        for (uint32_t j = 0; j < level->order_count; ++j, ++order)
+        {
+            Order resting(order->order_id, static_cast<Strategy>(order->strategy), order->quantity, price, side,
+                          static_cast<OrderType>(order->type), entry.symbol_id,
+                          std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                              std::chrono::nanoseconds(order->timestamp_ns))));
+            if (!book.add_order(resting))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,112 @@
+#include "DepthView.h"
+
+#include <cstring>
+
+DepthView::DepthView(size_t levels)
+    : levels_(levels),
+      next_(0),
+      published_(0)
+{
+    const size_t words = kHeaderWords + 2 * levels_ * kLevelWords;
+    for (Buffer &buffer : buffers_)
+    {
+        buffer.version.store(0, std::memory_order_relaxed);
+        buffer.words.reset(new std::atomic<uint64_t>[words]);
+        for (size_t i = 0; i < words; ++i)
+        {
+            buffer.words[i].store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+size_t DepthView::levels() const
+{
+    return levels_;
+}
+
+void DepthView::write_side(Buffer &buffer, size_t first_word, OrderSide side, const OrderBook &book, uint64_t &count)
+{
+    count = 0;
+    book.for_each_level(side, [&](Tick tick, const PriceLevel &level)
+                        {
+        double price = book.tick_to_price(tick);
+        uint64_t price_bits;
+        std::memcpy(&price_bits, &price, sizeof(price_bits));
+        size_t word = first_word + count * kLevelWords;
+        buffer.words[word].store(price_bits, std::memory_order_relaxed);
+        buffer.words[word + 1].store(static_cast<uint64_t>(level.total_quantity), std::memory_order_relaxed);
+        buffer.words[word + 2].store(level.order_count, std::memory_order_relaxed);
+        ++count; }, levels_);
+}
+
+void DepthView::publish(uint64_t sequence, const OrderBook &book)
+{
+    // Readers are pointed at the other buffer until published_ moves
+    uint64_t version = ++next_;
+    Buffer &buffer = buffers_[version & 1];
+
+    buffer.version.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    uint64_t bid_count = 0;
+    uint64_t ask_count = 0;
+    if (levels_ > 0)
+    {
+        write_side(buffer, kHeaderWords, OrderSide::BUY, book, bid_count);
+        write_side(buffer, kHeaderWords + levels_ * kLevelWords, OrderSide::SELL, book, ask_count);
+    }
+    buffer.words[0].store(sequence, std::memory_order_relaxed);
+    buffer.words[1].store(bid_count, std::memory_order_relaxed);
+    buffer.words[2].store(ask_count, std::memory_order_relaxed);
+
+    buffer.version.store(version, std::memory_order_release);
+    published_.store(version, std::memory_order_release);
+}
+
+bool DepthView::read(size_t max_levels, DepthSnapshot &out) const
+{
+    for (;;)
+    {
+        uint64_t version = published_.load(std::memory_order_acquire);
+        if (version == 0)
+        {
+            return false;
+        }
+        const Buffer &buffer = buffers_[version & 1];
+        if (buffer.version.load(std::memory_order_acquire) != version)
+        {
+            continue; // the writer already moved on to this buffer
+        }
+
+        out.sequence = buffer.words[0].load(std::memory_order_relaxed);
+        uint64_t counts[2] = {buffer.words[1].load(std::memory_order_relaxed),
+                              buffer.words[2].load(std::memory_order_relaxed)};
+        std::vector<DepthLevel> *sides[2] = {&out.bids, &out.asks};
+        for (size_t s = 0; s < 2; ++s)
+        {
+            // A torn count is caught by the version check below; clamp so it cannot overrun
+            size_t count = counts[s] < levels_ ? static_cast<size_t>(counts[s]) : levels_;
+            if (max_levels > 0 && count > max_levels)
+            {
+                count = max_levels;
+            }
+            sides[s]->resize(count);
+            size_t word = kHeaderWords + s * levels_ * kLevelWords;
+            for (size_t i = 0; i < count; ++i, word += kLevelWords)
+            {
+                uint64_t price_bits = buffer.words[word].load(std::memory_order_relaxed);
+                DepthLevel &level = (*sides[s])[i];
+                std::memcpy(&level.price, &price_bits, sizeof(price_bits));
+                level.quantity = static_cast<int64_t>(buffer.words[word + 1].load(std::memory_order_relaxed));
+                level.order_count = static_cast<uint32_t>(buffer.words[word + 2].load(std::memory_order_relaxed));
+                level.reserved = 0;
+            }
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (buffer.version.load(std::memory_order_relaxed) == version)
+        {
+            return true;
+        }
+    }
+}
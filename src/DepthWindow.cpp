@@ -0,0 +1,137 @@
+#include "DepthWindow.h"
+
+DepthWindow::DepthWindow(size_t depth)
+    : depth_(depth)
+{
+}
+
+size_t DepthWindow::depth() const
+{
+    return depth_;
+}
+
+void DepthWindow::reset(const BookSnapshot &snapshot)
+{
+    for (Side *side : {&bids_, &asks_})
+    {
+        side->levels.clear();
+        side->sent.clear();
+        side->dirty.clear();
+    }
+    for (const LevelQuantity &level : snapshot.bids)
+    {
+        bids_.levels[level.price] = level.quantity;
+    }
+    for (const LevelQuantity &level : snapshot.asks)
+    {
+        asks_.levels[level.price] = level.quantity;
+    }
+}
+
+void DepthWindow::apply(const LevelUpdate &update)
+{
+    Side &side = update.side == OrderSide::BUY ? bids_ : asks_;
+    if (update.quantity > 0)
+    {
+        side.levels[update.price] = update.quantity;
+    }
+    else
+    {
+        side.levels.erase(update.price);
+    }
+    if (depth_ == 0)
+    {
+        side.dirty.push_back(LevelQuantity{update.price, update.quantity});
+    }
+}
+
+void DepthWindow::window(std::vector<LevelQuantity> &bids, std::vector<LevelQuantity> &asks)
+{
+    top(bids_, true, bids);
+    top(asks_, false, asks);
+    bids_.sent = bids;
+    asks_.sent = asks;
+    bids_.dirty.clear();
+    asks_.dirty.clear();
+}
+
+bool DepthWindow::changes(std::vector<LevelQuantity> &bids, std::vector<LevelQuantity> &asks)
+{
+    bids.clear();
+    asks.clear();
+    if (depth_ == 0)
+    {
+        // The window is the whole book: every update is a change
+        bids.swap(bids_.dirty);
+        asks.swap(asks_.dirty);
+    }
+    else
+    {
+        diff(bids_, true, bids);
+        diff(asks_, false, asks);
+    }
+    return !bids.empty() || !asks.empty();
+}
+
+void DepthWindow::top(const Side &side, bool descending, std::vector<LevelQuantity> &out) const
+{
+    out.clear();
+    const size_t limit = depth_ == 0 ? side.levels.size() : depth_;
+    auto take = [&](const std::pair<const double, int64_t> &level)
+    {
+        out.push_back(LevelQuantity{level.first, level.second});
+        return out.size() < limit;
+    };
+    if (descending)
+    {
+        for (auto it = side.levels.rbegin(); it != side.levels.rend() && take(*it); ++it)
+        {
+        }
+    }
+    else
+    {
+        for (auto it = side.levels.begin(); it != side.levels.end() && take(*it); ++it)
+        {
+        }
+    }
+}
+
+void DepthWindow::diff(Side &side, bool descending, std::vector<LevelQuantity> &out) const
+{
+    // Both windows hold at most depth_ levels, so a linear scan is cheapest
+    std::vector<LevelQuantity> now;
+    top(side, descending, now);
+    for (const LevelQuantity &level : now)
+    {
+        bool unchanged = false;
+        for (const LevelQuantity &sent : side.sent)
+        {
+            if (sent.price == level.price)
+            {
+                unchanged = sent.quantity == level.quantity;
+                break;
+            }
+        }
+        if (!unchanged)
+        {
+            out.push_back(level);
+        }
+    }
+    for (const LevelQuantity &sent : side.sent)
+    {
+        bool kept = false;
+        for (const LevelQuantity &level : now)
+        {
+            if (level.price == sent.price)
+            {
+                kept = true;
+                break;
+            }
+        }
+        if (!kept)
+        {
+            out.push_back(LevelQuantity{sent.price, 0});
+        }
+    }
+    side.sent.swap(now);
+}
@@ -0,0 +1,404 @@
+#include "Journal.h"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    constexpr char kMagic[8] = {'O', 'B', 'J', 'R', 'N', 'L', '0', '1'};
+    constexpr uint32_t kVersion = 1;
+    constexpr size_t kRecordSize = sizeof(JournalRecord);
+
+    // Occupies the slot in front of record 1, so record n sits at n * kRecordSize
+    struct JournalFileHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t record_size;
+        uint32_t shard_count; // 0 in logs written before the layout was recorded
+        uint32_t shard_index;
+        uint64_t max_price_levels; // 0 in logs written before the band was recorded
+        uint64_t tick_size_digest; // TickSizes::digest(); 0 in logs written before it was recorded
+        char reserved[24];
+    };
+
+    static_assert(sizeof(JournalFileHeader) == kRecordSize, "Journal header fills one record slot");
+
+    std::runtime_error journal_error(const std::string &what, const std::string &path)
+    {
+        return std::runtime_error("Journal " + path + ": " + what + " (" + std::strerror(errno) + ")");
+    }
+
+    bool valid_header(const char *map)
+    {
+        const JournalFileHeader *header = reinterpret_cast<const JournalFileHeader *>(map);
+        return std::memcmp(header->magic, kMagic, sizeof(kMagic)) == 0 &&
+               header->version == kVersion &&
+               header->record_size == kRecordSize;
+    }
+
+    const JournalFileHeader &header_of(const char *map)
+    {
+        return *reinterpret_cast<const JournalFileHeader *>(map);
+    }
+
+    void check_layout(uint32_t written_count, uint32_t written_index, uint32_t shard_count, uint32_t shard_index,
+                      const std::string &path)
+    {
+        if (written_count != 0 && (written_count != shard_count || written_index != shard_index))
+        {
+            throw std::runtime_error("Journal " + path + ": written as shard " + std::to_string(written_index) +
+                                     " of " + std::to_string(written_count) + ", opened as shard " +
+                                     std::to_string(shard_index) + " of " + std::to_string(shard_count));
+        }
+    }
+
+    void check_price_band(uint64_t written_levels, uint64_t max_price_levels, const std::string &path)
+    {
+        if (written_levels != 0 && written_levels != max_price_levels)
+        {
+            throw std::runtime_error("Journal " + path + ": written for books of " + std::to_string(written_levels) +
+                                     " price levels, opened for " + std::to_string(max_price_levels));
+        }
+    }
+
+    void check_tick_sizes(uint64_t written_digest, uint64_t tick_size_digest, const std::string &path)
+    {
+        if (written_digest != 0 && written_digest != tick_size_digest)
+        {
+            throw std::runtime_error("Journal " + path + ": written for books with other tick sizes");
+        }
+    }
+
+    bool valid_record(const JournalRecord &record, uint64_t sequence)
+    {
+        return record.sequence == sequence && record.checksum == journal_checksum(record);
+    }
+}
+
+uint32_t journal_checksum(const JournalRecord &record)
+{
+    // FNV-1a; catches a record torn by a crash mid-write, not tampering
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(&record);
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < offsetof(JournalRecord, checksum); ++i)
+    {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+void check_journal_layout(const std::string &path, uint32_t shard_count, uint32_t shard_index,
+                          uint64_t max_price_levels, uint64_t tick_size_digest)
+{
+    struct stat st;
+    if (::stat(path.c_str(), &st) != 0)
+    {
+        return;
+    }
+    JournalReader reader(path);
+    check_layout(reader.shard_count(), reader.shard_index(), shard_count, shard_index, path);
+    check_price_band(reader.max_price_levels(), max_price_levels, path);
+    check_tick_sizes(reader.tick_size_digest(), tick_size_digest, path);
+}
+
+JournalWriter::JournalWriter(const std::string &path, size_t initial_records, uint32_t shard_count,
+                             uint32_t shard_index, uint64_t max_price_levels, uint64_t tick_size_digest)
+    : path_(path),
+      fd_(-1),
+      map_(nullptr),
+      capacity_(0),
+      next_sequence_(1),
+      synced_sequence_(0)
+{
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd_ < 0)
+    {
+        throw journal_error("cannot open", path);
+    }
+
+    struct stat st;
+    if (::fstat(fd_, &st) != 0)
+    {
+        ::close(fd_);
+        throw journal_error("cannot stat", path);
+    }
+
+    size_t existing = st.st_size > static_cast<off_t>(kRecordSize) ? st.st_size / kRecordSize - 1 : 0;
+    try
+    {
+        map(existing > initial_records ? existing : (initial_records > 0 ? initial_records : 1));
+    }
+    catch (...)
+    {
+        ::close(fd_);
+        throw;
+    }
+
+    if (st.st_size == 0)
+    {
+        JournalFileHeader header{};
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kVersion;
+        header.record_size = kRecordSize;
+        header.shard_count = shard_count;
+        header.shard_index = shard_index;
+        header.max_price_levels = max_price_levels;
+        header.tick_size_digest = tick_size_digest;
+        std::memcpy(map_, &header, sizeof(header));
+    }
+    else
+    {
+        try
+        {
+            if (!valid_header(map_))
+            {
+                throw std::runtime_error("Journal " + path + ": not a journal file");
+            }
+            check_layout(header_of(map_).shard_count, header_of(map_).shard_index, shard_count, shard_index, path);
+            check_price_band(header_of(map_).max_price_levels, max_price_levels, path);
+            check_tick_sizes(header_of(map_).tick_size_digest, tick_size_digest, path);
+        }
+        catch (...)
+        {
+            unmap();
+            ::close(fd_);
+            throw;
+        }
+        // An older log takes the layout, band and tick sizes it is now opened with
+        JournalFileHeader *header = reinterpret_cast<JournalFileHeader *>(map_);
+        header->shard_count = shard_count;
+        header->shard_index = shard_index;
+        header->max_price_levels = max_price_levels;
+        header->tick_size_digest = tick_size_digest;
+    }
+
+    // Continue after the last record that made it to the file intact
+    while (next_sequence_ <= capacity_ && valid_record(*slot(next_sequence_), next_sequence_))
+    {
+        ++next_sequence_;
+    }
+    synced_sequence_ = next_sequence_ - 1;
+}
+
+JournalWriter::~JournalWriter()
+{
+    sync();
+    unmap();
+    ::close(fd_);
+}
+
+uint64_t JournalWriter::append(JournalRecord &record)
+{
+    if (next_sequence_ > capacity_)
+    {
+        // Out of pre-allocated room: flush what is mapped, then double the file
+        sync();
+        unmap();
+        map(capacity_ * 2);
+    }
+
+    record.sequence = next_sequence_;
+    record.checksum = journal_checksum(record);
+    std::memcpy(slot(next_sequence_), &record, sizeof(record));
+    return next_sequence_++;
+}
+
+bool JournalWriter::sync()
+{
+    uint64_t last = next_sequence_ - 1;
+    if (last == synced_sequence_)
+    {
+        return true;
+    }
+    if (!map_)
+    {
+        return false; // a failed grow left nothing mapped
+    }
+
+    // msync needs a page-aligned start; the range covers only unsynced records
+    static const size_t page_size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    size_t begin = (synced_sequence_ + 1) * kRecordSize;
+    size_t end = (last + 1) * kRecordSize;
+    begin -= begin % page_size;
+    if (::msync(map_ + begin, end - begin, MS_SYNC) != 0)
+    {
+        return false;
+    }
+    synced_sequence_ = last;
+    return true;
+}
+
+bool JournalWriter::discard_after(uint64_t sequence)
+{
+    // A zero sequence field fails the reader's check, which ends the log there
+    const uint64_t zero = 0;
+    bool written = true;
+    for (uint64_t discarded = sequence + 1; discarded < next_sequence_; ++discarded)
+    {
+        const off_t offset = static_cast<off_t>(discarded * kRecordSize + offsetof(JournalRecord, sequence));
+        written = ::pwrite(fd_, &zero, sizeof(zero), offset) == static_cast<ssize_t>(sizeof(zero)) && written;
+    }
+    written = ::fdatasync(fd_) == 0 && written;
+    next_sequence_ = sequence + 1;
+    if (synced_sequence_ > sequence)
+    {
+        synced_sequence_ = sequence;
+    }
+    return written;
+}
+
+uint64_t JournalWriter::last_sequence() const
+{
+    return next_sequence_ - 1;
+}
+
+uint64_t JournalWriter::synced_sequence() const
+{
+    return synced_sequence_;
+}
+
+size_t JournalWriter::capacity() const
+{
+    return capacity_;
+}
+
+void JournalWriter::map(size_t records)
+{
+    size_t bytes = (records + 1) * kRecordSize;
+
+    // Reserve the blocks up front so a full disk fails here, not as SIGBUS on a store
+#ifdef __linux__
+    int err = ::posix_fallocate(fd_, 0, bytes);
+    if (err != 0)
+    {
+        errno = err;
+        throw journal_error("cannot allocate " + std::to_string(bytes) + " bytes", path_);
+    }
+#else
+    if (::ftruncate(fd_, bytes) != 0)
+    {
+        throw journal_error("cannot grow to " + std::to_string(bytes) + " bytes", path_);
+    }
+#endif
+
+    void *map = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (map == MAP_FAILED)
+    {
+        throw journal_error("cannot map", path_);
+    }
+    map_ = static_cast<char *>(map);
+    capacity_ = records;
+}
+
+void JournalWriter::unmap()
+{
+    if (map_)
+    {
+        ::munmap(map_, (capacity_ + 1) * kRecordSize);
+        map_ = nullptr;
+    }
+}
+
+JournalRecord *JournalWriter::slot(uint64_t sequence) const
+{
+    return reinterpret_cast<JournalRecord *>(map_ + sequence * kRecordSize);
+}
+
+JournalReader::JournalReader(const std::string &path)
+    : fd_(-1),
+      map_(nullptr),
+      map_bytes_(0),
+      capacity_(0),
+      last_sequence_(0)
+{
+    fd_ = ::open(path.c_str(), O_RDONLY);
+    if (fd_ < 0)
+    {
+        throw journal_error("cannot open", path);
+    }
+
+    struct stat st;
+    if (::fstat(fd_, &st) != 0 || st.st_size < static_cast<off_t>(kRecordSize))
+    {
+        ::close(fd_);
+        throw std::runtime_error("Journal " + path + ": not a journal file");
+    }
+
+    void *map = ::mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd_, 0);
+    if (map == MAP_FAILED)
+    {
+        ::close(fd_);
+        throw journal_error("cannot map", path);
+    }
+    map_ = static_cast<const char *>(map);
+    map_bytes_ = st.st_size;
+    capacity_ = st.st_size / kRecordSize - 1;
+
+    if (!valid_header(map_))
+    {
+        ::munmap(const_cast<char *>(map_), map_bytes_);
+        ::close(fd_);
+        throw std::runtime_error("Journal " + path + ": not a journal file");
+    }
+}
+
+JournalReader::~JournalReader()
+{
+    ::munmap(const_cast<char *>(map_), map_bytes_);
+    ::close(fd_);
+}
+
+bool JournalReader::next(JournalRecord &record)
+{
+    uint64_t sequence = last_sequence_ + 1;
+    if (sequence > capacity_)
+    {
+        return false;
+    }
+
+    std::memcpy(&record, map_ + sequence * kRecordSize, sizeof(record));
+    if (!valid_record(record, sequence))
+    {
+        return false;
+    }
+    last_sequence_ = sequence;
+    return true;
+}
+
+void JournalReader::skip_to(uint64_t sequence)
+{
+    last_sequence_ = sequence;
+}
+
+uint64_t JournalReader::last_sequence() const
+{
+    return last_sequence_;
+}
+
+uint32_t JournalReader::shard_count() const
+{
+    return header_of(map_).shard_count;
+}
+
+uint32_t JournalReader::shard_index() const
+{
+    return header_of(map_).shard_index;
+}
+
+uint64_t JournalReader::max_price_levels() const
+{
+    return header_of(map_).max_price_levels;
+}
+
+uint64_t JournalReader::tick_size_digest() const
+{
+    return header_of(map_).tick_size_digest;
+}
@@ -0,0 +1,137 @@
+#include "LatencyHistogram.h"
+#include "CycleClock.h"
+
+#include <algorithm>
+#include <cmath>
+
+LatencyHistogram::LatencyHistogram()
+    : counts_(new std::atomic<uint64_t>[kBucketCount]),
+      total_(0),
+      max_(0)
+{
+    for (size_t i = 0; i < kBucketCount; ++i)
+    {
+        counts_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+size_t LatencyHistogram::index_for(uint64_t value)
+{
+    const uint64_t limit = (1ull << kMaxValueBits) - 1;
+    value = std::min(value, limit);
+    if (value < kSubBucketCount)
+    {
+        return static_cast<size_t>(value);
+    }
+    // Bucket k holds [64 << k, 128 << k) in 64 steps of 1 << k
+    unsigned k = 63 - static_cast<unsigned>(__builtin_clzll(value)) - (kSubBucketBits - 1);
+    return static_cast<size_t>(k * kSubBucketHalf + (value >> k));
+}
+
+uint64_t LatencyHistogram::highest_value_at(size_t index)
+{
+    if (index < kSubBucketCount)
+    {
+        return index;
+    }
+    uint64_t k = index / kSubBucketHalf - 1;
+    uint64_t sub = index - k * kSubBucketHalf;
+    return ((sub + 1) << k) - 1;
+}
+
+void LatencyHistogram::record(uint64_t nanoseconds)
+{
+    std::atomic<uint64_t> &bucket = counts_[index_for(nanoseconds)];
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    total_.store(total_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if (nanoseconds > max_.load(std::memory_order_relaxed))
+    {
+        max_.store(nanoseconds, std::memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other)
+{
+    uint64_t added = 0;
+    for (size_t i = 0; i < kBucketCount; ++i)
+    {
+        uint64_t count = other.counts_[i].load(std::memory_order_relaxed);
+        if (count > 0)
+        {
+            counts_[i].store(counts_[i].load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+            added += count;
+        }
+    }
+    // Summed from the buckets actually copied, so percentiles stay consistent
+    // even if other was recorded into while we read it
+    total_.store(total_.load(std::memory_order_relaxed) + added, std::memory_order_relaxed);
+    max_.store(std::max(max_.load(std::memory_order_relaxed), other.max()), std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::count() const
+{
+    return total_.load(std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::max() const
+{
+    return max_.load(std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::percentile(double fraction) const
+{
+    uint64_t total = count();
+    if (total == 0)
+    {
+        return 0;
+    }
+    fraction = std::min(std::max(fraction, 0.0), 1.0);
+    uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(total))));
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBucketCount; ++i)
+    {
+        seen += counts_[i].load(std::memory_order_relaxed);
+        if (seen >= rank)
+        {
+            return std::min(highest_value_at(i), max());
+        }
+    }
+    return max();
+}
+
+const char *latency_stage_name(LatencyStage stage)
+{
+    switch (stage)
+    {
+    case LatencyStage::ENQUEUED:
+        return "enqueued";
+    case LatencyStage::DEQUEUED:
+        return "dequeued";
+    case LatencyStage::MATCHED:
+        return "matched";
+    case LatencyStage::ACKED:
+        return "acked";
+    }
+    return "unknown";
+}
+
+LatencyRecorder::LatencyRecorder()
+{
+    // Calibrate now rather than on the first recorded order
+    CycleClock::nanoseconds_per_tick();
+}
+
+LatencyRecorder::~LatencyRecorder() = default;
+
+void LatencyRecorder::record(LatencyStage stage, uint64_t received, uint64_t now)
+{
+    uint64_t ticks = now > received ? now - received : 0;
+    threads_.local().stages[static_cast<size_t>(stage)].record(CycleClock::to_nanoseconds(ticks));
+}
+
+void LatencyRecorder::merge_stage(LatencyStage stage, LatencyHistogram &into) const
+{
+    threads_.for_each([&](const ThreadHistograms &histograms)
+                      { into.merge(histograms.stages[static_cast<size_t>(stage)]); });
+}
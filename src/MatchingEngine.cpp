@@ -1,61 +1,882 @@
 #include "MatchingEngine.h"
-#include <chrono>
+#include "CycleClock.h"
+#include "OrderIdAllocator.h"
+#include "ThreadAffinity.h"
 
-MatchingEngine::MatchingEngine()
-    : order_queue_(1024), // Initialize with capacity of 1024 (power of 2)
-      stop_matching_engine_(false)
+#include <iostream>
+#include <stdexcept>
+
+MatchingEngine::MatchingEngine(const MatchingEngineConfig &config)
+    : order_queue_(config.queue_capacity, config.single_producer || !config.journal.path.empty()),
+      journal_wait_strategy_(config.wait_strategy, config.spin_iterations),
+      journal_group_size_(config.journal.group_size > 0 ? config.journal.group_size : 1),
+      journal_fsync_(config.journal.fsync),
+      journal_fsync_interval_(config.journal.fsync_interval_us),
+      stop_journal_(false),
+      journaled_commands_(0),
+      journal_syncs_(0),
+      journal_durable_(0),
+      journal_failed_(false),
+      journal_refused_(0),
+      execution_stream_(config.execution_capacity),
+      market_data_stream_(config.market_data_capacity),
+      top_of_book_(config.top_of_book_capacity),
+      depth_levels_(config.depth_levels),
+      snapshot_slots_(new SnapshotSlot[kSnapshotSlots]),
+      stop_matching_engine_(false),
+      wait_strategy_(config.wait_strategy, config.spin_iterations),
+      batch_size_(config.batch_size > 0 ? config.batch_size : 1),
+      on_batch_(config.on_batch),
+      tick_sizes_(config.tick_sizes),
+      max_price_levels_(config.max_price_levels),
+      cpu_(config.cpu),
+      latency_(config.latency),
+      execution_wakeup_(config.execution_wakeup),
+      commands_processed_(0),
+      batches_(0),
+      last_batch_size_(0),
+      max_batch_size_(0),
+      last_book_(nullptr),
+      replaying_(false)
 {
+    // Books are created lazily on the matching thread, so reject bad config here
+    if (!tick_sizes_.valid())
+    {
+        throw std::invalid_argument("Tick sizes must be positive");
+    }
+
+    if (depth_levels_ > 0)
+    {
+        depth_views_.reset(new std::atomic<const DepthView *>[top_of_book_.capacity()]);
+        for (size_t i = 0; i < top_of_book_.capacity(); ++i)
+        {
+            depth_views_[i].store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    if (!config.journal.path.empty())
+    {
+        // Before replay: another layout's log holds symbols this shard does not
+        // own, and another band's or grid's log was matched by books unlike ours
+        check_journal_layout(config.journal.path, config.journal.shard_count, config.journal.shard_index,
+                             max_price_levels_, tick_sizes_.digest());
+    }
+    if (!config.journal.path.empty() && config.journal.recover)
+    {
+        recover(config.journal);
+    }
+
+    if (!config.journal.path.empty())
+    {
+        // Throws if the log cannot be opened, before any thread is started
+        journal_ = std::make_unique<JournalWriter>(config.journal.path, config.journal.initial_records,
+                                                   config.journal.shard_count, config.journal.shard_index,
+                                                   max_price_levels_, tick_sizes_.digest());
+        journaled_commands_.store(journal_->last_sequence(), std::memory_order_relaxed);
+        journal_durable_.store(journal_->last_sequence(), std::memory_order_relaxed);
+        journal_queue_ = std::make_unique<MpscRing<OrderCommand>>(config.journal.queue_capacity, config.single_producer);
+        journal_group_.reserve(journal_group_size_);
+    }
+
     matching_engine_thread_ = std::thread(&MatchingEngine::match_loop, this);
+    if (journal_queue_)
+    {
+        journal_thread_ = std::thread(&MatchingEngine::journal_loop, this);
+    }
+    if (journal_ && config.journal.snapshot_interval > 0 && !config.journal.snapshot_path.empty())
+    {
+        snapshotter_ = std::make_unique<Snapshotter>(config.journal.path, config.journal.snapshot_path, tick_sizes_,
+                                                     max_price_levels_, config.journal.snapshot_interval,
+                                                     [this]
+                                                     { return journal_durable_.load(std::memory_order_acquire); },
+                                                     journal_durable_advanced_);
+    }
 }
 
 MatchingEngine::~MatchingEngine()
 {
+    snapshotter_.reset();
+
+    // Stop the journal first so nothing is forwarded to a stopped matching thread
+    stop_journal_.store(true);
+    journal_wait_strategy_.wake();
+    if (journal_thread_.joinable())
+    {
+        journal_thread_.join();
+    }
+
     stop_matching_engine_.store(true);
+    wait_strategy_.wake(); // in case the matching thread is parked
     if (matching_engine_thread_.joinable())
     {
         matching_engine_thread_.join();
     }
+}
+
+bool MatchingEngine::process_order(Order &order, uint64_t received_at)
+{
+    // The order is copied into its ring slot; nothing is allocated per order
+    return submit_command(OrderCommand{CommandType::NEW_ORDER, order.get_symbol_id(), order.get_id(), order, nullptr, received_at,
+                                nullptr, 0, false});
+}
+
+bool MatchingEngine::process_order_sync(Order &order, OrderOutcome &outcome, std::chrono::microseconds timeout,
+                                        uint64_t received_at)
+{
+    // The calling thread's own slot: nothing is allocated or locked per order
+    OrderCompletion &completion = OrderCompletion::for_this_thread();
+    uint32_t ticket = completion.arm();
+    process_order_async(order, completion, ticket, received_at);
+    return completion.wait(ticket, outcome, timeout);
+}
+
+void MatchingEngine::process_order_async(Order &order, OrderCompletion &completion, uint32_t ticket,
+                                         uint64_t received_at)
+{
+    if (!submit_command(OrderCommand{CommandType::NEW_ORDER, order.get_symbol_id(), order.get_id(), order, nullptr,
+                                     received_at, &completion, ticket, false}))
+    {
+        completion.complete(ticket, OrderOutcome{order.get_id(), 0, 0.0, 0, OrderStatus::REJECTED});
+    }
+}
+
+bool MatchingEngine::cancel_order(uint64_t order_id, SymbolId symbol_id, uint64_t received_at)
+{
+    return submit_command(OrderCommand{CommandType::CANCEL_ORDER, symbol_id, order_id, Order(), nullptr, received_at, nullptr, 0, false});
+}
+
+bool MatchingEngine::amend_order(uint64_t order_id, SymbolId symbol_id, double price, int quantity, uint64_t received_at)
+{
+    // The placeholder order carries the new price and quantity
+    Order amendment;
+    amendment.set_price(price);
+    amendment.set_quantity(quantity);
+    return submit_command(OrderCommand{CommandType::AMEND_ORDER, symbol_id, order_id, amendment, nullptr, received_at, nullptr, 0, false});
+}
+
+bool MatchingEngine::cancel_order_sync(uint64_t order_id, SymbolId symbol_id, OrderOutcome &outcome,
+                                       std::chrono::microseconds timeout, uint64_t received_at)
+{
+    OrderCompletion &completion = OrderCompletion::for_this_thread();
+    uint32_t ticket = completion.arm();
+    cancel_order_async(order_id, symbol_id, completion, ticket, received_at);
+    return completion.wait(ticket, outcome, timeout);
+}
+
+void MatchingEngine::cancel_order_async(uint64_t order_id, SymbolId symbol_id, OrderCompletion &completion,
+                                        uint32_t ticket, uint64_t received_at)
+{
+    if (!submit_command(OrderCommand{CommandType::CANCEL_ORDER, symbol_id, order_id, Order(), nullptr, received_at,
+                                     &completion, ticket, false}))
+    {
+        completion.complete(ticket, OrderOutcome{order_id, 0, 0.0, 0, OrderStatus::REJECTED});
+    }
+}
+
+bool MatchingEngine::amend_order_sync(uint64_t order_id, SymbolId symbol_id, double price, int quantity, OrderOutcome &outcome,
+                                      std::chrono::microseconds timeout, uint64_t received_at)
+{
+    OrderCompletion &completion = OrderCompletion::for_this_thread();
+    uint32_t ticket = completion.arm();
+    amend_order_async(order_id, symbol_id, price, quantity, completion, ticket, received_at);
+    return completion.wait(ticket, outcome, timeout);
+}
+
+void MatchingEngine::amend_order_async(uint64_t order_id, SymbolId symbol_id, double price, int quantity,
+                                       OrderCompletion &completion, uint32_t ticket, uint64_t received_at)
+{
+    Order amendment;
+    amendment.set_price(price);
+    amendment.set_quantity(quantity);
+    if (!submit_command(OrderCommand{CommandType::AMEND_ORDER, symbol_id, order_id, amendment, nullptr,
+                                     received_at, &completion, ticket, false}))
+    {
+        completion.complete(ticket, OrderOutcome{order_id, 0, 0.0, 0, OrderStatus::REJECTED});
+    }
+}
+
+bool MatchingEngine::query_order(uint64_t order_id, SymbolId symbol_id, OrderOutcome &outcome,
+                                 std::chrono::microseconds timeout)
+{
+    OrderCompletion &completion = OrderCompletion::for_this_thread();
+    uint32_t ticket = completion.arm();
+    submit_command(OrderCommand{CommandType::QUERY_ORDER, symbol_id, order_id, Order(), nullptr, 0, &completion, ticket, false});
+    return completion.wait(ticket, outcome, timeout);
+}
+
+EngineStats MatchingEngine::get_stats() const
+{
+    EngineStats stats;
+    stats.commands_processed = commands_processed_.load(std::memory_order_relaxed);
+    stats.batches = batches_.load(std::memory_order_relaxed);
+    stats.last_batch_size = last_batch_size_.load(std::memory_order_relaxed);
+    stats.max_batch_size = max_batch_size_.load(std::memory_order_relaxed);
+    stats.batch_size_limit = batch_size_;
+    stats.journaled_commands = journaled_commands_.load(std::memory_order_relaxed);
+    stats.journal_syncs = journal_syncs_.load(std::memory_order_relaxed);
+    stats.journal_failed = journal_failed_.load(std::memory_order_relaxed);
+    stats.journal_refused = journal_refused_.load(std::memory_order_relaxed);
+    stats.snapshots_written = snapshotter_ ? snapshotter_->snapshots_written() : 0;
+    stats.queue_depth = order_queue_.size_approx();
+    stats.queue_capacity = order_queue_.capacity();
+    if (journal_queue_)
+    {
+        stats.journal_queue_depth = journal_queue_->size_approx();
+        stats.journal_queue_capacity = journal_queue_->capacity();
+    }
+    return stats;
+}
+
+const RecoveryStats &MatchingEngine::get_recovery_stats() const
+{
+    return recovery_stats_;
+}
+
+const ExecutionStream &MatchingEngine::get_execution_stream() const
+{
+    return execution_stream_;
+}
+
+const MarketDataStream &MatchingEngine::get_market_data_stream() const
+{
+    return market_data_stream_;
+}
+
+bool MatchingEngine::get_top_of_book(SymbolId symbol_id, TopOfBook &top) const
+{
+    return top_of_book_.read(symbol_id, top);
+}
+
+bool MatchingEngine::get_depth(SymbolId symbol_id, size_t max_levels, DepthSnapshot &depth) const
+{
+    size_t slot = depth_views_ ? top_of_book_.find(symbol_id) : TopOfBookTable::kNoSlot;
+    const DepthView *view = slot != TopOfBookTable::kNoSlot ? depth_views_[slot].load(std::memory_order_acquire) : nullptr;
+    if (!view || !view->read(max_levels, depth))
+    {
+        return false;
+    }
+    depth.symbol_id = symbol_id;
+    return true;
+}
+
+bool MatchingEngine::get_snapshot(SymbolId symbol_id, size_t max_levels, BookSnapshot &snapshot,
+                                  std::chrono::milliseconds timeout)
+{
+    SnapshotSlot *slot = nullptr;
+    for (size_t i = 0; i < kSnapshotSlots && !slot; ++i)
+    {
+        std::lock_guard<std::mutex> lock(snapshot_slots_[i].mutex);
+        if (snapshot_slots_[i].state == SnapshotSlot::State::FREE)
+        {
+            snapshot_slots_[i].state = SnapshotSlot::State::PENDING;
+            snapshot_slots_[i].max_levels = max_levels;
+            slot = &snapshot_slots_[i];
+        }
+    }
+    if (!slot)
+    {
+        return false; // every slot is waiting on the matching thread
+    }
+
+    submit_command(OrderCommand{CommandType::SNAPSHOT, symbol_id, 0, Order(), slot, 0, nullptr, 0, false});
+
+    std::unique_lock<std::mutex> lock(slot->mutex);
+    if (!slot->done.wait_for(lock, timeout, [slot]
+                             { return slot->state == SnapshotSlot::State::DONE; }))
+    {
+        slot->state = SnapshotSlot::State::ABANDONED; // freed by the matching thread
+        return false;
+    }
+
+    snapshot = std::move(slot->snapshot);
+    slot->snapshot = BookSnapshot();
+    slot->state = SnapshotSlot::State::FREE;
+    return true;
+}
+
+bool MatchingEngine::submit_command(OrderCommand &&command)
+{
+    // Reads are still served; a race with a failure in flight is caught by
+    // the journal thread, which drops the group
+    if (!is_read_command(command.type) && journal_failed_.load(std::memory_order_acquire))
+    {
+        journal_refused_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    if (latency_ && !is_read_command(command.type) && command.received_at == 0)
+    {
+        command.received_at = CycleClock::now();
+    }
+    const uint64_t received_at = latency_ ? command.received_at : 0;
+
+    if (journal_queue_)
+    {
+        journal_queue_->push(std::move(command));
+        journal_wait_strategy_.notify();
+    }
+    else
+    {
+        // Only waits if the ring is full, i.e. the matching thread is a whole ring behind
+        order_queue_.push(std::move(command));
+        wait_strategy_.notify();
+    }
+
+    if (received_at != 0)
+    {
+        latency_->record(LatencyStage::ENQUEUED, received_at, CycleClock::now());
+    }
+    return true;
+}
+
+void MatchingEngine::enqueue_for_matching(OrderCommand &&command)
+{
+    order_queue_.push(std::move(command));
+    wait_strategy_.notify();
+}
+
+bool MatchingEngine::journal_command(const OrderCommand &command)
+{
+    JournalRecord record{};
+    switch (command.type)
+    {
+    case CommandType::NEW_ORDER:
+        record.type = JournalRecordType::SUBMIT;
+        record.price = command.order.get_price();
+        record.quantity = command.order.get_quantity();
+        record.side = static_cast<uint8_t>(command.order.get_side());
+        record.order_type = static_cast<uint8_t>(command.order.get_type());
+        record.strategy = static_cast<uint8_t>(command.order.get_strategy());
+        break;
+    case CommandType::CANCEL_ORDER:
+        record.type = JournalRecordType::CANCEL;
+        break;
+    case CommandType::AMEND_ORDER:
+        record.type = JournalRecordType::AMEND;
+        record.price = command.order.get_price();
+        record.quantity = command.order.get_quantity();
+        break;
+    case CommandType::SNAPSHOT:
+    case CommandType::QUERY_ORDER:
+        return true; // reads do not change the book
+    }
+    record.order_id = command.order_id;
+    record.symbol_id = command.symbol_id;
+    record.timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              std::chrono::system_clock::now().time_since_epoch())
+                              .count();
+
+    try
+    {
+        journaled_commands_.store(journal_->append(record), std::memory_order_release);
+        return true;
+    }
+    catch (const std::exception &e)
+    {
+        fail_journal(std::string("append failed: ") + e.what());
+        return false;
+    }
+}
+
+bool MatchingEngine::sync_journal()
+{
+    if (journal_failed_.load(std::memory_order_relaxed))
+    {
+        return false;
+    }
+    if (journal_->synced_sequence() == journal_->last_sequence())
+    {
+        return true;
+    }
+    if (!journal_->sync())
+    {
+        fail_journal("sync failed");
+        return false;
+    }
+    journal_syncs_.store(journal_syncs_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    journal_durable_.store(journal_->synced_sequence(), std::memory_order_release);
+    journal_durable_advanced_.notify_all();
+    return true;
+}
+
+void MatchingEngine::fail_journal(const std::string &reason)
+{
+    if (!journal_failed_.exchange(true, std::memory_order_acq_rel))
+    {
+        // Matching on without a durable log would break the durable-before-matched promise
+        std::cerr << "MatchingEngine: journal " << reason << "; refusing new commands" << std::endl;
+    }
+}
+
+void MatchingEngine::refuse_group()
+{
+    for (OrderCommand &command : journal_group_)
+    {
+        if (is_read_command(command.type))
+        {
+            enqueue_for_matching(std::move(command)); // still served
+            continue;
+        }
+        // Only the matching thread writes the execution stream, so it reports
+        // the refusal; async submitters have no other way to hear of it
+        command.refused = true;
+        enqueue_for_matching(std::move(command));
+        journal_refused_.fetch_add(1, std::memory_order_relaxed);
+    }
+    journal_group_.clear();
+}
+
+void MatchingEngine::report_refused(const OrderCommand &command)
+{
+    switch (command.type)
+    {
+    case CommandType::NEW_ORDER:
+        publish_rejected(command, ExecutionType::REJECT);
+        break;
+    case CommandType::CANCEL_ORDER:
+        publish_rejected(command, ExecutionType::CANCEL_REJECT);
+        break;
+    case CommandType::AMEND_ORDER:
+        publish_rejected(command, ExecutionType::REPLACE_REJECT);
+        break;
+    default:
+        break;
+    }
+
+    if (command.completion)
+    {
+        command.completion->complete(command.completion_ticket,
+                                     OrderOutcome{command.order_id, 0, 0.0, 0, OrderStatus::REJECTED});
+    }
+}
+
+void MatchingEngine::execute_command(OrderCommand &command)
+{
+    if (command.refused)
+    {
+        report_refused(command); // never matched, so no latency either
+        return;
+    }
+
+    const bool timed = latency_ && command.received_at != 0;
+    if (timed)
+    {
+        latency_->record(LatencyStage::DEQUEUED, command.received_at, CycleClock::now());
+    }
+
+    switch (command.type)
+    {
+    case CommandType::NEW_ORDER:
+    {
+        SymbolBook *symbol_book = book_for(command.symbol_id);
+        // Matched in its slot, copied only if it rests
+        MatchResult result = symbol_book->book.match_orders(command.order);
+        mark_touched(symbol_book);
+        if (command.completion)
+        {
+            complete_order(command, symbol_book->book, result);
+        }
+        break;
+    }
+    case CommandType::CANCEL_ORDER:
+    {
+        SymbolBook *symbol_book = find_book(command.symbol_id);
+        const bool cancelled = symbol_book && symbol_book->book.cancel_order(command.order_id);
+        if (cancelled)
+        {
+            mark_touched(symbol_book); // the book published CANCEL
+        }
+        else
+        {
+            publish_rejected(command, ExecutionType::CANCEL_REJECT);
+        }
+        if (command.completion)
+        {
+            command.completion->complete(command.completion_ticket,
+                                         OrderOutcome{command.order_id, 0, 0.0, 0,
+                                                      cancelled ? OrderStatus::CANCELLED : OrderStatus::REJECTED});
+        }
+        break;
+    }
+    case CommandType::AMEND_ORDER:
+    {
+        SymbolBook *symbol_book = find_book(command.symbol_id);
+        const bool amended =
+            symbol_book &&
+            symbol_book->book.amend_order(command.order_id, command.order.get_price(), command.order.get_quantity());
+        if (amended)
+        {
+            mark_touched(symbol_book); // the book published REPLACE
+        }
+        else
+        {
+            publish_rejected(command, ExecutionType::REPLACE_REJECT);
+        }
+        if (command.completion)
+        {
+            // A crossing amend may have traded; whatever still rests is reported
+            const RestingOrder *resting = amended ? symbol_book->book.find_order(command.order_id) : nullptr;
+            OrderOutcome outcome{command.order_id, 0, 0.0, resting ? resting->quantity : 0,
+                                 !amended ? OrderStatus::REJECTED : resting ? OrderStatus::PENDING : OrderStatus::FILLED};
+            command.completion->complete(command.completion_ticket, outcome);
+        }
+        break;
+    }
+    case CommandType::SNAPSHOT:
+        take_snapshot(*command.snapshot, command.symbol_id);
+        break;
+    case CommandType::QUERY_ORDER:
+    {
+        SymbolBook *symbol_book = find_book(command.symbol_id);
+        const RestingOrder *resting = symbol_book ? symbol_book->book.find_order(command.order_id) : nullptr;
+        OrderOutcome outcome{command.order_id, 0, 0.0, resting ? resting->quantity : 0,
+                             resting ? OrderStatus::PENDING : OrderStatus::CANCELLED};
+        outcome.execution_sequence = execution_stream_.published();
+        command.completion->complete(command.completion_ticket, outcome);
+        break;
+    }
+    }
+
+    if (timed)
+    {
+        latency_->record(LatencyStage::MATCHED, command.received_at, CycleClock::now());
+    }
+}
+
+void MatchingEngine::publish_rejected(const OrderCommand &command, ExecutionType type)
+{
+    // The order may be gone or its book never created, so the event is built
+    // from the command rather than by the book. Price and quantity are the
+    // order's for a submit, the new ones for an amend and 0 for a cancel.
+    ExecutionEvent event{};
+    event.sequence = execution_stream_.published() + 1;
+    event.taker_order_id = command.order_id;
+    event.price = command.order.get_price();
+    event.quantity = command.order.get_quantity();
+    event.timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             std::chrono::system_clock::now().time_since_epoch())
+                             .count();
+    event.symbol_id = command.symbol_id;
+    event.taker_side = command.order.get_side();
+    event.type = type;
+    execution_stream_.publish(event);
+}
+
+void MatchingEngine::complete_order(const OrderCommand &command, const OrderBook &book, const MatchResult &result)
+{
+    OrderOutcome outcome;
+    outcome.order_id = command.order_id;
+    outcome.filled_quantity = result.filled_quantity;
+    outcome.resting_quantity = result.resting_quantity;
+    if (result.filled_quantity > 0)
+    {
+        outcome.average_price = book.tick_to_price(result.filled_notional_ticks) / static_cast<double>(result.filled_quantity);
+    }
+
+    if (result.rejected || (result.filled_quantity == 0 && result.resting_quantity == 0 && result.expired_quantity == 0))
+    {
+        outcome.status = OrderStatus::REJECTED; // duplicate id, or nothing to trade
+    }
+    else if (result.resting_quantity > 0)
+    {
+        outcome.status = OrderStatus::PENDING;
+    }
+    else if (result.expired_quantity > 0)
+    {
+        outcome.status = OrderStatus::CANCELLED; // remainder could not rest
+    }
+    else
+    {
+        outcome.status = OrderStatus::FILLED;
+    }
+    command.completion->complete(command.completion_ticket, outcome);
+}
+
+MatchingEngine::SymbolBook *MatchingEngine::find_book(SymbolId symbol_id)
+{
+    // Consecutive commands usually hit the same instrument
+    if (last_book_ && last_book_->symbol_id == symbol_id)
+    {
+        return last_book_;
+    }
+
+    auto it = books_.find(symbol_id);
+    if (it == books_.end())
+    {
+        return nullptr;
+    }
+    last_book_ = it->second.get();
+    return last_book_;
+}
+
+MatchingEngine::SymbolBook *MatchingEngine::book_for(SymbolId symbol_id)
+{
+    SymbolBook *symbol_book = find_book(symbol_id);
+    if (!symbol_book)
+    {
+        auto book = std::make_unique<SymbolBook>(symbol_id, tick_sizes_.for_symbol(symbol_id), max_price_levels_);
+        auto inserted = books_.emplace(symbol_id, std::move(book));
+        symbol_book = inserted.first->second.get();
+        symbol_book->top_slot = top_of_book_.claim(symbol_id);
+        if (symbol_book->top_slot == TopOfBookTable::kNoSlot)
+        {
+            std::cerr << "MatchingEngine: top of book table full, symbol " << symbol_id
+                      << " is not published" << std::endl;
+        }
+        else if (depth_views_)
+        {
+            symbol_book->depth = std::make_unique<DepthView>(depth_levels_);
+            depth_views_[symbol_book->top_slot].store(symbol_book->depth.get(), std::memory_order_release);
+        }
+        if (!replaying_)
+        {
+            symbol_book->book.set_execution_stream(&execution_stream_);
+            symbol_book->book.set_level_tracking(true);
+        }
+        last_book_ = symbol_book;
+    }
+    return symbol_book;
+}
 
-    // Clean up any remaining orders in the queue
-    Order *remaining_order;
-    while (order_queue_.pop(remaining_order))
+void MatchingEngine::mark_touched(SymbolBook *symbol_book)
+{
+    if (!symbol_book->touched)
     {
-        delete remaining_order;
+        symbol_book->touched = true;
+        touched_books_.push_back(symbol_book);
     }
 }
 
-void MatchingEngine::process_order(Order &order)
+void MatchingEngine::take_snapshot(SnapshotSlot &slot, SymbolId symbol_id)
 {
-    // Create smart pointer for RAII and automatic cleanup
-    std::unique_ptr<Order> order_ptr = std::make_unique<Order>(order);
+    BookSnapshot snapshot;
+    snapshot.symbol_id = symbol_id;
+    // Level updates from this batch are published after this point, so a
+    // subscriber replaying from here also sees changes made earlier in the batch
+    snapshot.market_data_sequence = market_data_stream_.published();
 
-    // Extract raw pointer for the lock-free queue
-    Order *raw_ptr = order_ptr.get();
+    SymbolBook *symbol_book = find_book(symbol_id);
+    if (symbol_book)
+    {
+        symbol_book->book.get_depth(slot.max_levels, snapshot.bids, snapshot.asks);
+    }
 
-    while (!order_queue_.push(raw_ptr))
+    std::lock_guard<std::mutex> lock(slot.mutex);
+    if (slot.state == SnapshotSlot::State::ABANDONED)
+    {
+        slot.state = SnapshotSlot::State::FREE;
+        return;
+    }
+    slot.snapshot = std::move(snapshot);
+    slot.state = SnapshotSlot::State::DONE;
+    slot.done.notify_one();
+}
+
+void MatchingEngine::publish_book_views(SymbolBook *symbol_book, uint64_t batch)
+{
+    if (symbol_book->top_slot == TopOfBookTable::kNoSlot)
     {
-        std::this_thread::yield();
+        return;
     }
+    TopOfBook top{};
+    top.sequence = batch;
+    top.symbol_id = symbol_book->symbol_id;
+    symbol_book->book.get_top_of_book(top);
+    top_of_book_.publish(symbol_book->top_slot, top);
 
-    order_ptr.release();
+    if (symbol_book->depth)
+    {
+        symbol_book->depth->publish(batch, symbol_book->book);
+    }
+}
+
+void MatchingEngine::finish_batch()
+{
+    const uint64_t batch = batches_.load(std::memory_order_relaxed);
+
+    for (SymbolBook *symbol_book : touched_books_)
+    {
+        // Hold back the newest update so the last one for the book can be flagged
+        LevelUpdate pending{};
+        bool have_pending = false;
+        symbol_book->book.drain_level_changes([&](OrderSide side, double price, int64_t quantity)
+                                              {
+            if (have_pending)
+            {
+                pending.sequence = market_data_stream_.published() + 1;
+                market_data_stream_.publish(pending);
+            }
+            pending = LevelUpdate{0, batch, symbol_book->symbol_id, side, 0, price, quantity};
+            have_pending = true; });
+        if (have_pending)
+        {
+            pending.sequence = market_data_stream_.published() + 1;
+            pending.flags = LevelUpdate::LAST_IN_BATCH;
+            market_data_stream_.publish(pending);
+        }
+
+        publish_book_views(symbol_book, batch);
+        if (on_batch_)
+        {
+            on_batch_(symbol_book->symbol_id, symbol_book->book);
+        }
+        symbol_book->touched = false;
+    }
+    touched_books_.clear();
+
+    // Parked readers are woken once per batch, not per record
+    market_data_stream_.notify_readers();
+    execution_stream_.notify_readers();
+    if (execution_wakeup_)
+    {
+        execution_wakeup_->notify_all();
+    }
+}
+
+void MatchingEngine::record_batch(size_t batch_size)
+{
+    // Single writer, so plain load/store instead of locked read-modify-writes
+    commands_processed_.store(commands_processed_.load(std::memory_order_relaxed) + batch_size,
+                              std::memory_order_relaxed);
+    batches_.store(batches_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    last_batch_size_.store(batch_size, std::memory_order_relaxed);
+    if (batch_size > max_batch_size_.load(std::memory_order_relaxed))
+    {
+        max_batch_size_.store(batch_size, std::memory_order_relaxed);
+    }
+}
+
+void MatchingEngine::journal_loop()
+{
+    uint32_t idle_rounds = 0;
+    auto last_sync = std::chrono::steady_clock::now();
+    auto stage = [this](OrderCommand &command)
+    { journal_group_.push_back(std::move(command)); };
+    auto has_work = [this]
+    { return stop_journal_.load() || journal_queue_->has_next(); };
+
+    // Group commit: every command drained in one pass is written, then the
+    // whole group shares a single sync before any of it is matched. A group
+    // that cannot be written or synced is dropped, never matched.
+    while (true)
+    {
+        // Read before draining, so whatever was queued before the stop is
+        // still journaled and forwarded
+        const bool stopping = stop_journal_.load();
+        size_t group_size = journal_queue_->consume_batch(stage, journal_group_size_);
+        if (group_size == 0)
+        {
+            // Groups skipped by the sync interval become durable before we go idle
+            if (journal_fsync_)
+            {
+                sync_journal();
+                last_sync = std::chrono::steady_clock::now();
+            }
+            if (stopping)
+            {
+                break;
+            }
+            journal_wait_strategy_.idle(idle_rounds++, has_work);
+            continue;
+        }
+
+        idle_rounds = 0;
+        const uint64_t group_start = journal_->last_sequence();
+        bool durable = !journal_failed_.load(std::memory_order_relaxed);
+        for (size_t i = 0; durable && i < journal_group_.size(); ++i)
+        {
+            durable = journal_command(journal_group_[i]);
+        }
+        if (durable && journal_fsync_)
+        {
+            // With a sync interval, a group may be matched before its sync;
+            // that is the trade-off the interval asks for
+            auto now = std::chrono::steady_clock::now();
+            if (journal_fsync_interval_.count() == 0 || now - last_sync >= journal_fsync_interval_)
+            {
+                durable = sync_journal();
+                last_sync = now;
+            }
+        }
+
+        if (!durable)
+        {
+            // Records the group already wrote must not be replayed on recovery
+            journal_->discard_after(group_start);
+            journaled_commands_.store(group_start, std::memory_order_release);
+            refuse_group();
+            continue;
+        }
+        if (!journal_fsync_)
+        {
+            // Release: the snapshot thread reads records up to this sequence,
+            // so it only sees groups that will be matched
+            journal_durable_.store(journal_->last_sequence(), std::memory_order_release);
+            journal_durable_advanced_.notify_all();
+        }
+        for (OrderCommand &command : journal_group_)
+        {
+            enqueue_for_matching(std::move(command));
+        }
+        journal_group_.clear();
+    }
+}
+
+void MatchingEngine::recover(const JournalConfig &config)
+{
+    // Straight into the books on this thread: the matching thread is not
+    // running yet, and nothing is published for commands already handled
+    replaying_ = true;
+    recovery_stats_ = recover_books(config.snapshot_path, config.path, tick_sizes_, max_price_levels_,
+                                    [this](SymbolId symbol_id) -> OrderBook &
+                                    { return book_for(symbol_id)->book; });
+    replaying_ = false;
+
+    // New orders must not reuse the id of one that is resting or was journaled
+    OrderIdAllocator::reserve_through(recovery_stats_.max_order_id);
+
+    // Readers see the recovered touch before the first batch runs
+    for (auto &entry : books_)
+    {
+        entry.second->book.set_execution_stream(&execution_stream_);
+        entry.second->book.set_level_tracking(true);
+        publish_book_views(entry.second.get(), 0);
+    }
 }
 
 void MatchingEngine::match_loop()
 {
-    while (!stop_matching_engine_.load())
+    uint32_t idle_rounds = 0;
+    auto execute = [this](OrderCommand &command)
+    { execute_command(command); };
+    auto has_work = [this]
+    { return stop_matching_engine_.load() || order_queue_.has_next(); };
+
+    if (cpu_ >= 0 && !pin_current_thread(cpu_))
     {
-        Order *current_order_ptr;
+        std::cerr << "MatchingEngine: could not pin matching thread to CPU " << cpu_ << std::endl;
+    }
 
-        // Lock-free pop - returns false if queue is empty
-        if (order_queue_.pop(current_order_ptr))
+    // The stop flag, stats and the batch hook are handled once per batch. On
+    // stop the queue is drained first: every command in it was accepted.
+    while (true)
+    {
+        const bool stopping = stop_matching_engine_.load();
+        size_t batch_size = order_queue_.consume_batch(execute, batch_size_);
+        if (batch_size > 0)
+        {
+            idle_rounds = 0;
+            record_batch(batch_size);
+            finish_batch();
+        }
+        else if (stopping)
         {
-            order_book_.match_orders(*current_order_ptr);
-            delete current_order_ptr; // Clean up after processing
+            break;
         }
         else
         {
-            // Queue is empty, small sleep to avoid busy waiting
-            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            // Queue is empty: spin, yield or park depending on the strategy
+            wait_strategy_.idle(idle_rounds++, has_work);
         }
     }
-}
\ No newline at end of file
+}
@@ -1,31 +1,46 @@
 #include "Order.h"
+#include "OrderIdAllocator.h"
 #include <chrono>
 
-static uint64_t order_counter = 0;
-
-Order::Order(Strategy strategy, int quantity, double price, OrderSide side, OrderType type)
+Order::Order(Strategy strategy, int quantity, double price, OrderSide side, OrderType type, SymbolId symbol_id)
 {
-    this->id = std::chrono::high_resolution_clock::now().time_since_epoch().count() + (++order_counter);
+    this->id = OrderIdAllocator::next();
     this->strategy = strategy;
     this->quantity = quantity;
     this->price = price;
     this->side = side;
     this->type = type;
     this->status = OrderStatus::PENDING;
+    this->symbol_id = symbol_id;
     this->created_at = std::chrono::system_clock::now();
 }
 
+Order::Order(uint64_t id, Strategy strategy, int quantity, double price, OrderSide side, OrderType type,
+             SymbolId symbol_id, std::chrono::system_clock::time_point created_at)
+{
+    this->id = id;
+    this->strategy = strategy;
+    this->quantity = quantity;
+    this->price = price;
+    this->side = side;
+    this->type = type;
+    this->status = OrderStatus::PENDING;
+    this->symbol_id = symbol_id;
+    this->created_at = created_at;
+}
+
 Order::Order()
 {
-    // Default constructor - initialize with default values
-    this->id = std::chrono::high_resolution_clock::now().time_since_epoch().count() + (++order_counter);
+    // Placeholder, e.g. in cancel commands and ring slots: no id, no clock read
+    this->id = 0;
     this->strategy = Strategy::OTHER;
     this->quantity = 0;
     this->price = 0.0;
     this->side = OrderSide::BUY;
     this->type = OrderType::MARKET;
     this->status = OrderStatus::PENDING;
-    this->created_at = std::chrono::system_clock::now();
+    this->symbol_id = 0;
+    this->created_at = std::chrono::system_clock::time_point();
 }
 
 Order::Order(const Order &other)
@@ -38,6 +53,7 @@ Order::Order(const Order &other)
     this->side = other.side;
     this->type = other.type;
     this->status = other.status;
+    this->symbol_id = other.symbol_id;
     this->created_at = other.created_at;
 }
 
@@ -80,6 +96,16 @@ OrderStatus Order::get_status() const
     return status;
 }
 
+SymbolId Order::get_symbol_id() const
+{
+    return symbol_id;
+}
+
+std::chrono::system_clock::time_point Order::get_created_at() const
+{
+    return created_at;
+}
+
 void Order::set_quantity(int quantity)
 {
     this->quantity = quantity;
@@ -99,3 +125,8 @@ void Order::set_status(OrderStatus status)
 {
     this->status = status;
 }
+
+void Order::set_symbol_id(SymbolId symbol_id)
+{
+    this->symbol_id = symbol_id;
+}
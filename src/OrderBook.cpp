@@ -1,65 +1,120 @@
 #include "OrderBook.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <stdexcept>
 
-OrderBook::OrderBook()
+OrderBook::OrderBook(double tick_size, size_t max_levels_per_side)
+    : tick_size(tick_size),
+      max_levels_per_side(max_levels_per_side),
+      bids(OrderSide::BUY, 256, max_levels_per_side),
+      asks(OrderSide::SELL, 256, max_levels_per_side),
+      execution_stream(nullptr),
+      track_level_changes(false)
 {
-    // Default constructor - empty order book
+    if (tick_size <= 0.0)
+    {
+        throw std::invalid_argument("Tick size must be positive");
+    }
 }
 
 OrderBook::~OrderBook()
 {
-    // Destructor - clean up if needed
+    // The book owns every resting node
+    order_index.for_each([this](OrderNode *node)
+                         { order_pool.release(node); });
 }
 
-void OrderBook::add_order(Order &order)
+bool OrderBook::add_order(Order &order)
 {
-    if (order.get_side() == OrderSide::BUY)
-    {
-        bids[order.get_price()].push_back(order);
-    }
-    else
+    return add_order_to_book(order);
+}
+
+void OrderBook::remove_order(Order &order)
+{
+    remove_order_from_book(order.get_id());
+}
+
+void OrderBook::update_order(Order &order)
+{
+    update_order_in_book(order);
+}
+
+void OrderBook::cancel_order(Order &order)
+{
+    remove_order(order); // Reuse the remove_order logic
+}
+
+bool OrderBook::cancel_order(uint64_t order_id)
+{
+    OrderNode *node = order_index.find(order_id);
+    if (node)
     {
-        asks[order.get_price()].push_back(order);
+        publish_done(ExecutionType::CANCEL, node->order, order_pool.details(node).symbol_id);
     }
+    return remove_order_from_book(order_id);
 }
 
-void OrderBook::remove_order(Order &order)
+bool OrderBook::amend_order(uint64_t order_id, double price, int quantity)
 {
-    if (order.get_side() == OrderSide::BUY)
+    OrderNode *node = order_index.find(order_id);
+    if (!node || quantity <= 0)
     {
-        remove_order_from_book(order);
+        return false;
     }
-    else
+
+    RestingOrder &order = node->order;
+    PriceLadder &ladder = ladder_for(order.side);
+    const Tick tick = limit_tick(price);
+    if (tick <= 0 || !ladder.can_hold(tick))
     {
-        auto it = asks.find(order.get_price());
-        if (it != asks.end())
-        {
-            auto &queue = it->second;
-            for (auto queue_it = queue.begin(); queue_it != queue.end(); ++queue_it)
-            {
-                if (queue_it->get_id() == order.get_id())
-                {
-                    queue.erase(queue_it);
-                    break;
-                }
-            }
-            if (queue.empty())
-            {
-                asks.erase(it);
-            }
-        }
+        return false;
     }
+    const SymbolId symbol_id = order_pool.details(node).symbol_id;
+    if (tick == order.tick && quantity <= order.quantity)
+    {
+        ladder.find_level(tick)->total_quantity -= order.quantity - quantity;
+        order.quantity = quantity;
+        mark_level_changed(order.side, tick);
+        publish_done(ExecutionType::REPLACE, order, symbol_id);
+        return true;
+    }
+
+    const PriceLadder &makers = order.side == OrderSide::BUY ? asks : bids;
+    const bool crosses = makers.quantity_through(tick, 1) > 0;
+    if (crosses && order.type == OrderType::POST_ONLY)
+    {
+        return false;
+    }
+
+    ladder.unlink(node);
+    mark_level_changed(order.side, order.tick);
+    order.tick = tick;
+    order.quantity = quantity;
+    // Ahead of any fills below, so readers count those down from the new quantity
+    publish_done(ExecutionType::REPLACE, order, symbol_id);
+    if (!crosses)
+    {
+        ladder.push_back(node);
+        mark_level_changed(order.side, tick);
+        return true;
+    }
+
+    // Matched as an incoming node, which re-indexes it if anything rests
+    order_index.erase(order_id);
+    match_orders(node);
+    return true;
 }
 
-void OrderBook::update_order(Order &order)
+const RestingOrder *OrderBook::find_order(uint64_t order_id) const
 {
-    remove_order(order); // Remove the old version
-    add_order(order);    // Add the updated version
+    const OrderNode *node = order_index.find(order_id);
+    return node ? &node->order : nullptr;
 }
 
-void OrderBook::cancel_order(Order &order)
+size_t OrderBook::order_count() const
 {
-    remove_order(order); // Reuse the remove_order logic
+    return order_index.size();
 }
 
 double OrderBook::get_best_bid() const
@@ -68,7 +123,7 @@ double OrderBook::get_best_bid() const
     {
         throw std::runtime_error("No bids available");
     }
-    return bids.begin()->first;
+    return tick_to_price(bids.best_tick());
 }
 
 double OrderBook::get_best_ask() const
@@ -77,184 +132,387 @@ double OrderBook::get_best_ask() const
     {
         throw std::runtime_error("No asks available");
     }
-    return asks.begin()->first;
+    return tick_to_price(asks.best_tick());
+}
+
+void OrderBook::get_top_of_book(TopOfBook &top) const
+{
+    top.has_bid = !bids.empty();
+    top.bid_price = top.has_bid ? tick_to_price(bids.best_tick()) : 0.0;
+    top.bid_quantity = top.has_bid ? bids.find_level(bids.best_tick())->total_quantity : 0;
+    top.has_ask = !asks.empty();
+    top.ask_price = top.has_ask ? tick_to_price(asks.best_tick()) : 0.0;
+    top.ask_quantity = top.has_ask ? asks.find_level(asks.best_tick())->total_quantity : 0;
 }
 
 OrderQueue OrderBook::get_bids(double price) const
 {
-    auto it = bids.find(price);
-    if (it != bids.end())
+    return copy_level(bids.find_level(price_to_tick(price)));
+}
+
+OrderQueue OrderBook::get_asks(double price) const
+{
+    return copy_level(asks.find_level(price_to_tick(price)));
+}
+
+void OrderBook::set_execution_stream(ExecutionStream *stream)
+{
+    execution_stream = stream;
+}
+
+void OrderBook::get_depth(size_t max_levels, std::vector<LevelQuantity> &bid_levels, std::vector<LevelQuantity> &ask_levels) const
+{
+    bid_levels.clear();
+    ask_levels.clear();
+    bids.for_each_level(max_levels, [&](Tick tick, const PriceLevel &level)
+                        { bid_levels.push_back(LevelQuantity{tick_to_price(tick), level.total_quantity}); });
+    asks.for_each_level(max_levels, [&](Tick tick, const PriceLevel &level)
+                        { ask_levels.push_back(LevelQuantity{tick_to_price(tick), level.total_quantity}); });
+}
+
+size_t OrderBook::level_count(OrderSide side) const
+{
+    return side == OrderSide::BUY ? bids.level_count() : asks.level_count();
+}
+
+void OrderBook::set_level_tracking(bool enabled)
+{
+    track_level_changes = enabled;
+    changed_levels.clear();
+}
+
+void OrderBook::mark_level_changed(OrderSide side, Tick tick)
+{
+    if (track_level_changes)
     {
-        return it->second;
+        changed_levels.push_back(ChangedLevel{side, tick});
     }
-    return OrderQueue();
 }
 
-OrderQueue OrderBook::get_asks(double price) const
+double OrderBook::get_tick_size() const
 {
-    auto it = asks.find(price);
-    if (it != asks.end())
+    return tick_size;
+}
+
+size_t OrderBook::get_max_levels_per_side() const
+{
+    return max_levels_per_side;
+}
+
+Tick OrderBook::price_to_tick(double price) const
+{
+    return static_cast<Tick>(std::llround(price / tick_size));
+}
+
+Tick OrderBook::limit_tick(double price) const
+{
+    // Beyond 2^53 ticks a double no longer holds every tick, and llround's result is unspecified
+    const double ticks = price / tick_size;
+    if (!std::isfinite(ticks) || ticks <= 0.0 || ticks >= 9007199254740992.0)
     {
-        return it->second;
+        return 0;
     }
-    return OrderQueue();
+    return price_to_tick(price);
 }
 
-void OrderBook::add_order_to_book(Order &order)
+double OrderBook::tick_to_price(Tick tick) const
 {
-    if (order.get_side() == OrderSide::BUY)
+    return static_cast<double>(tick) * tick_size;
+}
+
+bool OrderBook::add_order_to_book(Order &order)
+{
+    const Tick tick = limit_tick(order.get_price());
+    if (tick <= 0 || !ladder_for(order.get_side()).can_hold(tick) || order_index.find(order.get_id()))
     {
-        bids[order.get_price()].push_back(order);
+        return false;
     }
-    else
+    return rest_node(order_pool.acquire(order, tick));
+}
+
+bool OrderBook::rest_node(OrderNode *node)
+{
+    if (!order_index.insert(node->order.id, node))
+    {
+        order_pool.release(node);
+        return false;
+    }
+
+    ladder_for(node->order.side).push_back(node);
+    mark_level_changed(node->order.side, node->order.tick);
+    return true;
+}
+
+bool OrderBook::remove_order_from_book(uint64_t order_id)
+{
+    OrderNode *node = order_index.erase(order_id);
+    if (!node)
     {
-        asks[order.get_price()].push_back(order);
+        return false;
     }
+
+    ladder_for(node->order.side).unlink(node);
+    mark_level_changed(node->order.side, node->order.tick);
+    order_pool.release(node);
+    return true;
+}
+
+void OrderBook::update_order_in_book(Order &order)
+{
+    // Price and quantity changes go through the amend path; only a side
+    // change needs a fresh order
+    const OrderNode *node = order_index.find(order.get_id());
+    if (node && node->order.side == order.get_side() &&
+        amend_order(order.get_id(), order.get_price(), order.get_quantity()))
+    {
+        return;
+    }
+    remove_order_from_book(order.get_id());
+    add_order_to_book(order);
+}
+
+OrderPool &OrderBook::get_order_pool()
+{
+    return order_pool;
 }
 
-void OrderBook::remove_order_from_book(Order &order)
+PriceLadder &OrderBook::ladder_for(OrderSide side)
 {
-    if (order.get_side() == OrderSide::BUY)
+    return side == OrderSide::BUY ? bids : asks;
+}
+
+OrderQueue OrderBook::copy_level(const PriceLevel *level) const
+{
+    OrderQueue queue;
+    if (level)
     {
-        auto it = bids.find(order.get_price());
-        if (it != bids.end())
+        queue.reserve(level->order_count);
+        for (const OrderNode *node = level->head; node; node = node->next)
         {
-            auto &queue = it->second;
-            for (auto it = queue.begin(); it != queue.end(); ++it)
-            {
-                if (it->get_id() == order.get_id())
-                {
-                    queue.erase(it);
-                    break;
-                }
-            }
+            std::chrono::system_clock::time_point created_at(
+                std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(node->order.timestamp_ns)));
+            queue.emplace_back(node->order.id, node->order.strategy, node->order.quantity, tick_to_price(node->order.tick),
+                               node->order.side, node->order.type, order_pool.details(node).symbol_id, created_at);
+            queue.back().set_status(node->order.status);
+        }
+    }
+    return queue;
+}
 
-            if (queue.empty())
-            {
-                bids.erase(it);
-            }
+MatchResult OrderBook::match_orders(Order &incoming_order)
+{
+    // Match on a compact copy so the level walk only touches RestingOrders.
+    // A market order's price is never read; an invalid limit price becomes
+    // tick 0, which admit() rejects.
+    const Tick tick = incoming_order.get_type() == OrderType::MARKET ? 0 : limit_tick(incoming_order.get_price());
+    RestingOrder taker{incoming_order.get_id(), tick, 0,
+                       incoming_order.get_quantity(), incoming_order.get_side(), incoming_order.get_type(),
+                       incoming_order.get_status(), incoming_order.get_strategy()};
+    MatchResult result;
+    if (!admit(taker, incoming_order.get_symbol_id(), result))
+    {
+        return result;
+    }
+    match_against_book(taker, incoming_order.get_symbol_id(), result);
+    incoming_order.set_quantity(taker.quantity);
+
+    // add unfilled order to book
+    if (taker.quantity > 0 && rests(taker.type))
+    {
+        if (add_order(incoming_order))
+        {
+            result.resting_quantity = taker.quantity;
         }
         else
         {
-            auto it = asks.find(order.get_price());
-            if (it != asks.end())
-            {
-                auto &queue = it->second;
-                for (auto it = queue.begin(); it != queue.end(); ++it)
-                {
-                    if (it->get_id() == order.get_id())
-                    {
-                        queue.erase(it);
-                        break;
-                    }
-                }
-                if (queue.empty())
-                {
-                    asks.erase(it);
-                }
-            }
+            result.rejected = true;
         }
     }
+    else if (taker.quantity > 0)
+    {
+        result.expired_quantity = taker.quantity;
+        publish_done(ExecutionType::EXPIRE, taker, incoming_order.get_symbol_id());
+    }
+    return result;
 }
 
-void OrderBook::update_order_in_book(Order &order)
+void OrderBook::match_orders(OrderNode *node)
 {
-    if (order.get_side() == OrderSide::BUY)
+    const SymbolId symbol_id = order_pool.details(node).symbol_id;
+    MatchResult result;
+    if (!admit(node->order, symbol_id, result))
     {
-        remove_order_from_book(order);
-        add_order_to_book(order);
+        order_pool.release(node);
+        return;
+    }
+    match_against_book(node->order, symbol_id, result);
+
+    // rest the unfilled remainder in place, without copying the order
+    if (node->order.quantity > 0 && rests(node->order.type))
+    {
+        rest_node(node);
     }
     else
     {
-        remove_order_from_book(order);
-        add_order_to_book(order);
+        if (node->order.quantity > 0)
+        {
+            publish_done(ExecutionType::EXPIRE, node->order, symbol_id);
+        }
+        order_pool.release(node);
     }
 }
 
-void OrderBook::match_orders(Order &incoming_order)
+bool OrderBook::admit(const RestingOrder &taker, SymbolId symbol_id, MatchResult &result)
 {
-    if (incoming_order.get_side() == OrderSide::BUY)
+    // Checked before the sweep, so a limit price that could not rest, or an
+    // id that is already resting, is never half executed
+    if (order_index.find(taker.id) ||
+        (taker.type != OrderType::MARKET &&
+         (taker.tick <= 0 || (rests(taker.type) && !ladder_for(taker.side).can_hold(taker.tick)))))
     {
-        for (auto it = asks.begin(); it != asks.end() && incoming_order.get_quantity() > 0;)
-        {
-            double ask_price = it->first;
+        result.rejected = true;
+        publish_done(ExecutionType::REJECT, taker, symbol_id);
+        return false;
+    }
 
-            // limit order
-            if (incoming_order.get_type() == OrderType::LIMIT && incoming_order.get_price() < ask_price)
-            {
-                break;
-            }
+    // Both checks only read the opposite side, so a refused order leaves the book untouched
+    const PriceLadder &makers = taker.side == OrderSide::BUY ? asks : bids;
+    if (taker.type == OrderType::FOK && makers.quantity_through(taker.tick, taker.quantity) < taker.quantity)
+    {
+        result.expired_quantity = taker.quantity;
+        publish_done(ExecutionType::EXPIRE, taker, symbol_id);
+        return false;
+    }
+    if (taker.type == OrderType::POST_ONLY && makers.quantity_through(taker.tick, 1) > 0)
+    {
+        result.rejected = true;
+        publish_done(ExecutionType::REJECT, taker, symbol_id);
+        return false;
+    }
+    return true;
+}
 
-            // market order
-            OrderQueue &ask_queue = it->second;
-            while (!ask_queue.empty() && incoming_order.get_quantity() > 0)
-            {
-                Order &resting_order = ask_queue.front();
+bool OrderBook::rests(OrderType type)
+{
+    return type == OrderType::LIMIT || type == OrderType::POST_ONLY;
+}
 
-                int traded_quantity = std::min(incoming_order.get_quantity(), resting_order.get_quantity());
+namespace
+{
+    // Whether a taker on Side with limit_tick may trade at the opposite touch
+    template <OrderSide Side>
+    constexpr bool crosses(Tick limit_tick, Tick best_tick)
+    {
+        return Side == OrderSide::BUY ? limit_tick >= best_tick : limit_tick <= best_tick;
+    }
 
-                incoming_order.set_quantity(incoming_order.get_quantity() - traded_quantity);
-                resting_order.set_quantity(resting_order.get_quantity() - traded_quantity);
+    static_assert(crosses<OrderSide::BUY>(101, 100) && !crosses<OrderSide::BUY>(99, 100), "Buyers lift asks at or below the limit");
+    static_assert(crosses<OrderSide::SELL>(99, 100) && !crosses<OrderSide::SELL>(101, 100), "Sellers hit bids at or above the limit");
+}
 
-                if (resting_order.get_quantity() == 0)
-                {
-                    ask_queue.pop_front();
-                }
-            }
+void OrderBook::match_against_book(RestingOrder &taker, SymbolId symbol_id, MatchResult &result)
+{
+    // One clock read per incoming order, shared by all of its fills
+    const int64_t timestamp_ns = execution_stream
+                                     ? std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                           std::chrono::system_clock::now().time_since_epoch())
+                                           .count()
+                                     : 0;
 
-            if (ask_queue.empty())
-            {
-                it = asks.erase(it);
-            }
-            else
-            {
-                ++it;
-            }
-        }
+    // The only runtime side and type checks; each kernel has them as constants.
+    // IOC, FOK and post-only carry a limit price like LIMIT and differ only
+    // in what admit() and the caller do around the sweep.
+    const bool limit = taker.type != OrderType::MARKET;
+    if (taker.side == OrderSide::BUY)
+    {
+        limit ? match_kernel<OrderSide::BUY, true>(taker, symbol_id, result, timestamp_ns)
+              : match_kernel<OrderSide::BUY, false>(taker, symbol_id, result, timestamp_ns);
     }
-    else if (incoming_order.get_side() == OrderSide::SELL)
+    else if (taker.side == OrderSide::SELL)
     {
-        for (auto it = bids.begin(); it != bids.end() && incoming_order.get_quantity() > 0;)
-        {
-            double bid_price = it->first;
+        limit ? match_kernel<OrderSide::SELL, true>(taker, symbol_id, result, timestamp_ns)
+              : match_kernel<OrderSide::SELL, false>(taker, symbol_id, result, timestamp_ns);
+    }
+}
 
-            // limit order
-            if (incoming_order.get_type() == OrderType::LIMIT && incoming_order.get_price() > bid_price)
-            {
-                break;
-            }
+template <OrderSide Side, bool Limit>
+void OrderBook::match_kernel(RestingOrder &taker, SymbolId symbol_id, MatchResult &result, int64_t timestamp_ns)
+{
+    constexpr OrderSide maker_side = Side == OrderSide::BUY ? OrderSide::SELL : OrderSide::BUY;
+    PriceLadder &makers = Side == OrderSide::BUY ? asks : bids;
+    const Tick limit_tick = taker.tick;
 
-            // market order
-            OrderQueue &bid_queue = it->second;
-            while (!bid_queue.empty() && incoming_order.get_quantity() > 0)
-            {
-                Order &resting_order = bid_queue.front();
+    while (!makers.empty() && taker.quantity > 0)
+    {
+        const Tick best_tick = makers.best_tick();
+        if (Limit && !crosses<Side>(limit_tick, best_tick))
+        {
+            break;
+        }
 
-                int traded_quantity = std::min(incoming_order.get_quantity(), resting_order.get_quantity());
+        mark_level_changed(maker_side, best_tick);
+        PriceLevel &level = makers.best_level();
+        while (level.head && taker.quantity > 0)
+        {
+            OrderNode *resting = level.head;
+            RestingOrder &resting_order = resting->order;
 
-                incoming_order.set_quantity(incoming_order.get_quantity() - traded_quantity);
-                resting_order.set_quantity(resting_order.get_quantity() - traded_quantity);
+            int traded_quantity = std::min(taker.quantity, resting_order.quantity);
 
-                if (resting_order.get_quantity() == 0)
-                {
-                    bid_queue.pop_front();
-                }
-            }
+            taker.quantity -= traded_quantity;
+            resting_order.quantity -= traded_quantity;
+            level.total_quantity -= traded_quantity;
+            result.filled_quantity += traded_quantity;
+            result.filled_notional_ticks += best_tick * traded_quantity;
+            publish_fill(taker, symbol_id, resting, traded_quantity, timestamp_ns);
 
-            if (bid_queue.empty())
-            {
-                it = bids.erase(it);
-            }
-            else
+            if (resting_order.quantity == 0)
             {
-                ++it;
+                makers.unlink(resting);
+                order_index.erase(resting_order.id);
+                order_pool.release(resting);
             }
         }
     }
+}
 
-    // add unfilled order to book
-    if (incoming_order.get_quantity() > 0 && incoming_order.get_type() == OrderType::LIMIT)
+void OrderBook::publish_fill(const RestingOrder &taker, SymbolId symbol_id, const OrderNode *maker, int quantity, int64_t timestamp_ns)
+{
+    if (!execution_stream)
+    {
+        return;
+    }
+
+    ExecutionEvent event{};
+    event.sequence = execution_stream->published() + 1;
+    event.taker_order_id = taker.id;
+    event.maker_order_id = maker->order.id;
+    event.price = tick_to_price(maker->order.tick);
+    event.quantity = quantity;
+    event.timestamp_ns = timestamp_ns;
+    event.symbol_id = symbol_id;
+    event.taker_side = taker.side;
+    event.type = ExecutionType::FILL;
+    execution_stream->publish(event);
+}
+
+void OrderBook::publish_done(ExecutionType type, const RestingOrder &order, SymbolId symbol_id)
+{
+    if (!execution_stream)
     {
-        add_order(incoming_order);
+        return;
     }
+
+    ExecutionEvent event{};
+    event.sequence = execution_stream->published() + 1;
+    event.taker_order_id = order.id;
+    event.price = tick_to_price(order.tick);
+    event.quantity = order.quantity;
+    event.timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             std::chrono::system_clock::now().time_since_epoch())
+                             .count();
+    event.symbol_id = symbol_id;
+    event.taker_side = order.side;
+    event.type = type;
+    execution_stream->publish(event);
 }
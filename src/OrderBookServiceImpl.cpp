@@ -1,15 +1,29 @@
 #include "OrderBookServiceImpl.h"
+#include "CycleClock.h"
+#include "DepthWindow.h"
+#include "OrderEntrySession.h"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <limits>
 #include <stdexcept>
+#include <thread>
 
-OrderBookServiceImpl::OrderBookServiceImpl()
-    : matching_engine_(std::make_unique<MatchingEngine>()),
-      total_orders_processed_(0),
-      total_requests_received_(0),
-      service_start_time_(std::chrono::steady_clock::now()),
-      current_orders_per_second_(0.0),
-      peak_orders_per_second_(0.0)
+OrderBookServiceImpl::OrderBookServiceImpl(const ShardedEngineConfig &engine_config)
+    : matching_engine_(std::make_unique<ShardedMatchingEngine>(withLatency(engine_config))),
+      order_entry_dispatcher_(std::make_unique<OrderEntryDispatcher>(*matching_engine_)),
+      service_start_time_(std::chrono::steady_clock::now())
 {
+    if (engine_config.engine.journal.recover)
+    {
+        for (size_t shard = 0; shard < matching_engine_->shard_count(); ++shard)
+        {
+            const RecoveryStats &stats = matching_engine_->get_shard(shard).get_recovery_stats();
+            std::cout << "Shard " << shard << " recovered: " << stats.snapshot_orders << " orders from snapshot (sequence "
+                      << stats.snapshot_sequence << "), " << stats.replayed_commands << " journal commands replayed in "
+                      << stats.seconds << " s" << std::endl;
+        }
+    }
     std::cout << "OrderBook gRPC Service initialized" << std::endl;
 }
 
@@ -18,11 +32,40 @@ OrderBookServiceImpl::~OrderBookServiceImpl()
     std::cout << "OrderBook gRPC Service shutting down" << std::endl;
 }
 
+ShardedEngineConfig OrderBookServiceImpl::withLatency(ShardedEngineConfig config)
+{
+    config.engine.latency = &latency_;
+    return config;
+}
+
 grpc::Status OrderBookServiceImpl::SubmitOrder(grpc::ServerContext *context,
                                                const orderbook::SubmitOrderRequest *request,
                                                orderbook::SubmitOrderResponse *response)
 {
-    total_requests_received_.fetch_add(1);
+    const uint64_t received_at = CycleClock::now();
+
+    // Waits on this thread's completion slot until the matching thread is done with the order
+    OrderCompletion &completion = OrderCompletion::for_this_thread();
+    const uint32_t ticket = completion.arm();
+    if (beginSubmitOrder(request, response, completion, ticket, received_at))
+    {
+        OrderOutcome outcome;
+        if (!completion.wait(ticket, outcome, std::chrono::seconds(5)))
+        {
+            response->set_success(false);
+            response->set_message("Timed out waiting for the matching result; the order may still execute");
+            return grpc::Status::OK;
+        }
+        finishSubmitOrder(outcome, received_at, response);
+    }
+    return grpc::Status::OK;
+}
+
+bool OrderBookServiceImpl::beginSubmitOrder(const orderbook::SubmitOrderRequest *request,
+                                            orderbook::SubmitOrderResponse *response, OrderCompletion &completion,
+                                            uint32_t ticket, uint64_t received_at)
+{
+    requests_received_.add();
 
     try
     {
@@ -31,86 +74,166 @@ grpc::Status OrderBookServiceImpl::SubmitOrder(grpc::ServerContext *context,
         OrderSide side = convertOrderSide(request->side());
         OrderType type = convertOrderType(request->type());
 
+        // Nothing to trade; it would still be journaled and use up an id
+        if (request->quantity() <= 0)
+        {
+            response->set_success(false);
+            response->set_message("Quantity must be positive");
+            response->set_order_id(0);
+            return false;
+        }
+
+        // The book rejects these too; answering here saves a trip through the queue
+        if (!std::isfinite(request->price()) || (type != OrderType::MARKET && request->price() <= 0.0))
+        {
+            response->set_success(false);
+            response->set_message("Limit price must be positive and finite");
+            response->set_order_id(0);
+            return false;
+        }
+
         // Create order
-        Order order(strategy, request->quantity(), request->price(), side, type);
+        Order order(strategy, request->quantity(), request->price(), side, type, request->symbol_id());
+
+        if (request->wait_for_result())
+        {
+            // Answered by finishSubmitOrder once the matching thread is done with the order
+            response->set_order_id(order.get_id());
+            matching_engine_->process_order_async(order, completion, ticket, received_at);
+            return true;
+        }
 
-        // Submit to matching engine (lock-free!)
-        matching_engine_->process_order(order);
+        // Submit to the symbol's matching shard (lock-free!)
+        if (!matching_engine_->process_order(order, received_at))
+        {
+            response->set_success(false);
+            response->set_message("Order not accepted: the journal is unavailable");
+            response->set_order_id(0);
+            return false;
+        }
 
-        // Update statistics
-        total_orders_processed_.fetch_add(1);
-        updatePerformanceMetrics();
+        // Update statistics (this thread's own counter; rates come from the sampler)
+        orders_processed_.add();
 
         // Set response
         response->set_success(true);
         response->set_message("Order submitted successfully");
         response->set_order_id(order.get_id());
 
-        return grpc::Status::OK;
+        latency_.record(LatencyStage::ACKED, received_at, CycleClock::now());
+        return false;
     }
     catch (const std::exception &e)
     {
         response->set_success(false);
         response->set_message(std::string("Error submitting order: ") + e.what());
         response->set_order_id(0);
-        return grpc::Status::OK; // Return OK but with error in response
+        return false; // Answer OK but with error in response
     }
 }
 
+void OrderBookServiceImpl::finishSubmitOrder(const OrderOutcome &outcome, uint64_t received_at,
+                                             orderbook::SubmitOrderResponse *response)
+{
+    orders_processed_.add();
+    response->set_success(outcome.status != OrderStatus::REJECTED);
+    response->set_message(outcome.status == OrderStatus::REJECTED ? "Order rejected" : "Order matched");
+    response->set_order_id(outcome.order_id);
+    response->set_filled_quantity(outcome.filled_quantity);
+    response->set_average_price(outcome.average_price);
+    response->set_resting_quantity(outcome.resting_quantity);
+    response->set_status(convertOrderStatus(outcome.status));
+
+    latency_.record(LatencyStage::ACKED, received_at, CycleClock::now());
+}
+
 grpc::Status OrderBookServiceImpl::GetBestBid(grpc::ServerContext *context,
                                               const orderbook::GetBestBidRequest *request,
                                               orderbook::GetBestBidResponse *response)
 {
-    total_requests_received_.fetch_add(1);
-
-    try
-    {
-        // Access the OrderBook directly (we need to expose it in MatchingEngine)
-        // For now, we'll return a placeholder - this needs MatchingEngine API extension
-        response->set_success(false);
-        response->set_message("GetBestBid not yet implemented - requires OrderBook API exposure");
-        response->set_price(0.0);
+    requests_received_.add();
 
-        return grpc::Status::OK;
-    }
-    catch (const std::exception &e)
+    // Lock-free read of what the matching thread last published; never waits on matching
+    TopOfBook top;
+    if (!matching_engine_->get_top_of_book(request->symbol_id(), top) || !top.has_bid)
     {
         response->set_success(false);
-        response->set_message(std::string("Error getting best bid: ") + e.what());
+        response->set_message("No bids available");
         response->set_price(0.0);
         return grpc::Status::OK;
     }
+
+    response->set_success(true);
+    response->set_message("OK");
+    response->set_price(top.bid_price);
+    response->set_quantity(top.bid_quantity);
+    response->set_sequence(top.sequence);
+    return grpc::Status::OK;
 }
 
 grpc::Status OrderBookServiceImpl::GetBestAsk(grpc::ServerContext *context,
                                               const orderbook::GetBestAskRequest *request,
                                               orderbook::GetBestAskResponse *response)
 {
-    total_requests_received_.fetch_add(1);
+    requests_received_.add();
 
-    try
+    TopOfBook top;
+    if (!matching_engine_->get_top_of_book(request->symbol_id(), top) || !top.has_ask)
     {
-        // Similar to GetBestBid - needs OrderBook API exposure
         response->set_success(false);
-        response->set_message("GetBestAsk not yet implemented - requires OrderBook API exposure");
+        response->set_message("No asks available");
         response->set_price(0.0);
-
         return grpc::Status::OK;
     }
-    catch (const std::exception &e)
+
+    response->set_success(true);
+    response->set_message("OK");
+    response->set_price(top.ask_price);
+    response->set_quantity(top.ask_quantity);
+    response->set_sequence(top.sequence);
+    return grpc::Status::OK;
+}
+
+grpc::Status OrderBookServiceImpl::GetDepth(grpc::ServerContext *context,
+                                            const orderbook::GetDepthRequest *request,
+                                            orderbook::GetDepthResponse *response)
+{
+    requests_received_.add();
+
+    // Copied from the book's published depth view; no round trip to the matching thread
+    DepthSnapshot depth;
+    if (!matching_engine_->get_depth(request->symbol_id(), request->levels(), depth))
     {
         response->set_success(false);
-        response->set_message(std::string("Error getting best ask: ") + e.what());
-        response->set_price(0.0);
+        response->set_message("No depth published for symbol");
         return grpc::Status::OK;
     }
+
+    response->set_success(true);
+    response->set_message("OK");
+    response->set_sequence(depth.sequence);
+    for (const DepthLevel &level : depth.bids)
+    {
+        orderbook::DepthLevel *out = response->add_bids();
+        out->set_price(level.price);
+        out->set_quantity(level.quantity);
+        out->set_order_count(level.order_count);
+    }
+    for (const DepthLevel &level : depth.asks)
+    {
+        orderbook::DepthLevel *out = response->add_asks();
+        out->set_price(level.price);
+        out->set_quantity(level.quantity);
+        out->set_order_count(level.order_count);
+    }
+    return grpc::Status::OK;
 }
 
 grpc::Status OrderBookServiceImpl::GetOrdersAtPrice(grpc::ServerContext *context,
                                                     const orderbook::GetOrdersAtPriceRequest *request,
                                                     orderbook::GetOrdersAtPriceResponse *response)
 {
-    total_requests_received_.fetch_add(1);
+    requests_received_.add();
 
     try
     {
@@ -131,28 +254,148 @@ grpc::Status OrderBookServiceImpl::CancelOrder(grpc::ServerContext *context,
                                                const orderbook::CancelOrderRequest *request,
                                                orderbook::CancelOrderResponse *response)
 {
-    total_requests_received_.fetch_add(1);
+    const uint64_t received_at = CycleClock::now();
+
+    OrderCompletion &completion = OrderCompletion::for_this_thread();
+    const uint32_t ticket = completion.arm();
+    if (beginCancelOrder(request, response, completion, ticket, received_at))
+    {
+        OrderOutcome outcome;
+        if (!completion.wait(ticket, outcome, std::chrono::seconds(5)))
+        {
+            response->set_success(false);
+            response->set_message("Timed out waiting for the cancel result; it may still be applied");
+            return grpc::Status::OK;
+        }
+        finishCancelOrder(outcome, received_at, response);
+    }
+    return grpc::Status::OK;
+}
+
+bool OrderBookServiceImpl::beginCancelOrder(const orderbook::CancelOrderRequest *request,
+                                            orderbook::CancelOrderResponse *response, OrderCompletion &completion,
+                                            uint32_t ticket, uint64_t received_at)
+{
+    requests_received_.add();
 
     try
     {
-        response->set_success(false);
-        response->set_message("CancelOrder not yet implemented - requires OrderBook API exposure");
+        if (request->order_id() == 0)
+        {
+            response->set_success(false);
+            response->set_message("Invalid order id");
+            return false;
+        }
 
-        return grpc::Status::OK;
+        // Cancels are sequenced with new orders on the symbol's matching
+        // thread, which finds the order through the book's id index. An
+        // unset symbol_id means symbol 0, so a cancel routed to the wrong
+        // book is reported rather than acknowledged.
+        matching_engine_->cancel_order_async(request->order_id(), request->symbol_id(), completion, ticket,
+                                             received_at);
+        return true;
     }
     catch (const std::exception &e)
     {
         response->set_success(false);
         response->set_message(std::string("Error cancelling order: ") + e.what());
-        return grpc::Status::OK;
+        return false;
     }
 }
 
+void OrderBookServiceImpl::finishCancelOrder(const OrderOutcome &outcome, uint64_t received_at,
+                                             orderbook::CancelOrderResponse *response)
+{
+    const bool cancelled = outcome.status == OrderStatus::CANCELLED;
+    response->set_success(cancelled);
+    response->set_message(cancelled ? "Order cancelled"
+                                    : "Cancel rejected: order not resting on this symbol_id, or the journal is "
+                                      "unavailable");
+    latency_.record(LatencyStage::ACKED, received_at, CycleClock::now());
+}
+
+grpc::Status OrderBookServiceImpl::AmendOrder(grpc::ServerContext *context,
+                                              const orderbook::AmendOrderRequest *request,
+                                              orderbook::AmendOrderResponse *response)
+{
+    const uint64_t received_at = CycleClock::now();
+
+    OrderCompletion &completion = OrderCompletion::for_this_thread();
+    const uint32_t ticket = completion.arm();
+    if (beginAmendOrder(request, response, completion, ticket, received_at))
+    {
+        OrderOutcome outcome;
+        if (!completion.wait(ticket, outcome, std::chrono::seconds(5)))
+        {
+            response->set_success(false);
+            response->set_message("Timed out waiting for the amend result; it may still be applied");
+            return grpc::Status::OK;
+        }
+        finishAmendOrder(outcome, received_at, response);
+    }
+    return grpc::Status::OK;
+}
+
+bool OrderBookServiceImpl::beginAmendOrder(const orderbook::AmendOrderRequest *request,
+                                           orderbook::AmendOrderResponse *response, OrderCompletion &completion,
+                                           uint32_t ticket, uint64_t received_at)
+{
+    requests_received_.add();
+
+    try
+    {
+        if (request->order_id() == 0)
+        {
+            response->set_success(false);
+            response->set_message("Invalid order id");
+            return false;
+        }
+        if (request->quantity() <= 0)
+        {
+            response->set_success(false);
+            response->set_message("Quantity must be positive");
+            return false;
+        }
+        if (!std::isfinite(request->price()) || request->price() <= 0.0)
+        {
+            // An unset price arrives as 0, which must not reprice the order
+            response->set_success(false);
+            response->set_message("Price must be positive and finite");
+            return false;
+        }
+
+        // Sequenced with new orders and cancels on the symbol's matching
+        // thread; the reply reports what the book did with it
+        matching_engine_->amend_order_async(request->order_id(), request->symbol_id(), request->price(),
+                                            request->quantity(), completion, ticket, received_at);
+        return true;
+    }
+    catch (const std::exception &e)
+    {
+        response->set_success(false);
+        response->set_message(std::string("Error amending order: ") + e.what());
+        return false;
+    }
+}
+
+void OrderBookServiceImpl::finishAmendOrder(const OrderOutcome &outcome, uint64_t received_at,
+                                            orderbook::AmendOrderResponse *response)
+{
+    const bool amended = outcome.status != OrderStatus::REJECTED;
+    response->set_success(amended);
+    response->set_message(amended ? "Order amended"
+                                  : "Amend rejected: order not resting, price out of band, post-only would "
+                                    "cross, or the journal is unavailable");
+    response->set_resting_quantity(static_cast<int32_t>(outcome.resting_quantity));
+    response->set_status(convertOrderStatus(outcome.status));
+    latency_.record(LatencyStage::ACKED, received_at, CycleClock::now());
+}
+
 grpc::Status OrderBookServiceImpl::HealthCheck(grpc::ServerContext *context,
                                                const orderbook::HealthCheckRequest *request,
                                                orderbook::HealthCheckResponse *response)
 {
-    total_requests_received_.fetch_add(1);
+    requests_received_.add();
 
     auto uptime = std::chrono::duration_cast<std::chrono::seconds>(
                       std::chrono::steady_clock::now() - service_start_time_)
@@ -162,7 +405,7 @@ grpc::Status OrderBookServiceImpl::HealthCheck(grpc::ServerContext *context,
     response->set_status("Service is running");
     response->set_uptime_seconds(uptime);
     response->set_active_orders(0); // TODO: Implement active order tracking
-    response->set_total_orders_processed(total_orders_processed_.load());
+    response->set_total_orders_processed(orders_processed_.total());
 
     return grpc::Status::OK;
 }
@@ -171,20 +414,198 @@ grpc::Status OrderBookServiceImpl::GetPerformanceStats(grpc::ServerContext *cont
                                                        const orderbook::GetPerformanceStatsRequest *request,
                                                        orderbook::GetPerformanceStatsResponse *response)
 {
-    total_requests_received_.fetch_add(1);
+    requests_received_.add();
 
     auto uptime = std::chrono::duration_cast<std::chrono::seconds>(
                       std::chrono::steady_clock::now() - service_start_time_)
                       .count();
 
+    ThroughputStats orders = orders_processed_.stats();
     response->set_success(true);
-    response->set_total_orders_processed(total_orders_processed_.load());
-    response->set_orders_per_second_current(current_orders_per_second_.load());
-    response->set_orders_per_second_peak(peak_orders_per_second_.load());
-    response->set_queue_depth_current(0); // TODO: Implement queue depth monitoring
-    response->set_queue_depth_max(1024);  // Known queue capacity
+    response->set_total_orders_processed(orders.total);
+    response->set_orders_per_second_current(orders.per_second_1s);
+    response->set_orders_per_second_peak(orders.peak_per_second);
+    response->set_orders_per_second_10s(orders.per_second_10s);
+    response->set_orders_per_second_60s(orders.per_second_60s);
+    response->set_total_requests_received(requests_received_.total());
     response->set_uptime_seconds(uptime);
 
+    EngineStats engine = matching_engine_->get_stats();
+    auto clamp = [](uint64_t value)
+    { return static_cast<int32_t>(std::min<uint64_t>(value, std::numeric_limits<int32_t>::max())); };
+    response->set_queue_depth_current(clamp(engine.queue_depth));
+    response->set_queue_depth_max(clamp(engine.queue_capacity));
+    response->set_journal_queue_depth(clamp(engine.journal_queue_depth));
+    response->set_journal_queue_capacity(clamp(engine.journal_queue_capacity));
+    response->set_batches(engine.batches);
+    response->set_last_batch_size(engine.last_batch_size);
+    response->set_max_batch_size(engine.max_batch_size);
+    response->set_batch_size_limit(engine.batch_size_limit);
+    response->set_journaled_commands(engine.journaled_commands);
+    response->set_journal_syncs(engine.journal_syncs);
+    response->set_snapshots_written(engine.snapshots_written);
+    response->set_journal_failed(engine.journal_failed);
+    response->set_journal_refused(engine.journal_refused);
+
+    // Per-thread histograms are merged here, on the caller's thread
+    for (size_t stage = 0; stage < kLatencyStageCount; ++stage)
+    {
+        LatencyHistogram merged;
+        latency_.merge_stage(static_cast<LatencyStage>(stage), merged);
+
+        orderbook::StageLatency *out = response->add_stage_latencies();
+        out->set_stage(latency_stage_name(static_cast<LatencyStage>(stage)));
+        out->set_count(merged.count());
+        out->set_p50_ns(merged.percentile(0.50));
+        out->set_p99_ns(merged.percentile(0.99));
+        out->set_p999_ns(merged.percentile(0.999));
+        out->set_max_ns(merged.max());
+    }
+
+    return grpc::Status::OK;
+}
+
+grpc::Status OrderBookServiceImpl::SubscribeMarketData(grpc::ServerContext *context,
+                                                       const orderbook::SubscribeMarketDataRequest *request,
+                                                       grpc::ServerWriter<orderbook::MarketDataUpdate> *writer)
+{
+    requests_received_.add();
+
+    const SymbolId symbol_id = request->symbol_id();
+    const MarketDataStream &stream = matching_engine_->get_market_data_stream(symbol_id);
+
+    // This thread only reads the shard's stream; the matching thread never
+    // waits for it. A subscriber that falls a whole ring behind is resynced
+    // with a fresh snapshot. The book is followed at full depth here and cut
+    // to the requested depth per message, so levels moving into the window
+    // are sent as well as those changing inside it.
+    DepthWindow window(request->depth());
+    uint64_t cursor = 0;
+    bool need_snapshot = true;
+    orderbook::MarketDataUpdate update;
+    std::vector<LevelQuantity> bids;
+    std::vector<LevelQuantity> asks;
+    auto write_levels = [&](bool is_snapshot, uint64_t sequence)
+    {
+        update.Clear();
+        update.set_symbol_id(symbol_id);
+        update.set_is_snapshot(is_snapshot);
+        update.set_sequence(sequence);
+        for (const LevelQuantity &level : bids)
+        {
+            orderbook::PriceLevelQuantity *bid = update.add_bids();
+            bid->set_price(level.price);
+            bid->set_quantity(level.quantity);
+        }
+        for (const LevelQuantity &level : asks)
+        {
+            orderbook::PriceLevelQuantity *ask = update.add_asks();
+            ask->set_price(level.price);
+            ask->set_quantity(level.quantity);
+        }
+        return writer->Write(update);
+    };
+
+    while (!context->IsCancelled())
+    {
+        if (need_snapshot)
+        {
+            BookSnapshot snapshot;
+            if (!matching_engine_->get_snapshot(symbol_id, 0, snapshot))
+            {
+                return grpc::Status(grpc::StatusCode::UNAVAILABLE, "Timed out waiting for book snapshot");
+            }
+
+            window.reset(snapshot);
+            window.window(bids, asks);
+            if (!write_levels(true, snapshot.market_data_sequence))
+            {
+                break;
+            }
+            cursor = snapshot.market_data_sequence;
+            need_snapshot = false;
+        }
+
+        LevelUpdate level_update;
+        MarketDataStream::ReadStatus status = stream.read(cursor, level_update);
+        if (status == MarketDataStream::ReadStatus::EMPTY)
+        {
+            // Woken by the matching thread after its next batch; the timeout
+            // only bounds how late a cancelled call is noticed
+            stream.wait(cursor, std::chrono::milliseconds(100));
+            continue;
+        }
+        if (status == MarketDataStream::ReadStatus::LAPPED)
+        {
+            need_snapshot = true;
+            continue;
+        }
+        if (level_update.symbol_id != symbol_id)
+        {
+            continue; // another symbol on the same shard
+        }
+
+        // Accumulate the batch and send what it changed in the window as one message
+        window.apply(level_update);
+        if ((level_update.flags & LevelUpdate::LAST_IN_BATCH) && window.changes(bids, asks) &&
+            !write_levels(false, level_update.sequence))
+        {
+            break;
+        }
+    }
+
+    return grpc::Status::OK;
+}
+
+grpc::Status OrderBookServiceImpl::OrderEntryStream(grpc::ServerContext *context,
+                                                    grpc::ServerReaderWriter<orderbook::OrderEntryResponse, orderbook::OrderEntryRequest> *stream)
+{
+    requests_received_.add();
+
+    // Instructions are pipelined: each gets an immediate ack or reject, and
+    // fills arrive asynchronously on the same stream. Once the client closes
+    // its side, reports keep flowing until the session's orders are done.
+    OrderEntrySession session(*matching_engine_, *order_entry_dispatcher_, *stream);
+    orderbook::OrderEntryRequest request;
+
+    while (stream->Read(&request))
+    {
+        const uint64_t client_order_id = request.client_order_id();
+        try
+        {
+            switch (request.action_case())
+            {
+            case orderbook::OrderEntryRequest::kSubmit:
+            {
+                const orderbook::SubmitOrderRequest &submit = request.submit();
+                Order order(convertStrategy(submit.strategy()), submit.quantity(), submit.price(),
+                            convertOrderSide(submit.side()), convertOrderType(submit.type()), submit.symbol_id());
+                session.submit(client_order_id, order);
+                orders_processed_.add();
+                break;
+            }
+            case orderbook::OrderEntryRequest::kCancel:
+                session.cancel(client_order_id, request.cancel().order_id());
+                break;
+            case orderbook::OrderEntryRequest::kAmend:
+            {
+                const orderbook::AmendOrderRequest &amend = request.amend();
+                session.amend(client_order_id, amend.order_id(), amend.price(), amend.quantity());
+                break;
+            }
+            default:
+                session.reject(client_order_id, "Instruction has no action");
+                break;
+            }
+        }
+        catch (const std::exception &e)
+        {
+            session.reject(client_order_id, std::string("Error handling instruction: ") + e.what());
+        }
+    }
+
+    session.finish([context]
+                   { return context->IsCancelled(); });
     return grpc::Status::OK;
 }
 
@@ -235,6 +656,12 @@ OrderType OrderBookServiceImpl::convertOrderType(orderbook::OrderType proto_type
         return OrderType::MARKET;
     case orderbook::ORDER_TYPE_LIMIT:
         return OrderType::LIMIT;
+    case orderbook::ORDER_TYPE_IOC:
+        return OrderType::IOC;
+    case orderbook::ORDER_TYPE_FOK:
+        return OrderType::FOK;
+    case orderbook::ORDER_TYPE_POST_ONLY:
+        return OrderType::POST_ONLY;
     default:
         return OrderType::LIMIT;
     }
@@ -287,6 +714,12 @@ orderbook::OrderType OrderBookServiceImpl::convertOrderType(OrderType internal_t
         return orderbook::ORDER_TYPE_MARKET;
     case OrderType::LIMIT:
         return orderbook::ORDER_TYPE_LIMIT;
+    case OrderType::IOC:
+        return orderbook::ORDER_TYPE_IOC;
+    case OrderType::FOK:
+        return orderbook::ORDER_TYPE_FOK;
+    case OrderType::POST_ONLY:
+        return orderbook::ORDER_TYPE_POST_ONLY;
     default:
         return orderbook::ORDER_TYPE_LIMIT;
     }
@@ -307,22 +740,4 @@ orderbook::OrderStatus OrderBookServiceImpl::convertOrderStatus(OrderStatus inte
     default:
         return orderbook::ORDER_STATUS_PENDING;
     }
-}
-
-void OrderBookServiceImpl::updatePerformanceMetrics()
-{
-    auto now = std::chrono::steady_clock::now();
-    auto uptime = std::chrono::duration_cast<std::chrono::seconds>(now - service_start_time_).count();
-
-    if (uptime > 0)
-    {
-        double current_rate = static_cast<double>(total_orders_processed_.load()) / uptime;
-        current_orders_per_second_.store(current_rate);
-
-        double peak = peak_orders_per_second_.load();
-        if (current_rate > peak)
-        {
-            peak_orders_per_second_.store(current_rate);
-        }
-    }
 }
\ No newline at end of file
@@ -1,7 +1,10 @@
 #pragma once
 
 #include "orderbook_service.grpc.pb.h"
-#include "MatchingEngine.h"
+#include "LatencyHistogram.h"
+#include "OrderEntryDispatcher.h"
+#include "ShardedMatchingEngine.h"
+#include "ThroughputMeter.h"
 #include <grpc++/grpc++.h>
 #include <memory>
 #include <atomic>
@@ -10,7 +13,7 @@
 class OrderBookServiceImpl final : public orderbook::OrderBookService::Service
 {
 public:
-    OrderBookServiceImpl();
+    explicit OrderBookServiceImpl(const ShardedEngineConfig &engine_config = ShardedEngineConfig());
     ~OrderBookServiceImpl();
 
     // gRPC service method implementations
@@ -26,6 +29,10 @@ public:
                             const orderbook::GetBestAskRequest *request,
                             orderbook::GetBestAskResponse *response) override;
 
+    grpc::Status GetDepth(grpc::ServerContext *context,
+                          const orderbook::GetDepthRequest *request,
+                          orderbook::GetDepthResponse *response) override;
+
     grpc::Status GetOrdersAtPrice(grpc::ServerContext *context,
                                   const orderbook::GetOrdersAtPriceRequest *request,
                                   orderbook::GetOrdersAtPriceResponse *response) override;
@@ -34,6 +41,10 @@ public:
                              const orderbook::CancelOrderRequest *request,
                              orderbook::CancelOrderResponse *response) override;
 
+    grpc::Status AmendOrder(grpc::ServerContext *context,
+                            const orderbook::AmendOrderRequest *request,
+                            orderbook::AmendOrderResponse *response) override;
+
     grpc::Status HealthCheck(grpc::ServerContext *context,
                              const orderbook::HealthCheckRequest *request,
                              orderbook::HealthCheckResponse *response) override;
@@ -42,18 +53,46 @@ public:
                                      const orderbook::GetPerformanceStatsRequest *request,
                                      orderbook::GetPerformanceStatsResponse *response) override;
 
+    grpc::Status SubscribeMarketData(grpc::ServerContext *context,
+                                     const orderbook::SubscribeMarketDataRequest *request,
+                                     grpc::ServerWriter<orderbook::MarketDataUpdate> *writer) override;
+
+    grpc::Status OrderEntryStream(grpc::ServerContext *context,
+                                  grpc::ServerReaderWriter<orderbook::OrderEntryResponse, orderbook::OrderEntryRequest> *stream) override;
+
+    // The writes that report a matching result, split in two so a caller can
+    // answer from the completion instead of blocking on it. begin* either
+    // fills the response at once and returns false, or submits the command to
+    // publish its outcome to completion under ticket and returns true; the
+    // caller then passes that outcome to finish* to fill the response.
+    bool beginSubmitOrder(const orderbook::SubmitOrderRequest *request, orderbook::SubmitOrderResponse *response,
+                          OrderCompletion &completion, uint32_t ticket, uint64_t received_at);
+    void finishSubmitOrder(const OrderOutcome &outcome, uint64_t received_at, orderbook::SubmitOrderResponse *response);
+
+    bool beginCancelOrder(const orderbook::CancelOrderRequest *request, orderbook::CancelOrderResponse *response,
+                          OrderCompletion &completion, uint32_t ticket, uint64_t received_at);
+    void finishCancelOrder(const OrderOutcome &outcome, uint64_t received_at, orderbook::CancelOrderResponse *response);
+
+    bool beginAmendOrder(const orderbook::AmendOrderRequest *request, orderbook::AmendOrderResponse *response,
+                         OrderCompletion &completion, uint32_t ticket, uint64_t received_at);
+    void finishAmendOrder(const OrderOutcome &outcome, uint64_t received_at, orderbook::AmendOrderResponse *response);
+
 private:
-    // Core order book engine
-    std::unique_ptr<MatchingEngine> matching_engine_;
+    // Stage latencies recorded by the handlers and every shard; declared
+    // first so it outlives the matching threads that record into it
+    LatencyRecorder latency_;
 
-    // Service statistics
-    std::atomic<uint64_t> total_orders_processed_;
-    std::atomic<uint64_t> total_requests_received_;
-    std::chrono::steady_clock::time_point service_start_time_;
+    // Core order book engine; routes each symbol to its matching shard
+    std::unique_ptr<ShardedMatchingEngine> matching_engine_;
 
-    // Performance tracking
-    std::atomic<double> current_orders_per_second_;
-    std::atomic<double> peak_orders_per_second_;
+    // Hands each shard's execution events to the OrderEntryStream sessions
+    // that own the orders; stopped before the engine it reads from
+    std::unique_ptr<OrderEntryDispatcher> order_entry_dispatcher_;
+
+    // Service statistics; each handler thread counts into its own slot
+    ThroughputMeter orders_processed_;
+    ThroughputMeter requests_received_;
+    std::chrono::steady_clock::time_point service_start_time_;
 
     // Helper methods for conversion between protobuf and internal types
     Strategy convertStrategy(orderbook::Strategy proto_strategy);
@@ -65,6 +104,5 @@ private:
     orderbook::OrderType convertOrderType(OrderType internal_type);
     orderbook::OrderStatus convertOrderStatus(OrderStatus internal_status);
 
-    // Performance monitoring
-    void updatePerformanceMetrics();
+    ShardedEngineConfig withLatency(ShardedEngineConfig config);
 };
\ No newline at end of file
@@ -0,0 +1,155 @@
+#include "OrderCompletion.h"
+#include "PerThreadSlots.h"
+#include "WaitStrategy.h"
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // Matching usually finishes within a few microseconds; spin through that
+    // before paying for a futex sleep and wake-up
+    constexpr int kSpinIterations = 2000;
+}
+
+OrderCompletion::OrderCompletion(CompletionListener *listener)
+    : state_(ABANDONED),
+      sleeping_(false),
+      listener_(listener)
+{
+}
+
+OrderCompletion &OrderCompletion::for_this_thread()
+{
+    // Never destroyed, so a completion arriving during exit still finds its slot
+    static PerThreadSlots<OrderCompletion> &slots = *new PerThreadSlots<OrderCompletion>();
+
+    // Destroyed before the claim made by local(), so the slot is handed back
+    // with no ticket pending
+    struct Release
+    {
+        OrderCompletion *completion;
+
+        ~Release()
+        {
+            uint32_t state = completion->state_.load(std::memory_order_relaxed);
+            if ((state & 3) == PENDING)
+            {
+                // Fails only if a completion got there first, which leaves it DONE
+                completion->state_.compare_exchange_strong(state, (state & ~3u) | ABANDONED,
+                                                           std::memory_order_relaxed);
+            }
+        }
+    };
+    thread_local OrderCompletion &completion = slots.local();
+    thread_local Release release{&completion};
+    return completion;
+}
+
+uint32_t OrderCompletion::arm()
+{
+    // Only the owning thread arms, and never while a completion is mid-write
+    uint32_t ticket = (state_.load(std::memory_order_relaxed) >> 2) + 1;
+    state_.store(ticket << 2 | PENDING, std::memory_order_relaxed);
+    return ticket;
+}
+
+void OrderCompletion::complete(uint32_t ticket, const OrderOutcome &outcome)
+{
+    uint32_t expected = ticket << 2 | PENDING;
+    if (!state_.compare_exchange_strong(expected, ticket << 2 | WRITING, std::memory_order_acquire))
+    {
+        return; // the submitter gave up on this ticket
+    }
+    outcome_ = outcome;
+    state_.store(ticket << 2 | DONE, std::memory_order_release);
+
+    if (listener_)
+    {
+        listener_->completed(*this);
+        return;
+    }
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping_.load(std::memory_order_relaxed))
+    {
+        wake();
+    }
+}
+
+bool OrderCompletion::wait(uint32_t ticket, OrderOutcome &outcome, std::chrono::microseconds timeout)
+{
+    const uint32_t pending = ticket << 2 | PENDING;
+    const uint32_t done = ticket << 2 | DONE;
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+
+    for (int spin = 0;; ++spin)
+    {
+        uint32_t state = state_.load(std::memory_order_acquire);
+        if (state == done)
+        {
+            outcome = outcome_;
+            return true;
+        }
+        if (state != pending || spin < kSpinIterations)
+        {
+            cpu_relax(); // still spinning, or the matching thread is mid-write
+            continue;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (now >= deadline)
+        {
+            uint32_t expected = pending;
+            if (state_.compare_exchange_strong(expected, ticket << 2 | ABANDONED, std::memory_order_relaxed))
+            {
+                return false;
+            }
+            continue; // lost the race to a completion; it is being written now
+        }
+
+        sleeping_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (state_.load(std::memory_order_relaxed) == pending)
+        {
+            sleep(pending, deadline - now);
+        }
+        sleeping_.store(false, std::memory_order_relaxed);
+    }
+}
+
+bool OrderCompletion::take(uint32_t ticket, OrderOutcome &outcome) const
+{
+    if (state_.load(std::memory_order_acquire) != (ticket << 2 | DONE))
+    {
+        return false;
+    }
+    outcome = outcome_;
+    return true;
+}
+
+void OrderCompletion::sleep(uint32_t expected, std::chrono::nanoseconds timeout)
+{
+#ifdef __linux__
+    timespec relative;
+    relative.tv_sec = static_cast<time_t>(timeout.count() / 1000000000);
+    relative.tv_nsec = static_cast<long>(timeout.count() % 1000000000);
+    // Returns at once if the state moved on since we checked it
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(&state_), FUTEX_WAIT_PRIVATE, expected, &relative, nullptr, 0);
+#else
+    (void)expected;
+    (void)timeout;
+    std::this_thread::yield();
+#endif
+}
+
+void OrderCompletion::wake()
+{
+#ifdef __linux__
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(&state_), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#endif
+}
@@ -0,0 +1,115 @@
+#include "OrderEntryDispatcher.h"
+#include "OrderEntrySession.h"
+
+#include <chrono>
+
+OrderEntryDispatcher::OrderEntryDispatcher(ShardedMatchingEngine &engine)
+    : engine_(engine),
+      stop_(false)
+{
+    // Only events published from now on can concern a session's orders
+    for (size_t shard = 0; shard < engine_.shard_count(); ++shard)
+    {
+        shards_.push_back(std::make_unique<Shard>());
+        shards_.back()->cursor = engine_.get_shard(shard).get_execution_stream().published();
+    }
+    for (size_t shard = 0; shard < shards_.size(); ++shard)
+    {
+        shards_[shard]->thread = std::thread(&OrderEntryDispatcher::dispatch_loop, this, shard);
+    }
+}
+
+OrderEntryDispatcher::~OrderEntryDispatcher()
+{
+    stop_.store(true);
+    for (auto &shard : shards_)
+    {
+        if (shard->thread.joinable())
+        {
+            shard->thread.join();
+        }
+    }
+}
+
+void OrderEntryDispatcher::attach(OrderEntrySession &session)
+{
+    for (auto &shard : shards_)
+    {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        shard->sessions.insert(&session);
+    }
+}
+
+void OrderEntryDispatcher::detach(OrderEntrySession &session)
+{
+    for (auto &shard : shards_)
+    {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        shard->sessions.erase(&session);
+    }
+}
+
+void OrderEntryDispatcher::route(uint64_t order_id, SymbolId symbol_id, OrderEntrySession &session)
+{
+    Shard &shard = *shards_[engine_.shard_for(symbol_id)];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.owners[order_id] = &session;
+}
+
+void OrderEntryDispatcher::unroute(uint64_t order_id, SymbolId symbol_id)
+{
+    Shard &shard = *shards_[engine_.shard_for(symbol_id)];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.owners.erase(order_id);
+}
+
+void OrderEntryDispatcher::dispatch_loop(size_t index)
+{
+    Shard &shard = *shards_[index];
+    const ExecutionStream &stream = engine_.get_shard(index).get_execution_stream();
+
+    while (!stop_.load())
+    {
+        if (stream.published() <= shard.cursor)
+        {
+            // The shard wakes this after a batch; the timeout only bounds how
+            // late a stop is noticed
+            stream.wait(shard.cursor, std::chrono::milliseconds(100));
+            continue;
+        }
+
+        // Everything published so far is handed out under one lock hold
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        ExecutionEvent event;
+        ExecutionStream::ReadStatus status;
+        while ((status = stream.read(shard.cursor, event)) != ExecutionStream::ReadStatus::EMPTY)
+        {
+            if (status == ExecutionStream::ReadStatus::LAPPED)
+            {
+                for (OrderEntrySession *session : shard.sessions)
+                {
+                    session->lost_reports(index);
+                }
+                continue;
+            }
+
+            OrderEntrySession *taker = nullptr;
+            auto owner = shard.owners.find(event.taker_order_id);
+            if (owner != shard.owners.end())
+            {
+                taker = owner->second;
+                taker->deliver(index, event);
+            }
+            if (event.type == ExecutionType::FILL)
+            {
+                // The maker may belong to another session, or to the same one,
+                // which reports both sides from a single delivery
+                owner = shard.owners.find(event.maker_order_id);
+                if (owner != shard.owners.end() && owner->second != taker)
+                {
+                    owner->second->deliver(index, event);
+                }
+            }
+        }
+    }
+}
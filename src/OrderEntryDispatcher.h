@@ -0,0 +1,54 @@
+#pragma once
+
+#include "ShardedMatchingEngine.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class OrderEntrySession;
+
+// Follows every shard's execution stream for all OrderEntryStream calls at
+// once: one thread per shard reads each event a single time and hands it to
+// the session that owns the order it names, found through an order id map.
+// A session routes an order before submitting it and unroutes it once
+// nothing more can be reported for it. Delivery only queues the event on the
+// session, so a slow client never holds up the other sessions on a shard.
+// If a shard's thread is lapped, every attached session is told to reconcile
+// its orders on that shard.
+class OrderEntryDispatcher
+{
+public:
+    explicit OrderEntryDispatcher(ShardedMatchingEngine &engine);
+    ~OrderEntryDispatcher();
+
+    OrderEntryDispatcher(const OrderEntryDispatcher &) = delete;
+    OrderEntryDispatcher &operator=(const OrderEntryDispatcher &) = delete;
+
+    void attach(OrderEntrySession &session);
+    // Once detach returns no more events reach the session; its orders must
+    // have been unrouted first
+    void detach(OrderEntrySession &session);
+
+    void route(uint64_t order_id, SymbolId symbol_id, OrderEntrySession &session);
+    void unroute(uint64_t order_id, SymbolId symbol_id);
+
+private:
+    struct Shard
+    {
+        std::mutex mutex; // guards owners and sessions; held while delivering
+        std::unordered_map<uint64_t, OrderEntrySession *> owners; // by order id
+        std::unordered_set<OrderEntrySession *> sessions;        // told about gaps
+        uint64_t cursor;
+        std::thread thread;
+    };
+
+    ShardedMatchingEngine &engine_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::atomic<bool> stop_;
+
+    void dispatch_loop(size_t shard);
+};
@@ -0,0 +1,578 @@
+#include "OrderEntrySession.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+OrderEntrySession::OrderEntrySession(ShardedMatchingEngine &engine, OrderEntryDispatcher &dispatcher, Stream &stream)
+    : engine_(engine),
+      dispatcher_(dispatcher),
+      stream_(stream),
+      gap_queued_(engine.shard_count(), false),
+      max_queued_(engine.get_shard(0).get_execution_stream().capacity()),
+      stop_reporter_(false)
+{
+    reporter_thread_ = std::thread(&OrderEntrySession::report_loop, this);
+    dispatcher_.attach(*this);
+}
+
+OrderEntrySession::~OrderEntrySession()
+{
+    {
+        // Nothing may be delivered once the session is gone
+        std::lock_guard<std::mutex> lock(live_mutex_);
+        for (const auto &routed : routed_)
+        {
+            dispatcher_.unroute(routed.first, routed.second);
+        }
+        routed_.clear();
+    }
+    dispatcher_.detach(*this);
+
+    {
+        std::lock_guard<std::mutex> lock(inbox_mutex_);
+        stop_reporter_ = true;
+    }
+    inbox_ready_.notify_one();
+    if (reporter_thread_.joinable())
+    {
+        reporter_thread_.join();
+    }
+}
+
+void OrderEntrySession::submit(uint64_t client_order_id, Order &order)
+{
+    if (order.get_quantity() <= 0)
+    {
+        reject(client_order_id, "Quantity must be positive");
+        return;
+    }
+    if (!std::isfinite(order.get_price()) || (order.get_type() != OrderType::MARKET && order.get_price() <= 0.0))
+    {
+        reject(client_order_id, "Limit price must be positive and finite");
+        return;
+    }
+
+    {
+        // Registered and routed before submitting so no fill can arrive for
+        // an unknown order
+        std::lock_guard<std::mutex> lock(live_mutex_);
+        live_orders_.emplace(order.get_id(), LiveOrder{client_order_id, order, false, 0});
+        routed_.emplace(order.get_id(), order.get_symbol_id());
+        dispatcher_.route(order.get_id(), order.get_symbol_id(), *this);
+    }
+
+    orderbook::OrderEntryResponse response;
+    response.set_client_order_id(client_order_id);
+    response.set_type(orderbook::REPORT_ACK);
+    response.set_order_id(order.get_id());
+    response.set_price(order.get_price());
+    response.set_leaves_quantity(order.get_quantity());
+
+    bool accepted;
+    {
+        // Acked only once the engine has taken the order. The write lock is
+        // held across queueing, so the reporter cannot write the order's
+        // fills ahead of its ack; the matching thread never waits on it.
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        accepted = engine_.process_order(order);
+        if (accepted)
+        {
+            stream_.Write(response);
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(live_mutex_);
+        auto it = live_orders_.find(order.get_id());
+        if (!accepted && it != live_orders_.end())
+        {
+            live_orders_.erase(it);
+            retire(order.get_id());
+        }
+        else if (it != live_orders_.end())
+        {
+            it->second.queued = true;
+        }
+    }
+    if (!accepted)
+    {
+        reject(client_order_id, "Order not accepted: the journal is unavailable");
+    }
+}
+
+void OrderEntrySession::cancel(uint64_t client_order_id, uint64_t order_id)
+{
+    bool known;
+    SymbolId symbol_id = 0;
+    {
+        std::lock_guard<std::mutex> lock(live_mutex_);
+        auto it = live_orders_.find(order_id);
+        known = it != live_orders_.end();
+        if (known)
+        {
+            symbol_id = it->second.order.get_symbol_id();
+            pending_cancels_[order_id].push_back(client_order_id);
+        }
+    }
+    if (!known)
+    {
+        reject(client_order_id, "Unknown order id for this session");
+        return;
+    }
+
+    orderbook::OrderEntryResponse response;
+    response.set_client_order_id(client_order_id);
+    response.set_type(orderbook::REPORT_ACK);
+    response.set_order_id(order_id);
+
+    // The CANCELLED report follows from the execution stream once the
+    // matching thread has removed the order, or a REJECT if it was gone.
+    // Acked only once queued, under the write lock as submit does.
+    bool accepted;
+    {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        accepted = engine_.cancel_order(order_id, symbol_id);
+        if (accepted)
+        {
+            stream_.Write(response);
+        }
+    }
+    if (!accepted)
+    {
+        {
+            std::lock_guard<std::mutex> lock(live_mutex_);
+            auto pending = pending_cancels_.find(order_id);
+            pending->second.pop_back();
+            if (pending->second.empty())
+            {
+                pending_cancels_.erase(pending);
+            }
+            retire(order_id);
+        }
+        reject(client_order_id, "Cancel not accepted: the journal is unavailable");
+    }
+}
+
+void OrderEntrySession::amend(uint64_t client_order_id, uint64_t order_id, double price, int quantity)
+{
+    if (quantity <= 0)
+    {
+        reject(client_order_id, "Quantity must be positive");
+        return;
+    }
+    if (!std::isfinite(price) || price <= 0.0)
+    {
+        // An unset price arrives as 0, which must not reprice the order
+        reject(client_order_id, "Price must be positive and finite");
+        return;
+    }
+
+    bool known;
+    SymbolId symbol_id = 0;
+    {
+        // The live order only changes when the book's REPLACE comes back, so
+        // fills sequenced before the amend still count down the old quantity
+        std::lock_guard<std::mutex> lock(live_mutex_);
+        auto it = live_orders_.find(order_id);
+        known = it != live_orders_.end();
+        if (known)
+        {
+            symbol_id = it->second.order.get_symbol_id();
+            pending_amends_[order_id].push_back(client_order_id);
+        }
+    }
+    if (!known)
+    {
+        reject(client_order_id, "Unknown order id for this session");
+        return;
+    }
+
+    if (!engine_.amend_order(order_id, symbol_id, price, quantity))
+    {
+        {
+            std::lock_guard<std::mutex> lock(live_mutex_);
+            auto pending = pending_amends_.find(order_id);
+            pending->second.pop_back();
+            if (pending->second.empty())
+            {
+                pending_amends_.erase(pending);
+            }
+            retire(order_id);
+        }
+        reject(client_order_id, "Amend not accepted: the journal is unavailable");
+    }
+}
+
+void OrderEntrySession::reject(uint64_t client_order_id, const std::string &reason)
+{
+    orderbook::OrderEntryResponse response;
+    response.set_client_order_id(client_order_id);
+    response.set_type(orderbook::REPORT_REJECT);
+    response.set_message(reason);
+    write(response);
+}
+
+void OrderEntrySession::finish(const std::function<bool()> &cancelled)
+{
+    std::unique_lock<std::mutex> lock(live_mutex_);
+    while (!live_orders_.empty() || !pending_amends_.empty() || !pending_cancels_.empty())
+    {
+        if (cancelled())
+        {
+            return;
+        }
+        // The timeout only bounds how late a cancelled call is noticed
+        reported_.wait_for(lock, std::chrono::milliseconds(100));
+    }
+}
+
+void OrderEntrySession::deliver(size_t shard, const ExecutionEvent &event)
+{
+    std::lock_guard<std::mutex> lock(inbox_mutex_);
+    if (gap_queued_[shard])
+    {
+        return;
+    }
+    if (inbox_.size() >= max_queued_)
+    {
+        // The client is not keeping up; catch up from the book instead
+        gap_queued_[shard] = true;
+        queue(Report{ExecutionEvent(), shard, true});
+        return;
+    }
+    queue(Report{event, shard, false});
+}
+
+void OrderEntrySession::lost_reports(size_t shard)
+{
+    std::lock_guard<std::mutex> lock(inbox_mutex_);
+    if (!gap_queued_[shard])
+    {
+        gap_queued_[shard] = true;
+        queue(Report{ExecutionEvent(), shard, true});
+    }
+}
+
+void OrderEntrySession::queue(const Report &report)
+{
+    inbox_.push_back(report);
+    if (inbox_.size() == 1)
+    {
+        inbox_ready_.notify_one(); // the reporter only sleeps on an empty inbox
+    }
+}
+
+void OrderEntrySession::report_loop()
+{
+    std::deque<Report> reports;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(inbox_mutex_);
+            inbox_ready_.wait(lock, [this]
+                              { return stop_reporter_ || !inbox_.empty(); });
+            if (stop_reporter_)
+            {
+                return;
+            }
+            reports.swap(inbox_);
+        }
+
+        for (const Report &report : reports)
+        {
+            if (!report.gap)
+            {
+                handle_event(report.event);
+                continue;
+            }
+            {
+                // Events from here on are queued again; the lookups in
+                // reconcile run after this and cover every one dropped
+                std::lock_guard<std::mutex> lock(inbox_mutex_);
+                gap_queued_[report.shard] = false;
+            }
+            orderbook::OrderEntryResponse response;
+            response.set_type(orderbook::REPORT_GAP);
+            response.set_message("Execution reports were lost; each open order's state follows");
+            write(response);
+            reconcile(report.shard);
+        }
+        reports.clear();
+        reported_.notify_all();
+    }
+}
+
+void OrderEntrySession::reconcile(size_t shard)
+{
+    struct Lookup
+    {
+        uint64_t order_id;
+        SymbolId symbol_id;
+        size_t amends;  // amends already queued, whose results may be lost too
+        size_t cancels; // likewise for cancels
+    };
+    std::vector<Lookup> orders;
+    {
+        std::lock_guard<std::mutex> lock(live_mutex_);
+        for (const auto &entry : live_orders_)
+        {
+            const Order &order = entry.second.order;
+            if (entry.second.queued && engine_.shard_for(order.get_symbol_id()) == shard)
+            {
+                auto amends = pending_amends_.find(entry.first);
+                auto cancels = pending_cancels_.find(entry.first);
+                orders.push_back(Lookup{entry.first, order.get_symbol_id(),
+                                        amends == pending_amends_.end() ? 0 : amends->second.size(),
+                                        cancels == pending_cancels_.end() ? 0 : cancels->second.size()});
+            }
+        }
+    }
+
+    // Each lookup runs in sequence on the matching thread, so it reflects
+    // exactly the events up to its execution_sequence; older ones are skipped
+    for (const Lookup &order : orders)
+    {
+        OrderOutcome outcome;
+        if (!engine_.query_order(order.order_id, order.symbol_id, outcome, std::chrono::seconds(1)))
+        {
+            continue;
+        }
+
+        orderbook::OrderEntryResponse response;
+        {
+            std::lock_guard<std::mutex> lock(live_mutex_);
+            // The lookup states the result of the earlier amends and cancels;
+            // any of their reports still to come are ignored rather than awaited
+            settle_pending(pending_amends_, order.order_id, order.amends);
+            settle_pending(pending_cancels_, order.order_id, order.cancels);
+
+            auto it = live_orders_.find(order.order_id);
+            if (it == live_orders_.end())
+            {
+                retire(order.order_id);
+                continue;
+            }
+            response.set_client_order_id(it->second.client_order_id);
+            response.set_price(it->second.order.get_price());
+            if (outcome.status == OrderStatus::PENDING)
+            {
+                it->second.order.set_quantity(static_cast<int>(outcome.resting_quantity));
+                it->second.reconciled_through = outcome.execution_sequence;
+                response.set_leaves_quantity(static_cast<int32_t>(outcome.resting_quantity));
+                response.set_message("Order state after lost reports: still resting");
+            }
+            else
+            {
+                live_orders_.erase(it);
+                retire(order.order_id);
+                response.set_leaves_quantity(0);
+                response.set_message("Order state after lost reports: no longer in the book");
+            }
+        }
+        response.set_type(orderbook::REPORT_GAP);
+        response.set_order_id(order.order_id);
+        response.set_execution_sequence(outcome.execution_sequence);
+        write(response);
+    }
+}
+
+void OrderEntrySession::handle_event(const ExecutionEvent &event)
+{
+    if (event.type == ExecutionType::FILL)
+    {
+        // Both sides may belong to this session
+        report_fill(event.taker_order_id, event, false);
+        report_fill(event.maker_order_id, event, true);
+        return;
+    }
+    if (event.type == ExecutionType::REPLACE || event.type == ExecutionType::REPLACE_REJECT)
+    {
+        report_amend(event);
+        return;
+    }
+    if (event.type == ExecutionType::CANCEL_REJECT)
+    {
+        report_cancel_reject(event);
+        return;
+    }
+
+    orderbook::OrderEntryResponse response;
+    {
+        std::lock_guard<std::mutex> lock(live_mutex_);
+        if (event.type == ExecutionType::CANCEL)
+        {
+            // The oldest pending cancel is the one that removed it; its ack was the report
+            settle_pending(pending_cancels_, event.taker_order_id, 1);
+        }
+        auto it = live_orders_.find(event.taker_order_id);
+        if (it == live_orders_.end() || event.sequence <= it->second.reconciled_through)
+        {
+            retire(event.taker_order_id);
+            return;
+        }
+        response.set_client_order_id(it->second.client_order_id);
+        live_orders_.erase(it);
+        retire(event.taker_order_id);
+    }
+
+    switch (event.type)
+    {
+    case ExecutionType::CANCEL:
+        response.set_type(orderbook::REPORT_CANCELLED);
+        break;
+    case ExecutionType::REJECT:
+        response.set_type(orderbook::REPORT_REJECT);
+        response.set_message("Rejected before matching: invalid or out-of-band price, or post-only would cross");
+        break;
+    default:
+        response.set_type(orderbook::REPORT_EXPIRED);
+        break;
+    }
+    response.set_order_id(event.taker_order_id);
+    response.set_price(event.price);
+    response.set_quantity(static_cast<int32_t>(event.quantity));
+    response.set_leaves_quantity(0);
+    response.set_execution_sequence(event.sequence);
+    write(response);
+}
+
+void OrderEntrySession::report_fill(uint64_t order_id, const ExecutionEvent &event, bool is_maker)
+{
+    orderbook::OrderEntryResponse response;
+    {
+        std::lock_guard<std::mutex> lock(live_mutex_);
+        auto it = live_orders_.find(order_id);
+        if (it == live_orders_.end() || event.sequence <= it->second.reconciled_through)
+        {
+            return;
+        }
+
+        Order &order = it->second.order;
+        order.set_quantity(order.get_quantity() - static_cast<int>(event.quantity));
+        response.set_client_order_id(it->second.client_order_id);
+        response.set_leaves_quantity(order.get_quantity());
+        if (order.get_quantity() <= 0)
+        {
+            live_orders_.erase(it);
+            retire(order_id);
+        }
+    }
+
+    response.set_type(orderbook::REPORT_FILL);
+    response.set_order_id(order_id);
+    response.set_price(event.price);
+    response.set_quantity(static_cast<int32_t>(event.quantity));
+    response.set_is_maker(is_maker);
+    response.set_execution_sequence(event.sequence);
+    write(response);
+}
+
+void OrderEntrySession::report_amend(const ExecutionEvent &event)
+{
+    orderbook::OrderEntryResponse response;
+    {
+        std::lock_guard<std::mutex> lock(live_mutex_);
+        auto it = live_orders_.find(event.taker_order_id);
+        auto pending = pending_amends_.find(event.taker_order_id);
+        if (pending == pending_amends_.end())
+        {
+            // Not this session's amend: either another session's order, or
+            // one of ours amended through the unary AmendOrder, whose caller
+            // already has the answer. A replace still changes what is open.
+            if (event.type != ExecutionType::REPLACE || it == live_orders_.end() ||
+                event.sequence <= it->second.reconciled_through)
+            {
+                return;
+            }
+            response.set_client_order_id(it->second.client_order_id);
+        }
+        else
+        {
+            response.set_client_order_id(pending->second.front());
+            settle_pending(pending_amends_, event.taker_order_id, 1);
+            retire(event.taker_order_id);
+        }
+
+        if (event.type == ExecutionType::REPLACE && it != live_orders_.end() &&
+            event.sequence > it->second.reconciled_through)
+        {
+            it->second.client_order_id = response.client_order_id();
+            it->second.order.set_price(event.price);
+            it->second.order.set_quantity(static_cast<int>(event.quantity));
+        }
+    }
+
+    if (event.type == ExecutionType::REPLACE)
+    {
+        response.set_type(orderbook::REPORT_REPLACED);
+        response.set_leaves_quantity(static_cast<int32_t>(event.quantity));
+    }
+    else
+    {
+        response.set_type(orderbook::REPORT_REJECT);
+        response.set_message("Amend rejected: order not resting, price out of band, or post-only would cross");
+    }
+    response.set_order_id(event.taker_order_id);
+    response.set_price(event.price);
+    response.set_execution_sequence(event.sequence);
+    write(response);
+}
+
+void OrderEntrySession::report_cancel_reject(const ExecutionEvent &event)
+{
+    orderbook::OrderEntryResponse response;
+    {
+        std::lock_guard<std::mutex> lock(live_mutex_);
+        auto pending = pending_cancels_.find(event.taker_order_id);
+        if (pending == pending_cancels_.end())
+        {
+            return; // another session's order
+        }
+        response.set_client_order_id(pending->second.front());
+        settle_pending(pending_cancels_, event.taker_order_id, 1);
+        retire(event.taker_order_id);
+    }
+
+    response.set_type(orderbook::REPORT_REJECT);
+    response.set_message("Cancel rejected: order no longer resting");
+    response.set_order_id(event.taker_order_id);
+    response.set_execution_sequence(event.sequence);
+    write(response);
+}
+
+void OrderEntrySession::settle_pending(std::unordered_map<uint64_t, std::deque<uint64_t>> &pending_by_order,
+                                       uint64_t order_id, size_t count)
+{
+    auto pending = pending_by_order.find(order_id);
+    if (pending == pending_by_order.end())
+    {
+        return;
+    }
+    const size_t settled = std::min(count, pending->second.size());
+    pending->second.erase(pending->second.begin(), pending->second.begin() + settled);
+    if (pending->second.empty())
+    {
+        pending_by_order.erase(pending);
+    }
+}
+
+void OrderEntrySession::retire(uint64_t order_id)
+{
+    if (live_orders_.count(order_id) != 0 || pending_amends_.count(order_id) != 0 ||
+        pending_cancels_.count(order_id) != 0)
+    {
+        return;
+    }
+    auto routed = routed_.find(order_id);
+    if (routed != routed_.end())
+    {
+        dispatcher_.unroute(routed->first, routed->second);
+        routed_.erase(routed);
+    }
+}
+
+void OrderEntrySession::write(const orderbook::OrderEntryResponse &response)
+{
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    stream_.Write(response); // false once the client has gone; the RPC thread notices on Read
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "orderbook_service.grpc.pb.h"
+#include "OrderEntryDispatcher.h"
+#include "ShardedMatchingEngine.h"
+#include <grpc++/grpc++.h>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// One OrderEntryStream call. The RPC thread feeds instructions in and gets an
+// ack back straight away; the OrderEntryDispatcher queues the execution
+// events of this session's orders, and a reporter thread turns them into
+// fill, cancel, expire and amend reports. Both threads write to the same gRPC
+// stream, so writes are serialized. Neither the matching threads nor the
+// dispatcher wait on a session. If reports are lost, because the dispatcher
+// was lapped or this session let a stream's worth of events queue up, the
+// reporter looks the session's orders on that shard up in the book to catch up.
+class OrderEntrySession
+{
+public:
+    using Stream = grpc::ServerReaderWriter<orderbook::OrderEntryResponse, orderbook::OrderEntryRequest>;
+
+    OrderEntrySession(ShardedMatchingEngine &engine, OrderEntryDispatcher &dispatcher, Stream &stream);
+    ~OrderEntrySession();
+
+    OrderEntrySession(const OrderEntrySession &) = delete;
+    OrderEntrySession &operator=(const OrderEntrySession &) = delete;
+
+    void submit(uint64_t client_order_id, Order &order);
+    // Cancels and amends go to the book the session's order was submitted to,
+    // whatever symbol_id the request carries. A cancel is acked once queued;
+    // if the order has left the book by the time it runs, a REJECT follows.
+    void cancel(uint64_t client_order_id, uint64_t order_id);
+    // Amends in place under the same order id; see OrderBook::amend_order for
+    // when time priority is kept. Not acked: the book's result comes back as
+    // REPLACED or REJECT, in sequence with the order's fills.
+    void amend(uint64_t client_order_id, uint64_t order_id, double price, int quantity);
+    void reject(uint64_t client_order_id, const std::string &reason);
+
+    // After the client half-closes: keeps reporting until every order of the
+    // session has left the book and every cancel and amend is answered, or cancelled()
+    // turns true (the client went away or the server is shutting down)
+    void finish(const std::function<bool()> &cancelled);
+
+    // Called by the dispatcher with its shard locked; they only queue
+    void deliver(size_t shard, const ExecutionEvent &event);
+    void lost_reports(size_t shard);
+
+private:
+    struct LiveOrder
+    {
+        uint64_t client_order_id;
+        Order order; // quantity tracks what is still open
+        bool queued; // accepted by the engine, so a lookup sees it
+        // Events up to this execution sequence are already reflected in
+        // order, after a reporting gap was reconciled against the book
+        uint64_t reconciled_through;
+    };
+
+    // An execution event to report, or a gap to reconcile
+    struct Report
+    {
+        ExecutionEvent event;
+        size_t shard;
+        bool gap;
+    };
+
+    ShardedMatchingEngine &engine_;
+    OrderEntryDispatcher &dispatcher_;
+    Stream &stream_;
+    std::mutex write_mutex_;
+
+    // Orders this session has open, by exchange order id
+    std::mutex live_mutex_;
+    std::unordered_map<uint64_t, LiveOrder> live_orders_;
+    // Client ids of amends still waiting for their result, oldest first;
+    // guarded by live_mutex_ and kept even after the order itself is gone
+    std::unordered_map<uint64_t, std::deque<uint64_t>> pending_amends_;
+    // Client ids of acked cancels still waiting for their result, likewise
+    std::unordered_map<uint64_t, std::deque<uint64_t>> pending_cancels_;
+    // Symbol of every order routed to this session by the dispatcher
+    std::unordered_map<uint64_t, SymbolId> routed_;
+    std::condition_variable reported_; // the reporter made progress
+
+    std::mutex inbox_mutex_;
+    std::condition_variable inbox_ready_;
+    std::deque<Report> inbox_;
+    // Per shard: a gap is queued, and that shard's events are dropped until
+    // the reporter reconciles, as the book lookups cover them
+    std::vector<bool> gap_queued_;
+    size_t max_queued_; // events queued past this are lost and reconciled
+    bool stop_reporter_;
+    std::thread reporter_thread_;
+
+    void report_loop();
+    void queue(const Report &report); // caller holds inbox_mutex_
+    void handle_event(const ExecutionEvent &event);
+    void report_fill(uint64_t order_id, const ExecutionEvent &event, bool is_maker);
+    void report_amend(const ExecutionEvent &event);
+    void report_cancel_reject(const ExecutionEvent &event);
+    // Drops the oldest count client ids waiting on order_id; caller holds live_mutex_
+    static void settle_pending(std::unordered_map<uint64_t, std::deque<uint64_t>> &pending_by_order,
+                               uint64_t order_id, size_t count);
+    // Unroutes order_id once it is neither open nor awaiting an amend or
+    // cancel result; caller holds live_mutex_
+    void retire(uint64_t order_id);
+    void reconcile(size_t shard);
+    void write(const orderbook::OrderEntryResponse &response);
+};
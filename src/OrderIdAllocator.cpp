@@ -0,0 +1,44 @@
+#include "OrderIdAllocator.h"
+
+#include <atomic>
+
+namespace
+{
+    // Start of the next unclaimed block
+    alignas(64) std::atomic<uint64_t> next_block(1);
+    // Bumped by reserve_through; read-mostly, so checking it costs no write
+    alignas(64) std::atomic<uint64_t> reservation_epoch(0);
+
+    struct ThreadBlock
+    {
+        uint64_t next = 0;
+        uint64_t end = 0;
+        uint64_t epoch = 0;
+    };
+
+    thread_local ThreadBlock thread_block;
+}
+
+uint64_t OrderIdAllocator::next()
+{
+    ThreadBlock &block = thread_block;
+    uint64_t epoch = reservation_epoch.load(std::memory_order_acquire);
+    if (block.next == block.end || block.epoch != epoch)
+    {
+        block.next = next_block.fetch_add(kBlockSize, std::memory_order_relaxed);
+        block.end = block.next + kBlockSize;
+        block.epoch = epoch;
+    }
+    return block.next++;
+}
+
+void OrderIdAllocator::reserve_through(uint64_t id)
+{
+    uint64_t current = next_block.load(std::memory_order_relaxed);
+    while (current <= id && !next_block.compare_exchange_weak(current, id + 1, std::memory_order_relaxed))
+    {
+    }
+    // Release after the counter moved, so a thread that sees the new epoch
+    // claims its next block above id
+    reservation_epoch.fetch_add(1, std::memory_order_release);
+}
@@ -0,0 +1,114 @@
+#include "OrderIndex.h"
+
+OrderIndex::OrderIndex(size_t initial_capacity)
+    : mask(0),
+      count(0)
+{
+    size_t capacity = 16;
+    while (capacity < initial_capacity)
+    {
+        capacity <<= 1;
+    }
+    entries.assign(capacity, Entry{0, nullptr});
+    mask = capacity - 1;
+}
+
+OrderNode *OrderIndex::find(uint64_t order_id) const
+{
+    size_t slot = find_slot(order_id);
+    return entries[slot].node;
+}
+
+bool OrderIndex::insert(uint64_t order_id, OrderNode *node)
+{
+    // Keep the load factor at or below one half so probe runs stay short
+    if ((count + 1) * 2 > entries.size())
+    {
+        grow();
+    }
+
+    size_t slot = find_slot(order_id);
+    if (entries[slot].node)
+    {
+        return false;
+    }
+
+    entries[slot] = Entry{order_id, node};
+    ++count;
+    return true;
+}
+
+OrderNode *OrderIndex::erase(uint64_t order_id)
+{
+    size_t hole = find_slot(order_id);
+    OrderNode *removed = entries[hole].node;
+    if (!removed)
+    {
+        return nullptr;
+    }
+
+    // Shift later members of the probe run back so lookups never see a gap
+    size_t next = hole;
+    while (true)
+    {
+        next = (next + 1) & mask;
+        if (!entries[next].node)
+        {
+            break;
+        }
+
+        size_t home = home_slot(entries[next].order_id);
+        bool home_in_gap = hole <= next ? (home > hole && home <= next)
+                                        : (home > hole || home <= next);
+        if (!home_in_gap)
+        {
+            entries[hole] = entries[next];
+            hole = next;
+        }
+    }
+    entries[hole] = Entry{0, nullptr};
+    --count;
+    return removed;
+}
+
+size_t OrderIndex::size() const
+{
+    return count;
+}
+
+size_t OrderIndex::home_slot(uint64_t order_id) const
+{
+    // splitmix64 finaliser; ids are often sequential so they need mixing
+    uint64_t x = order_id;
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return static_cast<size_t>(x) & mask;
+}
+
+size_t OrderIndex::find_slot(uint64_t order_id) const
+{
+    size_t slot = home_slot(order_id);
+    while (entries[slot].node && entries[slot].order_id != order_id)
+    {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+void OrderIndex::grow()
+{
+    std::vector<Entry> old_entries(entries.size() * 2, Entry{0, nullptr});
+    old_entries.swap(entries);
+    mask = entries.size() - 1;
+
+    for (const Entry &entry : old_entries)
+    {
+        if (entry.node)
+        {
+            entries[find_slot(entry.order_id)] = entry;
+        }
+    }
+}
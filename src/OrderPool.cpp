@@ -0,0 +1,131 @@
+#include "OrderPool.h"
+
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+OrderPool::OrderPool(size_t slab_nodes, bool prefault)
+    : slab_nodes_(1),
+      slab_shift_(0),
+      prefault_(prefault),
+      slabs_(),
+      slab_count_(0),
+      free_head_(0),
+      next_unused_(0),
+      in_use_(0)
+{
+    while (slab_nodes_ < slab_nodes)
+    {
+        slab_nodes_ <<= 1;
+        ++slab_shift_;
+    }
+
+    add_slab();
+}
+
+OrderPool::~OrderPool()
+{
+    // Nodes still handed out belong to a book or queue that is being torn down
+    // with us; nodes are plain data so the storage is simply freed
+    for (size_t i = 0; i < slab_count_; ++i)
+    {
+        ::operator delete(slabs_[i], std::align_val_t(alignof(Slot)));
+    }
+}
+
+OrderNode *OrderPool::acquire(const Order &order, Tick tick)
+{
+    Slot *slot = pop_free();
+
+    if (!slot)
+    {
+        uint64_t index = next_unused_;
+        if (index >= slab_count_ * slab_nodes_)
+        {
+            add_slab(); // throws before the index is used up
+        }
+        ++next_unused_;
+        // First use of this slot; untouched slab pages stay unfaulted until now
+        slot = slot_at(index);
+        slot->next_free = 0;
+        slot->index = static_cast<uint32_t>(index);
+    }
+
+    *details_at(slot->index) = OrderDetails{order.get_symbol_id()};
+
+    ++in_use_;
+    int64_t timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                               order.get_created_at().time_since_epoch())
+                               .count();
+    RestingOrder resting{order.get_id(), tick, timestamp_ns, order.get_quantity(),
+                         order.get_side(), order.get_type(), order.get_status(), order.get_strategy()};
+    return new (&slot->node) OrderNode{resting, nullptr, nullptr};
+}
+
+void OrderPool::release(OrderNode *node)
+{
+    // node is the first member of its Slot
+    Slot *slot = reinterpret_cast<Slot *>(node);
+    node->~OrderNode();
+
+    slot->next_free = free_head_;
+    free_head_ = slot->index + 1;
+    --in_use_;
+}
+
+const OrderDetails &OrderPool::details(const OrderNode *node) const
+{
+    // node is the first member of its Slot
+    return *details_at(reinterpret_cast<const Slot *>(node)->index);
+}
+
+size_t OrderPool::capacity() const
+{
+    return slab_count_ * slab_nodes_;
+}
+
+size_t OrderPool::in_use() const
+{
+    return in_use_;
+}
+
+OrderPool::Slot *OrderPool::slot_at(uint64_t index) const
+{
+    return &slabs_[index >> slab_shift_][index & (slab_nodes_ - 1)];
+}
+
+OrderDetails *OrderPool::details_at(uint64_t index) const
+{
+    Slot *slab = slabs_[index >> slab_shift_];
+    return reinterpret_cast<OrderDetails *>(slab + slab_nodes_) + (index & (slab_nodes_ - 1));
+}
+
+OrderPool::Slot *OrderPool::pop_free()
+{
+    if (free_head_ == 0)
+    {
+        return nullptr;
+    }
+    Slot *slot = slot_at(free_head_ - 1);
+    free_head_ = slot->next_free;
+    return slot;
+}
+
+void OrderPool::add_slab()
+{
+    if (slab_count_ == kMaxSlabs || (slab_count_ + 1) * slab_nodes_ > UINT32_MAX)
+    {
+        throw std::bad_alloc();
+    }
+
+    // Slots first, then the details side table
+    size_t bytes = slab_nodes_ * (sizeof(Slot) + sizeof(OrderDetails));
+    Slot *slab = static_cast<Slot *>(::operator new(bytes, std::align_val_t(alignof(Slot))));
+    if (prefault_)
+    {
+        std::memset(static_cast<void *>(slab), 0, bytes);
+    }
+
+    slabs_[slab_count_++] = slab;
+}
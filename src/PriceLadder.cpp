@@ -0,0 +1,234 @@
+#include "PriceLadder.h"
+
+#include <algorithm>
+
+PriceLadder::PriceLadder(OrderSide side, size_t initial_levels, size_t max_levels)
+    : side(side),
+      initial_levels(std::max<size_t>(std::min(initial_levels, max_levels), 2)),
+      max_levels(std::max(max_levels, this->initial_levels)),
+      base_tick(0),
+      best_index(0),
+      non_empty_levels(0)
+{
+    // Levels are allocated lazily around the first price we see
+}
+
+PriceLadder::~PriceLadder()
+{
+}
+
+bool PriceLadder::empty() const
+{
+    return non_empty_levels == 0;
+}
+
+size_t PriceLadder::level_count() const
+{
+    return non_empty_levels;
+}
+
+Tick PriceLadder::best_tick() const
+{
+    return base_tick + static_cast<Tick>(best_index);
+}
+
+PriceLevel &PriceLadder::best_level()
+{
+    return levels[best_index];
+}
+
+PriceLevel *PriceLadder::find_level(Tick tick)
+{
+    if (!in_window(tick))
+    {
+        return nullptr;
+    }
+    return &levels[static_cast<size_t>(tick - base_tick)];
+}
+
+const PriceLevel *PriceLadder::find_level(Tick tick) const
+{
+    if (!in_window(tick))
+    {
+        return nullptr;
+    }
+    return &levels[static_cast<size_t>(tick - base_tick)];
+}
+
+void PriceLadder::push_back(OrderNode *node)
+{
+    ensure_window(node->order.tick);
+
+    size_t index = static_cast<size_t>(node->order.tick - base_tick);
+    PriceLevel &level = levels[index];
+    if (!level.head)
+    {
+        ++non_empty_levels;
+        if (non_empty_levels == 1 || is_better(index, best_index))
+        {
+            best_index = index;
+        }
+    }
+
+    node->prev = level.tail;
+    node->next = nullptr;
+    if (level.tail)
+    {
+        level.tail->next = node;
+    }
+    else
+    {
+        level.head = node;
+    }
+    level.tail = node;
+
+    level.total_quantity += node->order.quantity;
+    ++level.order_count;
+}
+
+void PriceLadder::unlink(OrderNode *node)
+{
+    size_t index = static_cast<size_t>(node->order.tick - base_tick);
+    PriceLevel &level = levels[index];
+
+    if (node->prev)
+    {
+        node->prev->next = node->next;
+    }
+    else
+    {
+        level.head = node->next;
+    }
+    if (node->next)
+    {
+        node->next->prev = node->prev;
+    }
+    else
+    {
+        level.tail = node->prev;
+    }
+    node->prev = nullptr;
+    node->next = nullptr;
+
+    level.total_quantity -= node->order.quantity;
+    --level.order_count;
+
+    if (!level.head)
+    {
+        level.total_quantity = 0;
+        --non_empty_levels;
+        if (non_empty_levels > 0 && index == best_index)
+        {
+            find_next_best();
+        }
+    }
+}
+
+int64_t PriceLadder::quantity_through(Tick limit, int64_t wanted) const
+{
+    int64_t quantity = 0;
+    size_t visited = 0;
+    size_t index = best_index;
+    while (visited < non_empty_levels && quantity < wanted)
+    {
+        Tick tick = base_tick + static_cast<Tick>(index);
+        if (side == OrderSide::BUY ? tick < limit : tick > limit)
+        {
+            break;
+        }
+        const PriceLevel &level = levels[index];
+        if (level.head)
+        {
+            quantity += level.total_quantity;
+            ++visited;
+        }
+        index = side == OrderSide::BUY ? index - 1 : index + 1;
+    }
+    return quantity;
+}
+
+bool PriceLadder::can_hold(Tick tick) const
+{
+    // An empty side re-centres its window on the new price
+    if (non_empty_levels == 0 || in_window(tick))
+    {
+        return true;
+    }
+    Tick low = std::min(tick, base_tick);
+    Tick high = std::max(tick, base_tick + static_cast<Tick>(levels.size()) - 1);
+    return static_cast<uint64_t>(high - low) < max_levels;
+}
+
+bool PriceLadder::is_better(size_t lhs, size_t rhs) const
+{
+    return side == OrderSide::BUY ? lhs > rhs : lhs < rhs;
+}
+
+bool PriceLadder::in_window(Tick tick) const
+{
+    return tick >= base_tick && tick - base_tick < static_cast<Tick>(levels.size());
+}
+
+void PriceLadder::ensure_window(Tick tick)
+{
+    if (in_window(tick))
+    {
+        return;
+    }
+
+    if (levels.empty())
+    {
+        levels.resize(initial_levels, PriceLevel{});
+    }
+
+    // Nothing rests on this side, so just re-centre the window on the new price
+    if (non_empty_levels == 0)
+    {
+        base_tick = tick - static_cast<Tick>(levels.size() / 2);
+        return;
+    }
+
+    // Grow by up to the current size so repeated growth stays amortised O(1),
+    // but never past max_levels
+    size_t size = levels.size();
+    size_t spare = std::min(size, max_levels > size ? max_levels - size : 0);
+    if (tick < base_tick)
+    {
+        size_t needed = static_cast<size_t>(base_tick - tick);
+        regrow(std::max(needed, spare), 0);
+    }
+    else
+    {
+        size_t needed = static_cast<size_t>(tick - base_tick) - size + 1;
+        regrow(0, std::max(needed, spare));
+    }
+}
+
+void PriceLadder::regrow(size_t front_levels, size_t back_levels)
+{
+    // Levels only hold pointers into the nodes, so they can be moved freely
+    levels.insert(levels.begin(), front_levels, PriceLevel{});
+    levels.resize(levels.size() + back_levels, PriceLevel{});
+
+    base_tick -= static_cast<Tick>(front_levels);
+    best_index += front_levels;
+}
+
+void PriceLadder::find_next_best()
+{
+    // Walk away from the touch; a non-empty level is guaranteed to exist
+    if (side == OrderSide::BUY)
+    {
+        while (!levels[best_index].head)
+        {
+            --best_index;
+        }
+    }
+    else
+    {
+        while (!levels[best_index].head)
+        {
+            ++best_index;
+        }
+    }
+}
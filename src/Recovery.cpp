@@ -0,0 +1,137 @@
+#include "Recovery.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+#include <sys/stat.h>
+
+namespace
+{
+    bool file_exists(const std::string &path)
+    {
+        struct stat st;
+        return ::stat(path.c_str(), &st) == 0;
+    }
+}
+
+Order order_from_record(const JournalRecord &record)
+{
+    return Order(record.order_id,
+                 static_cast<Strategy>(record.strategy),
+                 record.quantity,
+                 record.price,
+                 static_cast<OrderSide>(record.side),
+                 static_cast<OrderType>(record.order_type),
+                 record.symbol_id,
+                 std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                     std::chrono::nanoseconds(record.timestamp_ns))));
+}
+
+void apply_journal_record(OrderBook &book, const JournalRecord &record)
+{
+    switch (record.type)
+    {
+    case JournalRecordType::SUBMIT:
+    {
+        Order order = order_from_record(record);
+        book.match_orders(order);
+        break;
+    }
+    case JournalRecordType::CANCEL:
+        book.cancel_order(record.order_id);
+        break;
+    case JournalRecordType::AMEND:
+        book.amend_order(record.order_id, record.price, record.quantity);
+        break;
+    }
+}
+
+RecoveryStats recover_books(const std::string &snapshot_path, const std::string &journal_path,
+                            const TickSizes &tick_sizes, size_t max_price_levels, const std::function<OrderBook &(SymbolId)> &book_for,
+                            uint64_t up_to)
+{
+    RecoveryStats stats;
+    auto start = std::chrono::steady_clock::now();
+
+    if (!snapshot_path.empty() && file_exists(snapshot_path))
+    {
+        MappedBookSnapshot snapshot(snapshot_path);
+        if (!snapshot.verify())
+        {
+            throw std::runtime_error("Snapshot " + snapshot_path + " is damaged");
+        }
+        for (size_t i = 0; i < snapshot.book_count(); ++i)
+        {
+            const SnapshotBook &entry = snapshot.books()[i];
+            if (entry.max_price_levels != max_price_levels)
+            {
+                throw std::runtime_error("Snapshot " + snapshot_path + " was taken with a different price band");
+            }
+            if (entry.tick_size != tick_sizes.for_symbol(entry.symbol_id))
+            {
+                throw std::runtime_error("Snapshot " + snapshot_path + " was taken with a different tick size for symbol " +
+                                         std::to_string(entry.symbol_id));
+            }
+        }
+        for (size_t i = 0; i < snapshot.book_count(); ++i)
+        {
+            const SnapshotBook &entry = snapshot.books()[i];
+            if (!snapshot.restore(entry, book_for(entry.symbol_id)))
+            {
+                throw std::runtime_error("Snapshot " + snapshot_path + " holds an order book " +
+                                         std::to_string(entry.symbol_id) + " refuses");
+            }
+        }
+        for (size_t i = 0; i < snapshot.order_count(); ++i)
+        {
+            stats.max_order_id = std::max(stats.max_order_id, snapshot.orders()[i].order_id);
+        }
+        stats.snapshot_sequence = snapshot.journal_sequence();
+        stats.snapshot_orders = snapshot.order_count();
+    }
+    stats.last_sequence = stats.snapshot_sequence;
+
+    if (!file_exists(journal_path))
+    {
+        if (stats.snapshot_sequence > 0)
+        {
+            throw std::runtime_error("Journal " + journal_path + " is missing but the snapshot needs it");
+        }
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return stats;
+    }
+
+    JournalReader reader(journal_path);
+    if (reader.max_price_levels() != 0 && reader.max_price_levels() != max_price_levels)
+    {
+        throw std::runtime_error("Journal " + journal_path + " was written for books with a different price band");
+    }
+    if (reader.tick_size_digest() != 0 && reader.tick_size_digest() != tick_sizes.digest())
+    {
+        throw std::runtime_error("Journal " + journal_path + " was written for books with other tick sizes");
+    }
+    JournalRecord record;
+    if (stats.snapshot_sequence > 0)
+    {
+        // The record the snapshot ends at must still be in the journal, or
+        // commands journaled after a restart would reuse sequences it covers
+        reader.skip_to(stats.snapshot_sequence - 1);
+        if (!reader.next(record))
+        {
+            throw std::runtime_error("Snapshot " + snapshot_path + " is newer than journal " + journal_path);
+        }
+        stats.max_order_id = std::max(stats.max_order_id, record.order_id);
+    }
+
+    while (reader.last_sequence() < up_to && reader.next(record))
+    {
+        apply_journal_record(book_for(record.symbol_id), record);
+        stats.max_order_id = std::max(stats.max_order_id, record.order_id);
+        ++stats.replayed_commands;
+    }
+    stats.last_sequence = reader.last_sequence();
+
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return stats;
+}
@@ -0,0 +1,184 @@
+#include "ShardedMatchingEngine.h"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+ShardedMatchingEngine::ShardedMatchingEngine(const ShardedEngineConfig &config)
+{
+    if (config.shard_count == 0)
+    {
+        throw std::invalid_argument("Shard count must be positive");
+    }
+
+    const std::string &journal_path = config.engine.journal.path;
+    if (!journal_path.empty())
+    {
+        // One shard logs to the bare path and several to suffixed ones, so a
+        // log left by the other kind of layout would otherwise go unread
+        const std::string other = config.shard_count > 1 ? journal_path : journal_path + ".0";
+        if (std::ifstream(other))
+        {
+            throw std::runtime_error("Journal " + other + " was written with a different shard count than " +
+                                     std::to_string(config.shard_count));
+        }
+    }
+
+    shards_.reserve(config.shard_count);
+    for (size_t i = 0; i < config.shard_count; ++i)
+    {
+        MatchingEngineConfig shard_config = config.engine;
+        shard_config.cpu = i < config.cpus.size() ? config.cpus[i] : -1;
+        shard_config.execution_wakeup = &execution_wakeup_;
+        shard_config.journal.shard_count = static_cast<uint32_t>(config.shard_count);
+        shard_config.journal.shard_index = static_cast<uint32_t>(i);
+        if (config.shard_count > 1)
+        {
+            // Each shard journals and snapshots its own command stream
+            if (!shard_config.journal.path.empty())
+            {
+                shard_config.journal.path += "." + std::to_string(i);
+            }
+            if (!shard_config.journal.snapshot_path.empty())
+            {
+                shard_config.journal.snapshot_path += "." + std::to_string(i);
+            }
+        }
+        shards_.push_back(std::make_unique<MatchingEngine>(shard_config));
+    }
+}
+
+bool ShardedMatchingEngine::process_order(Order &order, uint64_t received_at)
+{
+    return shards_[shard_for(order.get_symbol_id())]->process_order(order, received_at);
+}
+
+bool ShardedMatchingEngine::process_order_sync(Order &order, OrderOutcome &outcome, std::chrono::microseconds timeout,
+                                               uint64_t received_at)
+{
+    return shards_[shard_for(order.get_symbol_id())]->process_order_sync(order, outcome, timeout, received_at);
+}
+
+bool ShardedMatchingEngine::cancel_order(uint64_t order_id, SymbolId symbol_id, uint64_t received_at)
+{
+    return shards_[shard_for(symbol_id)]->cancel_order(order_id, symbol_id, received_at);
+}
+
+bool ShardedMatchingEngine::amend_order(uint64_t order_id, SymbolId symbol_id, double price, int quantity,
+                                        uint64_t received_at)
+{
+    return shards_[shard_for(symbol_id)]->amend_order(order_id, symbol_id, price, quantity, received_at);
+}
+
+bool ShardedMatchingEngine::query_order(uint64_t order_id, SymbolId symbol_id, OrderOutcome &outcome,
+                                        std::chrono::microseconds timeout)
+{
+    return shards_[shard_for(symbol_id)]->query_order(order_id, symbol_id, outcome, timeout);
+}
+
+bool ShardedMatchingEngine::cancel_order_sync(uint64_t order_id, SymbolId symbol_id, OrderOutcome &outcome,
+                                              std::chrono::microseconds timeout, uint64_t received_at)
+{
+    return shards_[shard_for(symbol_id)]->cancel_order_sync(order_id, symbol_id, outcome, timeout, received_at);
+}
+
+bool ShardedMatchingEngine::amend_order_sync(uint64_t order_id, SymbolId symbol_id, double price, int quantity,
+                                             OrderOutcome &outcome, std::chrono::microseconds timeout, uint64_t received_at)
+{
+    return shards_[shard_for(symbol_id)]->amend_order_sync(order_id, symbol_id, price, quantity, outcome, timeout,
+                                                           received_at);
+}
+
+void ShardedMatchingEngine::process_order_async(Order &order, OrderCompletion &completion, uint32_t ticket,
+                                                uint64_t received_at)
+{
+    shards_[shard_for(order.get_symbol_id())]->process_order_async(order, completion, ticket, received_at);
+}
+
+void ShardedMatchingEngine::cancel_order_async(uint64_t order_id, SymbolId symbol_id, OrderCompletion &completion,
+                                               uint32_t ticket, uint64_t received_at)
+{
+    shards_[shard_for(symbol_id)]->cancel_order_async(order_id, symbol_id, completion, ticket, received_at);
+}
+
+void ShardedMatchingEngine::amend_order_async(uint64_t order_id, SymbolId symbol_id, double price, int quantity,
+                                              OrderCompletion &completion, uint32_t ticket, uint64_t received_at)
+{
+    shards_[shard_for(symbol_id)]->amend_order_async(order_id, symbol_id, price, quantity, completion, ticket,
+                                                     received_at);
+}
+
+size_t ShardedMatchingEngine::shard_count() const
+{
+    return shards_.size();
+}
+
+size_t ShardedMatchingEngine::shard_for(SymbolId symbol_id) const
+{
+    return symbol_id % shards_.size();
+}
+
+MatchingEngine &ShardedMatchingEngine::get_shard(size_t shard)
+{
+    return *shards_.at(shard);
+}
+
+void ShardedMatchingEngine::wait_for_executions(const std::vector<uint64_t> &cursors, std::chrono::microseconds timeout) const
+{
+    execution_wakeup_.wait([this, &cursors]
+                           {
+        for (size_t i = 0; i < shards_.size() && i < cursors.size(); ++i)
+        {
+            if (shards_[i]->get_execution_stream().published() > cursors[i])
+            {
+                return true;
+            }
+        }
+        return false; },
+                           timeout);
+}
+
+const MarketDataStream &ShardedMatchingEngine::get_market_data_stream(SymbolId symbol_id) const
+{
+    return shards_[shard_for(symbol_id)]->get_market_data_stream();
+}
+
+bool ShardedMatchingEngine::get_snapshot(SymbolId symbol_id, size_t max_levels, BookSnapshot &snapshot)
+{
+    return shards_[shard_for(symbol_id)]->get_snapshot(symbol_id, max_levels, snapshot);
+}
+
+bool ShardedMatchingEngine::get_top_of_book(SymbolId symbol_id, TopOfBook &top) const
+{
+    return shards_[shard_for(symbol_id)]->get_top_of_book(symbol_id, top);
+}
+
+bool ShardedMatchingEngine::get_depth(SymbolId symbol_id, size_t max_levels, DepthSnapshot &depth) const
+{
+    return shards_[shard_for(symbol_id)]->get_depth(symbol_id, max_levels, depth);
+}
+
+EngineStats ShardedMatchingEngine::get_stats() const
+{
+    EngineStats total;
+    for (const auto &shard : shards_)
+    {
+        EngineStats stats = shard->get_stats();
+        total.commands_processed += stats.commands_processed;
+        total.batches += stats.batches;
+        total.last_batch_size = std::max(total.last_batch_size, stats.last_batch_size);
+        total.max_batch_size = std::max(total.max_batch_size, stats.max_batch_size);
+        total.batch_size_limit = stats.batch_size_limit;
+        total.journaled_commands += stats.journaled_commands;
+        total.journal_syncs += stats.journal_syncs;
+        total.snapshots_written += stats.snapshots_written;
+        total.journal_failed = total.journal_failed || stats.journal_failed;
+        total.journal_refused += stats.journal_refused;
+        total.queue_depth += stats.queue_depth;
+        total.queue_capacity += stats.queue_capacity;
+        total.journal_queue_depth += stats.journal_queue_depth;
+        total.journal_queue_capacity += stats.journal_queue_capacity;
+    }
+    return total;
+}
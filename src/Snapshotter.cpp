@@ -0,0 +1,128 @@
+#include "Snapshotter.h"
+#include "BookSnapshotFile.h"
+#include "Recovery.h"
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+Snapshotter::Snapshotter(const std::string &journal_path, const std::string &snapshot_path,
+                         const TickSizes &tick_sizes, size_t max_price_levels, uint64_t interval, std::function<uint64_t()> durable_sequence,
+                         ReaderWakeup &durable_advanced)
+    : journal_path_(journal_path),
+      snapshot_path_(snapshot_path),
+      tick_sizes_(tick_sizes),
+      max_price_levels_(max_price_levels),
+      interval_(interval > 0 ? interval : 1),
+      durable_sequence_(std::move(durable_sequence)),
+      durable_advanced_(durable_advanced),
+      applied_sequence_(0),
+      snapshots_written_(0),
+      snapshot_sequence_(0),
+      stop_(false)
+{
+    thread_ = std::thread(&Snapshotter::run, this);
+}
+
+Snapshotter::~Snapshotter()
+{
+    stop_.store(true);
+    durable_advanced_.notify_all();
+    if (thread_.joinable())
+    {
+        thread_.join();
+    }
+}
+
+uint64_t Snapshotter::snapshots_written() const
+{
+    return snapshots_written_.load(std::memory_order_relaxed);
+}
+
+uint64_t Snapshotter::snapshot_sequence() const
+{
+    return snapshot_sequence_.load(std::memory_order_relaxed);
+}
+
+OrderBook &Snapshotter::book_for(SymbolId symbol_id)
+{
+    std::unique_ptr<OrderBook> &book = books_[symbol_id];
+    if (!book)
+    {
+        book = std::make_unique<OrderBook>(tick_sizes_.for_symbol(symbol_id), max_price_levels_);
+    }
+    return *book;
+}
+
+void Snapshotter::write_snapshot()
+{
+    std::vector<std::pair<SymbolId, const OrderBook *>> books;
+    books.reserve(books_.size());
+    for (const auto &entry : books_)
+    {
+        books.emplace_back(entry.first, entry.second.get());
+    }
+
+    if (!write_book_snapshot(snapshot_path_, applied_sequence_, books))
+    {
+        std::cerr << "Snapshotter: could not write snapshot " << snapshot_path_ << std::endl;
+        return;
+    }
+    snapshot_sequence_.store(applied_sequence_, std::memory_order_relaxed);
+    snapshots_written_.store(snapshots_written_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void Snapshotter::run()
+{
+    // Start from the same state a restart would: last snapshot plus journal tail
+    try
+    {
+        RecoveryStats stats = recover_books(snapshot_path_, journal_path_, tick_sizes_, max_price_levels_,
+                                            [this](SymbolId symbol_id) -> OrderBook &
+                                            { return book_for(symbol_id); },
+                                            durable_sequence_());
+        applied_sequence_ = stats.last_sequence;
+        snapshot_sequence_.store(stats.snapshot_sequence, std::memory_order_relaxed);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Snapshotter: cannot rebuild the books, snapshots disabled: " << e.what() << std::endl;
+        return;
+    }
+
+    std::unique_ptr<JournalReader> reader;
+    while (!stop_.load())
+    {
+        uint64_t durable = durable_sequence_();
+        if (applied_sequence_ >= durable)
+        {
+            // The journal thread wakes this whenever more becomes durable;
+            // the timeout is only a backstop
+            durable_advanced_.wait([this]
+                                   { return stop_.load() || durable_sequence_() > applied_sequence_; },
+                                   std::chrono::milliseconds(100));
+            continue;
+        }
+
+        JournalRecord record;
+        if (!reader || !reader->next(record))
+        {
+            // First pass, or the journal grew past what the reader has mapped
+            reader = std::make_unique<JournalReader>(journal_path_);
+            reader->skip_to(applied_sequence_);
+            if (!reader->next(record))
+            {
+                std::cerr << "Snapshotter: journal ends before sequence " << durable << std::endl;
+                return;
+            }
+        }
+
+        apply_journal_record(book_for(record.symbol_id), record);
+        applied_sequence_ = record.sequence;
+
+        if (applied_sequence_ - snapshot_sequence_.load(std::memory_order_relaxed) >= interval_)
+        {
+            write_snapshot();
+        }
+    }
+}
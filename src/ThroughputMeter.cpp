@@ -0,0 +1,113 @@
+#include "ThroughputMeter.h"
+
+#include <algorithm>
+
+namespace
+{
+    // Longest window reported; samples older than this are dropped
+    constexpr std::chrono::seconds kLongestWindow(60);
+}
+
+ThroughputMeter::ThroughputMeter(std::chrono::milliseconds sample_interval)
+    : sample_interval_(sample_interval.count() > 0 ? sample_interval : std::chrono::milliseconds(1)),
+      stop_(false)
+{
+    samples_.push_back(Sample{std::chrono::steady_clock::now(), 0});
+    sampler_thread_ = std::thread(&ThroughputMeter::run, this);
+}
+
+ThroughputMeter::~ThroughputMeter()
+{
+    stop_.store(true);
+    if (sampler_thread_.joinable())
+    {
+        sampler_thread_.join();
+    }
+}
+
+void ThroughputMeter::add(uint64_t count)
+{
+    // Single writer per counter, so a plain load and store
+    std::atomic<uint64_t> &value = counters_.local().value;
+    value.store(value.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+}
+
+uint64_t ThroughputMeter::total() const
+{
+    uint64_t sum = 0;
+    counters_.for_each([&](const Counter &counter)
+                       { sum += counter.value.load(std::memory_order_relaxed); });
+    return sum;
+}
+
+ThroughputStats ThroughputMeter::stats() const
+{
+    ThroughputStats stats;
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats = stats_;
+    }
+    stats.total = total();
+    return stats;
+}
+
+double ThroughputMeter::rate_over(std::chrono::steady_clock::time_point now, uint64_t total,
+                                  std::chrono::seconds window) const
+{
+    // Oldest sample still inside the window; samples_ is in time order
+    auto start = std::lower_bound(samples_.begin(), samples_.end(), now - window,
+                                  [](const Sample &sample, std::chrono::steady_clock::time_point at)
+                                  { return sample.at < at; });
+    if (start == samples_.end())
+    {
+        return 0.0;
+    }
+    double seconds = std::chrono::duration<double>(now - start->at).count();
+    return seconds > 0.0 ? static_cast<double>(total - start->total) / seconds : 0.0;
+}
+
+void ThroughputMeter::sample()
+{
+    auto now = std::chrono::steady_clock::now();
+    uint64_t sum = total();
+    samples_.push_back(Sample{now, sum});
+    // Keep one sample at or past the longest window so it stays fully covered
+    while (samples_.size() > 2 && samples_[1].at <= now - kLongestWindow)
+    {
+        samples_.pop_front();
+    }
+
+    ThroughputStats stats;
+    stats.total = sum;
+    stats.per_second_1s = rate_over(now, sum, std::chrono::seconds(1));
+    stats.per_second_10s = rate_over(now, sum, std::chrono::seconds(10));
+    stats.per_second_60s = rate_over(now, sum, std::chrono::seconds(60));
+
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    // Only full windows count towards the peak, so a burst in the first
+    // milliseconds is not mistaken for a sustained rate
+    bool full_window = now - samples_.front().at >= std::chrono::seconds(1);
+    stats.peak_per_second = full_window ? std::max(stats_.peak_per_second, stats.per_second_1s) : stats_.peak_per_second;
+    stats_ = stats;
+}
+
+void ThroughputMeter::run()
+{
+    auto next = std::chrono::steady_clock::now() + sample_interval_;
+    while (!stop_.load())
+    {
+        // Short sleeps so the destructor never waits a whole interval
+        auto now = std::chrono::steady_clock::now();
+        if (now < next)
+        {
+            std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(next - now, std::chrono::milliseconds(10)));
+            continue;
+        }
+        sample();
+        next += sample_interval_;
+        if (next < now)
+        {
+            next = now + sample_interval_; // fell behind, e.g. the process was stopped
+        }
+    }
+}
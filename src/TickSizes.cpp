@@ -0,0 +1,87 @@
+#include "TickSizes.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    // FNV-1a over the value's bytes, continuing from hash
+    template <typename T>
+    uint64_t fnv1a(uint64_t hash, const T &value)
+    {
+        unsigned char bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        for (unsigned char byte : bytes)
+        {
+            hash = (hash ^ byte) * 1099511628211ull;
+        }
+        return hash;
+    }
+}
+
+double TickSizes::for_symbol(SymbolId symbol_id) const
+{
+    auto it = per_symbol.find(symbol_id);
+    return it == per_symbol.end() ? default_tick_size : it->second;
+}
+
+bool TickSizes::valid() const
+{
+    auto positive = [](double tick)
+    { return std::isfinite(tick) && tick > 0.0; };
+    return positive(default_tick_size) &&
+           std::all_of(per_symbol.begin(), per_symbol.end(),
+                       [&](const std::pair<const SymbolId, double> &entry)
+                       { return positive(entry.second); });
+}
+
+bool TickSizes::add_override(const std::string &spec)
+{
+    size_t separator = spec.find('=');
+    if (separator == std::string::npos || separator == 0 || separator + 1 == spec.size() ||
+        !std::isdigit(static_cast<unsigned char>(spec[0])))
+    {
+        return false;
+    }
+    try
+    {
+        size_t symbol_end = 0;
+        size_t tick_end = 0;
+        unsigned long symbol = std::stoul(spec.substr(0, separator), &symbol_end);
+        double tick = std::stod(spec.substr(separator + 1), &tick_end);
+        if (symbol_end != separator || tick_end != spec.size() - separator - 1 ||
+            symbol > std::numeric_limits<SymbolId>::max())
+        {
+            return false;
+        }
+        per_symbol[static_cast<SymbolId>(symbol)] = tick;
+        return true;
+    }
+    catch (const std::exception &)
+    {
+        return false; // not a number, or out of range
+    }
+}
+
+uint64_t TickSizes::digest() const
+{
+    std::vector<std::pair<SymbolId, double>> overrides(per_symbol.begin(), per_symbol.end());
+    std::sort(overrides.begin(), overrides.end());
+
+    uint64_t hash = fnv1a(14695981039346656037ull, default_tick_size);
+    for (const auto &entry : overrides)
+    {
+        // An override equal to the default changes no book
+        if (entry.second != default_tick_size)
+        {
+            hash = fnv1a(fnv1a(hash, entry.first), entry.second);
+        }
+    }
+    return hash;
+}
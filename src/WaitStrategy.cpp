@@ -0,0 +1,111 @@
+#include "WaitStrategy.h"
+
+#include <climits>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <time.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+bool parse_wait_strategy(const std::string &name, WaitStrategyType &type)
+{
+    if (name == "spin")
+    {
+        type = WaitStrategyType::BUSY_SPIN;
+    }
+    else if (name == "yield")
+    {
+        type = WaitStrategyType::SPIN_YIELD;
+    }
+    else if (name == "block")
+    {
+        type = WaitStrategyType::BLOCKING;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+const char *wait_strategy_name(WaitStrategyType type)
+{
+    switch (type)
+    {
+    case WaitStrategyType::BUSY_SPIN:
+        return "spin";
+    case WaitStrategyType::SPIN_YIELD:
+        return "yield";
+    case WaitStrategyType::BLOCKING:
+        return "block";
+    default:
+        return "unknown";
+    }
+}
+
+WaitStrategy::WaitStrategy(WaitStrategyType type, uint32_t spin_iterations)
+    : type_(type),
+      spin_iterations_(spin_iterations),
+      wake_seq_(0),
+      sleeping_(false)
+{
+}
+
+WaitStrategyType WaitStrategy::get_type() const
+{
+    return type_;
+}
+
+void WaitStrategy::wake()
+{
+    wake_seq_.fetch_add(1, std::memory_order_release);
+#ifdef __linux__
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(&wake_seq_), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#endif
+}
+
+void WaitStrategy::park(uint32_t seq)
+{
+#ifdef __linux__
+    // Returns immediately if a producer bumped wake_seq_ since we sampled it
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(&wake_seq_), FUTEX_WAIT_PRIVATE, seq, nullptr, nullptr, 0);
+#else
+    // No futex: fall back to yielding until the sequence moves
+    while (wake_seq_.load(std::memory_order_acquire) == seq)
+    {
+        std::this_thread::yield();
+    }
+#endif
+}
+
+ReaderWakeup::ReaderWakeup()
+    : wake_seq_(0),
+      waiters_(0)
+{
+}
+
+void ReaderWakeup::wake_all()
+{
+    wake_seq_.fetch_add(1, std::memory_order_release);
+#ifdef __linux__
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(&wake_seq_), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#endif
+}
+
+void ReaderWakeup::park(uint32_t seq, std::chrono::microseconds timeout)
+{
+#ifdef __linux__
+    timespec relative;
+    relative.tv_sec = static_cast<time_t>(timeout.count() / 1000000);
+    relative.tv_nsec = static_cast<long>(timeout.count() % 1000000) * 1000;
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(&wake_seq_), FUTEX_WAIT_PRIVATE, seq, &relative, nullptr, 0);
+#else
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (wake_seq_.load(std::memory_order_acquire) == seq && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::yield();
+    }
+#endif
+}
@@ -1,21 +1,48 @@
+#include "AsyncOrderBookServer.h"
 #include "OrderBookServiceImpl.h"
 #include <grpc++/grpc++.h>
 #include <iostream>
 #include <memory>
 #include <string>
+#include <pthread.h>
 #include <signal.h>
 #include <thread>
+#include <vector>
+
+namespace
+{
+    // Signals that stop the server. main() blocks them before any thread is
+    // started, so every thread inherits the mask and they are only taken by
+    // sigwait() on the shutdown thread, which unlike a signal handler may
+    // shut the server down through ordinary code.
+    sigset_t shutdownSignals()
+    {
+        sigset_t signals;
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGINT);
+        sigaddset(&signals, SIGTERM);
+        return signals;
+    }
+}
 
 class OrderBookServer
 {
 public:
-    OrderBookServer(const std::string &server_address)
-        : server_address_(server_address) {}
+    OrderBookServer(const std::string &server_address, const ShardedEngineConfig &engine_config,
+                    bool use_async, const AsyncServerConfig &async_config)
+        : server_address_(server_address), engine_config_(engine_config),
+          use_async_(use_async), async_config_(async_config) {}
 
     void Run()
     {
+        if (use_async_)
+        {
+            RunAsync();
+            return;
+        }
+
         // Create service implementation
-        OrderBookServiceImpl service;
+        OrderBookServiceImpl service(engine_config_);
 
         // Configure server
         grpc::ServerBuilder builder;
@@ -44,31 +71,23 @@ public:
         }
 
         std::cout << "🚀 OrderBook gRPC Server listening on " << server_address_ << std::endl;
-        std::cout << "📊 Lock-free queue capacity: 1024 orders" << std::endl;
-        std::cout << "⚡ High-performance order processing enabled" << std::endl;
-        std::cout << "🛡️  Memory-safe RAII implementation active" << std::endl;
-        std::cout << "📡 Available endpoints:" << std::endl;
-        std::cout << "   - SubmitOrder: Submit trading orders" << std::endl;
-        std::cout << "   - HealthCheck: Service health monitoring" << std::endl;
-        std::cout << "   - GetPerformanceStats: Performance metrics" << std::endl;
-        std::cout << "   - GetBestBid/GetBestAsk: Market data (coming soon)" << std::endl;
-        std::cout << "📝 Press Ctrl+C to shutdown gracefully..." << std::endl;
+        std::cout << "🔁 Server mode: synchronous thread pool" << std::endl;
+        printBanner();
 
-        // Store server reference for signal handler
+        // Store server reference for the shutdown thread
         server_ = server.get();
-
-        // Set up signal handling for graceful shutdown
-        setupSignalHandlers();
+        std::thread shutdown_waiter = startShutdownWaiter();
 
         // Wait for the server to shutdown
         server->Wait();
+        shutdown_waiter.join();
 
         std::cout << "🛑 OrderBook gRPC Server shutdown complete" << std::endl;
     }
 
     void Shutdown()
     {
-        if (server_)
+        if (server_ || async_server_)
         {
             std::cout << "\n🛑 Initiating graceful shutdown..." << std::endl;
 
@@ -76,28 +95,91 @@ public:
             auto deadline = std::chrono::system_clock::now() +
                             std::chrono::seconds(5);
 
-            server_->Shutdown(deadline);
+            if (async_server_)
+            {
+                async_server_->shutdown(deadline);
+            }
+            else
+            {
+                server_->Shutdown(deadline);
+            }
         }
     }
 
 private:
     std::string server_address_;
+    ShardedEngineConfig engine_config_;
+    bool use_async_;
+    AsyncServerConfig async_config_;
     grpc::Server *server_ = nullptr;
+    AsyncOrderBookServer *async_server_ = nullptr;
 
-    void setupSignalHandlers()
+    void RunAsync()
     {
-        // Set up signal handler for graceful shutdown
-        signal(SIGINT, [](int signal)
-               {
-            std::cout << "\n🔔 Received shutdown signal (" << signal << ")" << std::endl;
-            // Note: This is a simplified signal handler
-            // In production, use proper signal handling mechanisms
-            exit(0); });
-
-        signal(SIGTERM, [](int signal)
-               {
-            std::cout << "\n🔔 Received termination signal (" << signal << ")" << std::endl;
-            exit(0); });
+        // Unary RPCs are served from completion queues by a fixed set of pollers
+        AsyncOrderBookServer server(server_address_, engine_config_, async_config_);
+        if (!server.start())
+        {
+            std::cerr << "Failed to start server on " << server_address_ << std::endl;
+            return;
+        }
+
+        const AsyncServerConfig &config = server.get_config();
+        std::cout << "🚀 OrderBook gRPC Server listening on " << server_address_ << std::endl;
+        std::cout << "🔁 Server mode: async, " << config.completion_queues << " completion queue(s) x "
+                  << config.pollers_per_queue << " poller(s), " << config.calls_per_method
+                  << " pooled calls per method" << std::endl;
+        printBanner();
+
+        async_server_ = &server;
+        std::thread shutdown_waiter = startShutdownWaiter();
+
+        server.wait();
+        shutdown_waiter.join();
+
+        std::cout << "🛑 OrderBook gRPC Server shutdown complete" << std::endl;
+    }
+
+    void printBanner()
+    {
+        std::cout << "📊 Lock-free queue capacity: " << engine_config_.engine.queue_capacity << " orders" << std::endl;
+        std::cout << "🧵 Matching shards: " << engine_config_.shard_count << std::endl;
+        std::cout << "⏱️  Matching thread wait strategy: " << wait_strategy_name(engine_config_.engine.wait_strategy) << std::endl;
+        if (!engine_config_.engine.journal.path.empty())
+        {
+            std::cout << "💾 Journal: " << engine_config_.engine.journal.path
+                      << (engine_config_.engine.journal.fsync ? " (group commit, fsync)" : " (no fsync)") << std::endl;
+        }
+        std::cout << "⚡ High-performance order processing enabled" << std::endl;
+        std::cout << "🛡️  Memory-safe RAII implementation active" << std::endl;
+        std::cout << "📡 Available endpoints:" << std::endl;
+        std::cout << "   - SubmitOrder: Submit trading orders" << std::endl;
+        std::cout << "   - CancelOrder: Cancel a resting order by ID" << std::endl;
+        std::cout << "   - AmendOrder: Reprice or resize a resting order in place" << std::endl;
+        std::cout << "   - HealthCheck: Service health monitoring" << std::endl;
+        std::cout << "   - GetPerformanceStats: Performance metrics" << std::endl;
+        std::cout << "   - SubscribeMarketData: L2 snapshot + per-batch deltas (streaming)" << std::endl;
+        std::cout << "   - OrderEntryStream: Pipelined submit/cancel/amend with async fills (bidi)" << std::endl;
+        std::cout << "   - GetBestBid/GetBestAsk: Lock-free top of book per symbol" << std::endl;
+        std::cout << "   - GetDepth: Lock-free aggregated L2 depth per symbol" << std::endl;
+        std::cout << "📝 Press Ctrl+C to shutdown gracefully..." << std::endl;
+    }
+
+    // Waits for SIGINT or SIGTERM and shuts the server down; the server only
+    // stops this way, so its Wait() returns once this thread is done. Run()
+    // then returns normally and the service's engines are destroyed in
+    // order: every command already accepted is journaled, synced and matched
+    // before the process exits.
+    std::thread startShutdownWaiter()
+    {
+        return std::thread([this]
+                           {
+            sigset_t signals = shutdownSignals();
+            int signal = 0;
+            sigwait(&signals, &signal);
+            std::cout << "\n🔔 Received " << (signal == SIGTERM ? "termination" : "shutdown") << " signal (" << signal
+                      << ")" << std::endl;
+            Shutdown(); });
     }
 };
 
@@ -107,18 +189,60 @@ void printUsage(const char *program_name)
     std::cout << "Options:" << std::endl;
     std::cout << "  -p, --port PORT     Server port (default: 50051)" << std::endl;
     std::cout << "  -h, --host HOST     Server host (default: 0.0.0.0)" << std::endl;
+    std::cout << "  --wait-strategy S   Matching thread idle strategy: spin, yield or block (default: block)" << std::endl;
+    std::cout << "  --queue-capacity N  Order command ring slots, power of two (default: 65536)" << std::endl;
+    std::cout << "  --batch-size N      Commands matched per wake-up of the matching thread (default: 256)" << std::endl;
+    std::cout << "  --depth-levels N    Levels per side published for GetDepth after each batch; 0 disables (default: 10)" << std::endl;
+    std::cout << "  --max-price-levels N  Widest band in ticks a book side may span; orders outside it are rejected (default: 1048576)" << std::endl;
+    std::cout << "  --tick-size X       Tick size of every symbol without its own (default: 0.01)" << std::endl;
+    std::cout << "  --symbol-tick-size S=X  Tick size X for symbol S; repeat for each instrument on another grid" << std::endl;
+    std::cout << "  --shards N          Matching threads; symbols are partitioned across them (default: 1)" << std::endl;
+    std::cout << "  --pin-cpus LIST     Comma-separated CPU per shard, e.g. 2,3,4,5 (default: unpinned)" << std::endl;
+    std::cout << "  --journal PATH      Write-ahead journal of inbound commands (default: off)" << std::endl;
+    std::cout << "  --journal-fsync-interval-us N  Sync journal groups at most every N us; 0 syncs each group (default: 0)" << std::endl;
+    std::cout << "  --no-journal-fsync  Leave journal writeback to the kernel" << std::endl;
+    std::cout << "  --snapshot PATH     Book snapshot file used by --recover and --snapshot-interval" << std::endl;
+    std::cout << "  --snapshot-interval N  Snapshot the books every N journaled commands (default: 0, never)" << std::endl;
+    std::cout << "  --recover           Rebuild the books from the snapshot and journal tail before serving" << std::endl;
+    std::cout << "  --async             Serve unary RPCs from completion queues instead of the sync thread pool" << std::endl;
+    std::cout << "  --completion-queues N  Completion queues in async mode (default: 1)" << std::endl;
+    std::cout << "  --pollers N         Poller threads per completion queue in async mode (default: 1)" << std::endl;
+    std::cout << "  --poller-cpus LIST  Comma-separated CPU per poller thread in async mode (default: unpinned)" << std::endl;
+    std::cout << "  --calls-per-method N  Pooled call objects per unary method per queue in async mode (default: 64)" << std::endl;
     std::cout << "  --help              Show this help message" << std::endl;
     std::cout << std::endl;
     std::cout << "Examples:" << std::endl;
     std::cout << "  " << program_name << "                    # Start on 0.0.0.0:50051" << std::endl;
     std::cout << "  " << program_name << " -p 8080           # Start on 0.0.0.0:8080" << std::endl;
     std::cout << "  " << program_name << " -h localhost -p 9090 # Start on localhost:9090" << std::endl;
+    std::cout << "  " << program_name << " --wait-strategy spin # Busy-spin for lowest latency" << std::endl;
+    std::cout << "  " << program_name << " --async --completion-queues 2 --pollers 2 --poller-cpus 4,5,6,7" << std::endl;
+}
+
+std::vector<int> parseCpuList(const std::string &cpus)
+{
+    std::vector<int> result;
+    size_t start = 0;
+    while (start < cpus.size())
+    {
+        size_t end = cpus.find(',', start);
+        if (end == std::string::npos)
+        {
+            end = cpus.size();
+        }
+        result.push_back(std::stoi(cpus.substr(start, end - start)));
+        start = end + 1;
+    }
+    return result;
 }
 
 int main(int argc, char **argv)
 {
     std::string host = "0.0.0.0";
     int port = 50051;
+    ShardedEngineConfig engine_config;
+    bool use_async = false;
+    AsyncServerConfig async_config;
 
     // Parse command line arguments
     for (int i = 1; i < argc; i++)
@@ -154,6 +278,219 @@ int main(int argc, char **argv)
                 return 1;
             }
         }
+        else if (arg == "--wait-strategy")
+        {
+            if (i + 1 >= argc)
+            {
+                std::cerr << "Error: --wait-strategy requires a value" << std::endl;
+                return 1;
+            }
+            if (!parse_wait_strategy(argv[++i], engine_config.engine.wait_strategy))
+            {
+                std::cerr << "Error: --wait-strategy must be spin, yield or block" << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--queue-capacity")
+        {
+            if (i + 1 < argc)
+            {
+                engine_config.engine.queue_capacity = std::stoul(argv[++i]);
+            }
+            else
+            {
+                std::cerr << "Error: --queue-capacity requires a value" << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--batch-size")
+        {
+            if (i + 1 < argc)
+            {
+                engine_config.engine.batch_size = std::stoul(argv[++i]);
+            }
+            else
+            {
+                std::cerr << "Error: --batch-size requires a value" << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--depth-levels")
+        {
+            if (i + 1 < argc)
+            {
+                engine_config.engine.depth_levels = std::stoul(argv[++i]);
+            }
+            else
+            {
+                std::cerr << "Error: --depth-levels requires a value" << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--max-price-levels")
+        {
+            if (i + 1 < argc)
+            {
+                engine_config.engine.max_price_levels = std::stoul(argv[++i]);
+            }
+            else
+            {
+                std::cerr << "Error: --max-price-levels requires a value" << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--tick-size")
+        {
+            if (i + 1 < argc)
+            {
+                engine_config.engine.tick_sizes.default_tick_size = std::stod(argv[++i]);
+            }
+            else
+            {
+                std::cerr << "Error: --tick-size requires a value" << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--symbol-tick-size")
+        {
+            if (i + 1 >= argc || !engine_config.engine.tick_sizes.add_override(argv[++i]))
+            {
+                std::cerr << "Error: --symbol-tick-size requires SYMBOL=TICK" << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--shards")
+        {
+            if (i + 1 < argc)
+            {
+                engine_config.shard_count = std::stoul(argv[++i]);
+            }
+            else
+            {
+                std::cerr << "Error: --shards requires a value" << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--pin-cpus")
+        {
+            if (i + 1 < argc)
+            {
+                engine_config.cpus = parseCpuList(argv[++i]);
+            }
+            else
+            {
+                std::cerr << "Error: --pin-cpus requires a value" << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--journal")
+        {
+            if (i + 1 < argc)
+            {
+                engine_config.engine.journal.path = argv[++i];
+            }
+            else
+            {
+                std::cerr << "Error: --journal requires a path" << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--journal-fsync-interval-us")
+        {
+            if (i + 1 < argc)
+            {
+                engine_config.engine.journal.fsync_interval_us = std::stoul(argv[++i]);
+            }
+            else
+            {
+                std::cerr << "Error: --journal-fsync-interval-us requires a value" << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--no-journal-fsync")
+        {
+            engine_config.engine.journal.fsync = false;
+        }
+        else if (arg == "--snapshot")
+        {
+            if (i + 1 < argc)
+            {
+                engine_config.engine.journal.snapshot_path = argv[++i];
+            }
+            else
+            {
+                std::cerr << "Error: --snapshot requires a path" << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--snapshot-interval")
+        {
+            if (i + 1 < argc)
+            {
+                engine_config.engine.journal.snapshot_interval = std::stoull(argv[++i]);
+            }
+            else
+            {
+                std::cerr << "Error: --snapshot-interval requires a value" << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--recover")
+        {
+            engine_config.engine.journal.recover = true;
+        }
+        else if (arg == "--async")
+        {
+            use_async = true;
+        }
+        else if (arg == "--completion-queues")
+        {
+            if (i + 1 < argc)
+            {
+                async_config.completion_queues = std::stoul(argv[++i]);
+            }
+            else
+            {
+                std::cerr << "Error: --completion-queues requires a value" << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--pollers")
+        {
+            if (i + 1 < argc)
+            {
+                async_config.pollers_per_queue = std::stoul(argv[++i]);
+            }
+            else
+            {
+                std::cerr << "Error: --pollers requires a value" << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--poller-cpus")
+        {
+            if (i + 1 < argc)
+            {
+                async_config.cpus = parseCpuList(argv[++i]);
+            }
+            else
+            {
+                std::cerr << "Error: --poller-cpus requires a value" << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--calls-per-method")
+        {
+            if (i + 1 < argc)
+            {
+                async_config.calls_per_method = std::stoul(argv[++i]);
+            }
+            else
+            {
+                std::cerr << "Error: --calls-per-method requires a value" << std::endl;
+                return 1;
+            }
+        }
         else
         {
             std::cerr << "Unknown argument: " << arg << std::endl;
@@ -171,12 +508,16 @@ int main(int argc, char **argv)
 
     std::string server_address = host + ":" + std::to_string(port);
 
+    // Before the engines and gRPC start their threads, which inherit the mask
+    sigset_t signals = shutdownSignals();
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
     std::cout << "🏗️  Starting OrderBook gRPC Server..." << std::endl;
     std::cout << "📍 Server address: " << server_address << std::endl;
 
     try
     {
-        OrderBookServer server(server_address);
+        OrderBookServer server(server_address, engine_config, use_async, async_config);
         server.Run();
     }
     catch (const std::exception &e)
@@ -1,10 +1,161 @@
 #include "OrderBook.h"
+#include "Recovery.h"
+#include "TickSizes.h"
+#include <fstream>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <string>
 
-int main()
+void printUsage(const char *program_name)
 {
-    OrderBook ob;
+    std::cout << "Usage: " << program_name << " --replay JOURNAL [options]" << std::endl;
+    std::cout << "Rebuilds the order books from a command journal and prints them." << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  --replay JOURNAL        Journal written by orderbook-grpc-server --journal" << std::endl;
+    std::cout << "  --snapshot FILE         Start from this book snapshot and replay only the tail after it" << std::endl;
+    std::cout << "  --tick-size X           Tick size the journal was written with (default: 0.01)" << std::endl;
+    std::cout << "  --symbol-tick-size S=X  Tick size X for symbol S, as the journal was written (repeatable)" << std::endl;
+    std::cout << "  --max-price-levels N    Price band in ticks the journal was written with (default: 1048576)" << std::endl;
+    std::cout << "  --write-snapshot FILE   Save the rebuilt books as a snapshot for a fast restart" << std::endl;
+    std::cout << "  --help                  Show this help message" << std::endl;
+}
 
-    std::cout << "Order added and saved to file.\n";
+int main(int argc, char **argv)
+{
+    std::string journal_path;
+    std::string snapshot_path;
+    std::string output_path;
+    TickSizes tick_sizes;
+    size_t max_price_levels = PriceLadder::kDefaultMaxLevels;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--help")
+        {
+            printUsage(argv[0]);
+            return 0;
+        }
+        else if (i + 1 >= argc)
+        {
+            std::cerr << "Error: " << arg << " requires a value" << std::endl;
+            return 1;
+        }
+        else if (arg == "--replay")
+        {
+            journal_path = argv[++i];
+        }
+        else if (arg == "--snapshot")
+        {
+            snapshot_path = argv[++i];
+        }
+        else if (arg == "--tick-size")
+        {
+            tick_sizes.default_tick_size = std::stod(argv[++i]);
+        }
+        else if (arg == "--symbol-tick-size")
+        {
+            if (!tick_sizes.add_override(argv[++i]))
+            {
+                std::cerr << "Error: --symbol-tick-size expects SYMBOL=TICK" << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--max-price-levels")
+        {
+            max_price_levels = std::stoul(argv[++i]);
+        }
+        else if (arg == "--write-snapshot")
+        {
+            output_path = argv[++i];
+        }
+        else
+        {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (journal_path.empty())
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+    if (!tick_sizes.valid())
+    {
+        std::cerr << "Error: tick sizes must be positive" << std::endl;
+        return 1;
+    }
+    if (!std::ifstream(journal_path))
+    {
+        std::cerr << "Journal not found: " << journal_path << std::endl;
+        return 1;
+    }
+
+    // Ordered by symbol for the report
+    std::map<SymbolId, std::unique_ptr<OrderBook>> books;
+    RecoveryStats stats;
+    try
+    {
+        stats = recover_books(snapshot_path, journal_path, tick_sizes, max_price_levels,
+                              [&](SymbolId symbol_id) -> OrderBook &
+                              {
+            std::unique_ptr<OrderBook> &book = books[symbol_id];
+            if (!book)
+            {
+                book = std::make_unique<OrderBook>(tick_sizes.for_symbol(symbol_id), max_price_levels);
+            }
+            return *book; });
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Replay failed: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "Snapshot: " << stats.snapshot_orders << " orders up to sequence " << stats.snapshot_sequence << std::endl;
+    std::cout << "Replayed " << stats.replayed_commands << " commands up to sequence " << stats.last_sequence
+              << " in " << stats.seconds << " s";
+    if (stats.seconds > 0.0)
+    {
+        std::cout << " (" << static_cast<uint64_t>(stats.replayed_commands / stats.seconds) << " commands/s)";
+    }
+    std::cout << std::endl;
+
+    for (const auto &entry : books)
+    {
+        const OrderBook &book = *entry.second;
+        std::vector<LevelQuantity> bid_levels;
+        std::vector<LevelQuantity> ask_levels;
+        book.get_depth(1, bid_levels, ask_levels);
+
+        std::cout << "Symbol " << entry.first << ": " << book.order_count() << " resting orders";
+        if (!bid_levels.empty())
+        {
+            std::cout << ", best bid " << bid_levels[0].quantity << " @ " << bid_levels[0].price;
+        }
+        if (!ask_levels.empty())
+        {
+            std::cout << ", best ask " << ask_levels[0].quantity << " @ " << ask_levels[0].price;
+        }
+        std::cout << std::endl;
+    }
+
+    if (!output_path.empty())
+    {
+        std::vector<std::pair<SymbolId, const OrderBook *>> snapshot_books;
+        for (const auto &entry : books)
+        {
+            snapshot_books.emplace_back(entry.first, entry.second.get());
+        }
+        if (!write_book_snapshot(output_path, stats.last_sequence, snapshot_books))
+        {
+            std::cerr << "Could not write snapshot " << output_path << std::endl;
+            return 1;
+        }
+        std::cout << "Snapshot written to " << output_path << std::endl;
+    }
     return 0;
-}
\ No newline at end of file
+}
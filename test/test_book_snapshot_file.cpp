@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+#include "BookSnapshotFile.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+class BookSnapshotFileTest : public ::testing::Test
+{
+protected:
+    std::string path;
+
+    void SetUp() override
+    {
+        path = ::testing::TempDir() + "book_snapshot_test_" +
+               ::testing::UnitTest::GetInstance()->current_test_info()->name() + ".snap";
+        std::remove(path.c_str());
+    }
+
+    void TearDown() override
+    {
+        std::remove(path.c_str());
+    }
+
+    static void fill(OrderBook &book, SymbolId symbol)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            Order bid(Strategy::HIGH_FREQUENCY, 10 + i, 49.0 - i * 0.5, OrderSide::BUY, OrderType::LIMIT, symbol);
+            book.add_order(bid);
+            Order ask(Strategy::HEDGE_FUND, 20 + i, 51.0 + i * 0.5, OrderSide::SELL, OrderType::LIMIT, symbol);
+            book.add_order(ask);
+        }
+        Order second(Strategy::OTHER, 7, 49.0, OrderSide::BUY, OrderType::LIMIT, symbol);
+        book.add_order(second);
+    }
+};
+
+TEST_F(BookSnapshotFileTest, RoundTripsSeveralBooks)
+{
+    OrderBook first;
+    OrderBook second;
+    OrderBook empty;
+    fill(first, 1);
+    fill(second, 2);
+    ASSERT_TRUE(write_book_snapshot(path, 99, {{1, &first}, {2, &second}, {5, &empty}}));
+
+    MappedBookSnapshot snapshot(path);
+    EXPECT_EQ(snapshot.journal_sequence(), 99);
+    ASSERT_EQ(snapshot.book_count(), 3);
+    EXPECT_DOUBLE_EQ(snapshot.books()[0].tick_size, 0.01);
+    EXPECT_EQ(snapshot.level_count(), 12);
+    EXPECT_EQ(snapshot.order_count(), 14);
+    EXPECT_TRUE(snapshot.verify());
+
+    // Best level first on each side, FIFO within a level
+    const SnapshotBook &entry = snapshot.books()[0];
+    EXPECT_EQ(entry.symbol_id, 1);
+    EXPECT_EQ(entry.bid_levels, 3);
+    EXPECT_EQ(entry.ask_levels, 3);
+    const SnapshotLevel &best_bid = snapshot.levels()[entry.first_level];
+    EXPECT_EQ(best_bid.total_quantity, 17);
+    ASSERT_EQ(best_bid.order_count, 2);
+    EXPECT_EQ(snapshot.orders()[best_bid.first_order].quantity, 10);
+    EXPECT_EQ(snapshot.orders()[best_bid.first_order + 1].quantity, 7);
+    EXPECT_EQ(snapshot.books()[2].bid_levels + snapshot.books()[2].ask_levels, 0);
+
+    OrderBook restored;
+    EXPECT_TRUE(snapshot.restore(snapshot.books()[1], restored));
+    EXPECT_EQ(restored.order_count(), second.order_count());
+    EXPECT_DOUBLE_EQ(restored.get_best_bid(), 49.0);
+    EXPECT_DOUBLE_EQ(restored.get_best_ask(), 51.0);
+    std::vector<LevelQuantity> bids, asks, restored_bids, restored_asks;
+    second.get_depth(0, bids, asks);
+    restored.get_depth(0, restored_bids, restored_asks);
+    ASSERT_EQ(restored_bids.size(), bids.size());
+    ASSERT_EQ(restored_asks.size(), asks.size());
+    for (size_t i = 0; i < bids.size(); ++i)
+    {
+        EXPECT_DOUBLE_EQ(restored_bids[i].price, bids[i].price);
+        EXPECT_EQ(restored_bids[i].quantity, bids[i].quantity);
+    }
+}
+
+TEST_F(BookSnapshotFileTest, RestoreKeepsCreationTimes)
+{
+    OrderBook book;
+    const auto created_at = std::chrono::system_clock::now() - std::chrono::hours(3);
+    Order order(1234567, Strategy::OTHER, 5, 50.0, OrderSide::BUY, OrderType::LIMIT, 1, created_at);
+    ASSERT_TRUE(book.add_order(order));
+    ASSERT_TRUE(write_book_snapshot(path, 1, {{1, &book}}));
+
+    MappedBookSnapshot snapshot(path);
+    OrderBook restored;
+    ASSERT_TRUE(snapshot.restore(snapshot.books()[0], restored));
+    OrderQueue level = restored.get_bids(50.0);
+    ASSERT_EQ(level.size(), 1u);
+    EXPECT_EQ(std::chrono::duration_cast<std::chrono::nanoseconds>(level[0].get_created_at().time_since_epoch()),
+              std::chrono::duration_cast<std::chrono::nanoseconds>(created_at.time_since_epoch()));
+}
+
+TEST_F(BookSnapshotFileTest, RestoreFailsWhenTheBookRefusesAnOrder)
+{
+    OrderBook book;
+    fill(book, 1);
+    ASSERT_TRUE(write_book_snapshot(path, 1, {{1, &book}}));
+    MappedBookSnapshot snapshot(path);
+
+    // Restored twice, every id is already resting
+    OrderBook restored;
+    ASSERT_TRUE(snapshot.restore(snapshot.books()[0], restored));
+    EXPECT_FALSE(snapshot.restore(snapshot.books()[0], restored));
+
+    // Three bid levels do not fit a 2-tick band
+    OrderBook narrow(0.5, 2);
+    EXPECT_FALSE(snapshot.restore(snapshot.books()[0], narrow));
+}
+
+TEST_F(BookSnapshotFileTest, VerifyDetectsCorruption)
+{
+    OrderBook book;
+    fill(book, 1);
+    ASSERT_TRUE(write_book_snapshot(path, 1, {{1, &book}}));
+
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(sizeof(SnapshotFileHeader) + sizeof(SnapshotBook) + 8);
+        char byte = 0x5a;
+        file.write(&byte, 1);
+    }
+
+    MappedBookSnapshot snapshot(path);
+    EXPECT_FALSE(snapshot.verify());
+}
+
+TEST_F(BookSnapshotFileTest, TruncatedOrMissingFileIsRejected)
+{
+    EXPECT_THROW(MappedBookSnapshot missing(path), std::runtime_error);
+
+    OrderBook book;
+    fill(book, 1);
+    ASSERT_TRUE(write_book_snapshot(path, 1, {{1, &book}}));
+    std::ifstream in(path, std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), bytes.size() - sizeof(SnapshotOrder));
+    }
+    EXPECT_THROW(MappedBookSnapshot truncated(path), std::runtime_error);
+}
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include "BroadcastRing.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct Record
+    {
+        uint64_t value;
+        uint64_t check; // always ~value; a torn read breaks the pair
+    };
+
+    Record make_record(uint64_t value)
+    {
+        return Record{value, ~value};
+    }
+}
+
+TEST(BroadcastRingTest, ReadsInPublishOrder)
+{
+    BroadcastRing<Record> ring(8);
+    EXPECT_EQ(ring.publish(make_record(10)), 1);
+    EXPECT_EQ(ring.publish(make_record(11)), 2);
+
+    uint64_t cursor = 0;
+    Record record;
+    ASSERT_EQ(ring.read(cursor, record), BroadcastRing<Record>::ReadStatus::OK);
+    EXPECT_EQ(record.value, 10);
+    ASSERT_EQ(ring.read(cursor, record), BroadcastRing<Record>::ReadStatus::OK);
+    EXPECT_EQ(record.value, 11);
+    EXPECT_EQ(cursor, 2);
+    EXPECT_EQ(ring.read(cursor, record), BroadcastRing<Record>::ReadStatus::EMPTY);
+}
+
+TEST(BroadcastRingTest, ReadersHaveIndependentCursors)
+{
+    BroadcastRing<Record> ring(8);
+    ring.publish(make_record(1));
+
+    uint64_t reader_a = 0;
+    uint64_t reader_b = 0;
+    Record record;
+    EXPECT_EQ(ring.read(reader_a, record), BroadcastRing<Record>::ReadStatus::OK);
+    EXPECT_EQ(ring.read(reader_b, record), BroadcastRing<Record>::ReadStatus::OK);
+    EXPECT_EQ(record.value, 1);
+
+    // A reader that starts at published() only sees later records
+    uint64_t late_reader = ring.published();
+    EXPECT_EQ(ring.read(late_reader, record), BroadcastRing<Record>::ReadStatus::EMPTY);
+}
+
+TEST(BroadcastRingTest, LappedReaderSkipsToOldestRecord)
+{
+    BroadcastRing<Record> ring(4);
+    for (uint64_t i = 1; i <= 10; ++i)
+    {
+        ring.publish(make_record(i));
+    }
+
+    uint64_t cursor = 0;
+    Record record;
+    EXPECT_EQ(ring.read(cursor, record), BroadcastRing<Record>::ReadStatus::LAPPED);
+    EXPECT_GT(cursor, 6);
+
+    // Everything after the skip is intact and in order
+    uint64_t expected = cursor + 1;
+    while (ring.read(cursor, record) == BroadcastRing<Record>::ReadStatus::OK)
+    {
+        EXPECT_EQ(record.value, expected++);
+    }
+    EXPECT_EQ(expected, 11);
+}
+
+TEST(BroadcastRingTest, ParkedReadersWakeOnNotify)
+{
+    BroadcastRing<Record> ring(8);
+    std::atomic<int> woken(0);
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 3; ++i)
+    {
+        readers.emplace_back([&]
+                             {
+            uint64_t cursor = 0;
+            Record record;
+            while (ring.read(cursor, record) == BroadcastRing<Record>::ReadStatus::EMPTY)
+            {
+                ring.wait(cursor, std::chrono::seconds(10));
+            }
+            woken.fetch_add(1); });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ring.publish(make_record(1));
+    ring.notify_readers();
+    for (auto &reader : readers)
+    {
+        reader.join();
+    }
+
+    EXPECT_EQ(woken.load(), 3);
+    // Every reader was woken by the notify, not by its timeout
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+}
+
+TEST(BroadcastRingTest, WaitTimesOutWithoutAPublish)
+{
+    BroadcastRing<Record> ring(8);
+    auto start = std::chrono::steady_clock::now();
+    ring.wait(0, std::chrono::milliseconds(20));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(15));
+}
+
+TEST(BroadcastRingTest, ConcurrentReaderNeverSeesTornRecords)
+{
+    BroadcastRing<Record> ring(64);
+    const uint64_t total = 200000;
+    std::atomic<bool> done(false);
+
+    std::thread reader([&]
+                       {
+        uint64_t cursor = 0;
+        uint64_t last_value = 0;
+        Record record;
+        while (!done.load() || cursor < ring.published())
+        {
+            if (ring.read(cursor, record) == BroadcastRing<Record>::ReadStatus::OK)
+            {
+                EXPECT_EQ(record.check, ~record.value);
+                EXPECT_GT(record.value, last_value);
+                EXPECT_EQ(record.value, cursor); // value i was published as sequence i
+                last_value = record.value;
+            }
+        } });
+
+    for (uint64_t i = 1; i <= total; ++i)
+    {
+        ring.publish(make_record(i));
+    }
+    done.store(true);
+    reader.join();
+}
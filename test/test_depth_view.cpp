@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include "DepthView.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+
+TEST(DepthViewTest, NothingPublishedReadsNothing)
+{
+    DepthView view(5);
+    DepthSnapshot depth;
+    EXPECT_FALSE(view.read(0, depth));
+}
+
+TEST(DepthViewTest, PublishesBestLevelsWithCounts)
+{
+    OrderBook book;
+    Order bid_a(Strategy::OTHER, 10, 50.0, OrderSide::BUY, OrderType::LIMIT);
+    Order bid_b(Strategy::OTHER, 15, 50.0, OrderSide::BUY, OrderType::LIMIT);
+    Order bid_c(Strategy::OTHER, 20, 49.5, OrderSide::BUY, OrderType::LIMIT);
+    Order bid_d(Strategy::OTHER, 25, 49.0, OrderSide::BUY, OrderType::LIMIT);
+    Order ask(Strategy::OTHER, 7, 51.0, OrderSide::SELL, OrderType::LIMIT);
+    book.add_order(bid_a);
+    book.add_order(bid_b);
+    book.add_order(bid_c);
+    book.add_order(bid_d);
+    book.add_order(ask);
+
+    DepthView view(2);
+    view.publish(3, book);
+
+    DepthSnapshot depth;
+    ASSERT_TRUE(view.read(0, depth));
+    EXPECT_EQ(depth.sequence, 3);
+    ASSERT_EQ(depth.bids.size(), 2); // capped at the view's levels
+    EXPECT_DOUBLE_EQ(depth.bids[0].price, 50.0);
+    EXPECT_EQ(depth.bids[0].quantity, 25);
+    EXPECT_EQ(depth.bids[0].order_count, 2);
+    EXPECT_DOUBLE_EQ(depth.bids[1].price, 49.5);
+    EXPECT_EQ(depth.bids[1].order_count, 1);
+    ASSERT_EQ(depth.asks.size(), 1);
+    EXPECT_EQ(depth.asks[0].quantity, 7);
+
+    ASSERT_TRUE(view.read(1, depth));
+    EXPECT_EQ(depth.bids.size(), 1);
+
+    // The next publish replaces the view, including emptied sides
+    book.cancel_order(ask.get_id());
+    view.publish(4, book);
+    ASSERT_TRUE(view.read(0, depth));
+    EXPECT_EQ(depth.sequence, 4);
+    EXPECT_TRUE(depth.asks.empty());
+}
+
+TEST(DepthViewTest, ConcurrentReaderSeesWholePublishes)
+{
+    // Publish k holds bids at 100.00, 99.99, ... with quantity 1, 2, ... so
+    // a read that mixes two publishes breaks the price/quantity pairing
+    const size_t levels = 8;
+    const uint64_t total = 20000;
+    OrderBook book;
+    DepthView view(levels);
+    std::atomic<bool> done(false);
+
+    std::thread reader([&]
+                       {
+        DepthSnapshot depth;
+        uint64_t last_sequence = 0;
+        while (!done.load())
+        {
+            if (!view.read(0, depth))
+            {
+                continue;
+            }
+            EXPECT_GE(depth.sequence, last_sequence);
+            last_sequence = depth.sequence;
+            EXPECT_EQ(depth.bids.size(), std::min<uint64_t>(depth.sequence, levels));
+            for (size_t i = 0; i < depth.bids.size(); ++i)
+            {
+                // Best first: the newest order has the lowest price, so level i
+                // from the top holds the order added at step i + 1
+                EXPECT_EQ(depth.bids[i].quantity, static_cast<int64_t>(std::llround((100.0 - depth.bids[i].price) / 0.01)) + 1);
+            }
+        } });
+
+    for (uint64_t k = 1; k <= total; ++k)
+    {
+        Order bid(Strategy::OTHER, static_cast<int>(k), 100.0 - static_cast<double>(k - 1) * 0.01, OrderSide::BUY, OrderType::LIMIT);
+        book.add_order(bid);
+        view.publish(k, book);
+    }
+    done.store(true);
+    reader.join();
+}
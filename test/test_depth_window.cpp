@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include "DepthWindow.h"
+
+namespace
+{
+    LevelUpdate level(OrderSide side, double price, int64_t quantity)
+    {
+        return LevelUpdate{0, 0, 0, side, 0, price, quantity};
+    }
+
+    BookSnapshot three_bids()
+    {
+        BookSnapshot snapshot;
+        snapshot.bids = {{50.0, 10}, {49.0, 20}, {48.0, 30}};
+        snapshot.asks = {{51.0, 5}};
+        return snapshot;
+    }
+}
+
+TEST(DepthWindowTest, SnapshotIsCutToTheWindow)
+{
+    DepthWindow window(2);
+    window.reset(three_bids());
+
+    std::vector<LevelQuantity> bids;
+    std::vector<LevelQuantity> asks;
+    window.window(bids, asks);
+    ASSERT_EQ(bids.size(), 2);
+    EXPECT_DOUBLE_EQ(bids[0].price, 50.0);
+    EXPECT_DOUBLE_EQ(bids[1].price, 49.0);
+    ASSERT_EQ(asks.size(), 1);
+}
+
+TEST(DepthWindowTest, UpdatesBelowTheWindowAreAbsorbed)
+{
+    DepthWindow window(2);
+    window.reset(three_bids());
+    std::vector<LevelQuantity> bids;
+    std::vector<LevelQuantity> asks;
+    window.window(bids, asks);
+
+    window.apply(level(OrderSide::BUY, 48.0, 35));
+    window.apply(level(OrderSide::BUY, 47.0, 40));
+    EXPECT_FALSE(window.changes(bids, asks));
+}
+
+TEST(DepthWindowTest, LevelMovingIntoTheWindowIsSent)
+{
+    DepthWindow window(2);
+    window.reset(three_bids());
+    std::vector<LevelQuantity> bids;
+    std::vector<LevelQuantity> asks;
+    window.window(bids, asks);
+
+    // The best bid empties, so 48.0 moves up into the window
+    window.apply(level(OrderSide::BUY, 50.0, 0));
+    ASSERT_TRUE(window.changes(bids, asks));
+    ASSERT_EQ(bids.size(), 2);
+    EXPECT_DOUBLE_EQ(bids[0].price, 48.0);
+    EXPECT_EQ(bids[0].quantity, 30);
+    EXPECT_DOUBLE_EQ(bids[1].price, 50.0);
+    EXPECT_EQ(bids[1].quantity, 0);
+    EXPECT_TRUE(asks.empty());
+}
+
+TEST(DepthWindowTest, LevelPushedOutOfTheWindowIsRemoved)
+{
+    DepthWindow window(2);
+    window.reset(three_bids());
+    std::vector<LevelQuantity> bids;
+    std::vector<LevelQuantity> asks;
+    window.window(bids, asks);
+
+    window.apply(level(OrderSide::BUY, 50.5, 1));
+    window.apply(level(OrderSide::SELL, 51.0, 3));
+    ASSERT_TRUE(window.changes(bids, asks));
+    ASSERT_EQ(bids.size(), 2);
+    EXPECT_DOUBLE_EQ(bids[0].price, 50.5);
+    EXPECT_DOUBLE_EQ(bids[1].price, 49.0);
+    EXPECT_EQ(bids[1].quantity, 0);
+    ASSERT_EQ(asks.size(), 1);
+    EXPECT_EQ(asks[0].quantity, 3);
+}
+
+TEST(DepthWindowTest, ZeroDepthPassesEveryUpdateThrough)
+{
+    DepthWindow window(0);
+    window.reset(three_bids());
+    std::vector<LevelQuantity> bids;
+    std::vector<LevelQuantity> asks;
+    window.window(bids, asks);
+    EXPECT_EQ(bids.size(), 3);
+
+    window.apply(level(OrderSide::BUY, 40.0, 7));
+    ASSERT_TRUE(window.changes(bids, asks));
+    ASSERT_EQ(bids.size(), 1);
+    EXPECT_DOUBLE_EQ(bids[0].price, 40.0);
+    EXPECT_FALSE(window.changes(bids, asks));
+}
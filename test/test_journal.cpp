@@ -0,0 +1,360 @@
+#include <gtest/gtest.h>
+#include "Journal.h"
+#include "MatchingEngine.h"
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/stat.h>
+
+class JournalTest : public ::testing::Test
+{
+protected:
+    std::string path;
+
+    void SetUp() override
+    {
+        path = ::testing::TempDir() + "journal_test_" +
+               ::testing::UnitTest::GetInstance()->current_test_info()->name() + ".log";
+        std::remove(path.c_str());
+    }
+
+    void TearDown() override
+    {
+        std::remove(path.c_str());
+    }
+
+    static JournalRecord submit_record(uint64_t order_id, int32_t quantity)
+    {
+        JournalRecord record{};
+        record.type = JournalRecordType::SUBMIT;
+        record.order_id = order_id;
+        record.quantity = quantity;
+        record.price = 50.0;
+        return record;
+    }
+
+    std::vector<JournalRecord> read_all()
+    {
+        std::vector<JournalRecord> records;
+        JournalReader reader(path);
+        JournalRecord record;
+        while (reader.next(record))
+        {
+            records.push_back(record);
+        }
+        return records;
+    }
+};
+
+TEST_F(JournalTest, AppendsSequencedRecords)
+{
+    {
+        JournalWriter writer(path, 16);
+        for (uint64_t i = 1; i <= 5; ++i)
+        {
+            JournalRecord record = submit_record(100 + i, 10);
+            EXPECT_EQ(writer.append(record), i);
+        }
+        EXPECT_TRUE(writer.sync());
+        EXPECT_EQ(writer.synced_sequence(), 5);
+    }
+
+    std::vector<JournalRecord> records = read_all();
+    ASSERT_EQ(records.size(), 5);
+    for (size_t i = 0; i < records.size(); ++i)
+    {
+        EXPECT_EQ(records[i].sequence, i + 1);
+        EXPECT_EQ(records[i].order_id, 101 + i);
+        EXPECT_EQ(records[i].type, JournalRecordType::SUBMIT);
+    }
+}
+
+TEST_F(JournalTest, ReopenContinuesAfterLastRecord)
+{
+    {
+        JournalWriter writer(path, 16);
+        JournalRecord record = submit_record(1, 10);
+        writer.append(record);
+        record = submit_record(2, 10);
+        writer.append(record);
+    }
+
+    JournalWriter writer(path, 16);
+    EXPECT_EQ(writer.last_sequence(), 2);
+    JournalRecord record = submit_record(3, 10);
+    EXPECT_EQ(writer.append(record), 3);
+}
+
+TEST_F(JournalTest, GrowsPastPreallocatedSize)
+{
+    {
+        JournalWriter writer(path, 4);
+        for (uint64_t i = 1; i <= 100; ++i)
+        {
+            JournalRecord record = submit_record(i, 1);
+            writer.append(record);
+        }
+        EXPECT_GE(writer.capacity(), 100);
+    }
+
+    EXPECT_EQ(read_all().size(), 100);
+}
+
+TEST_F(JournalTest, TornRecordEndsTheLog)
+{
+    {
+        JournalWriter writer(path, 16);
+        for (uint64_t i = 1; i <= 3; ++i)
+        {
+            JournalRecord record = submit_record(i, 1);
+            writer.append(record);
+        }
+    }
+
+    // Corrupt the quantity of record 2 as a crash mid-write would
+    std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(2 * sizeof(JournalRecord) + offsetof(JournalRecord, quantity));
+    int32_t garbage = 12345;
+    file.write(reinterpret_cast<const char *>(&garbage), sizeof(garbage));
+    file.close();
+
+    EXPECT_EQ(read_all().size(), 1);
+    JournalWriter writer(path, 16);
+    EXPECT_EQ(writer.last_sequence(), 1);
+}
+
+TEST_F(JournalTest, RejectsFilesThatAreNotJournals)
+{
+    std::ofstream(path) << "not a journal, just some text that is long enough to fill a header slot";
+    EXPECT_THROW(JournalWriter writer(path, 16), std::runtime_error);
+    EXPECT_THROW(JournalReader reader(path), std::runtime_error);
+}
+
+TEST_F(JournalTest, RefusesALogFromAnotherShardLayout)
+{
+    {
+        JournalWriter writer(path, 16, 2, 1);
+        JournalRecord record = submit_record(1, 10);
+        writer.append(record);
+    }
+
+    JournalReader reader(path);
+    EXPECT_EQ(reader.shard_count(), 2);
+    EXPECT_EQ(reader.shard_index(), 1);
+    EXPECT_NO_THROW(check_journal_layout(path, 2, 1));
+    EXPECT_THROW(check_journal_layout(path, 3, 1), std::runtime_error);
+    EXPECT_THROW(check_journal_layout(path, 2, 0), std::runtime_error);
+    EXPECT_THROW(JournalWriter writer(path, 16, 3, 1), std::runtime_error);
+    EXPECT_NO_THROW(check_journal_layout(path + ".missing", 3, 1));
+
+    // The engine refuses it before replaying a record
+    MatchingEngineConfig config;
+    config.journal.path = path;
+    config.journal.recover = true;
+    EXPECT_THROW(MatchingEngine engine(config), std::runtime_error);
+}
+
+TEST_F(JournalTest, RefusesALogFromAnotherPriceBand)
+{
+    {
+        JournalWriter writer(path, 16, 1, 0, 100);
+        JournalRecord record = submit_record(1, 10);
+        writer.append(record);
+    }
+
+    JournalReader reader(path);
+    EXPECT_EQ(reader.max_price_levels(), 100);
+    EXPECT_NO_THROW(check_journal_layout(path, 1, 0, 100));
+    EXPECT_THROW(check_journal_layout(path, 1, 0, 200), std::runtime_error);
+    EXPECT_THROW(JournalWriter writer(path, 16, 1, 0, 200), std::runtime_error);
+
+    MatchingEngineConfig config;
+    config.journal.path = path;
+    config.journal.recover = true;
+    EXPECT_THROW(MatchingEngine engine(config), std::runtime_error);
+    config.max_price_levels = 100;
+    EXPECT_NO_THROW(MatchingEngine engine(config));
+}
+
+TEST_F(JournalTest, RefusesALogFromOtherTickSizes)
+{
+    TickSizes tick_sizes;
+    tick_sizes.per_symbol[7] = 0.05;
+    {
+        JournalWriter writer(path, 16, 1, 0, PriceLadder::kDefaultMaxLevels, tick_sizes.digest());
+        JournalRecord record = submit_record(1, 10);
+        writer.append(record);
+    }
+
+    JournalReader reader(path);
+    EXPECT_EQ(reader.tick_size_digest(), tick_sizes.digest());
+    EXPECT_NE(tick_sizes.digest(), TickSizes().digest());
+    EXPECT_THROW(check_journal_layout(path, 1, 0), std::runtime_error);
+
+    MatchingEngineConfig config;
+    config.journal.path = path;
+    config.journal.recover = true;
+    EXPECT_THROW(MatchingEngine engine(config), std::runtime_error);
+    config.tick_sizes = tick_sizes;
+    EXPECT_NO_THROW(MatchingEngine engine(config));
+}
+
+TEST_F(JournalTest, OlderLogTakesTheLayoutItIsOpenedWith)
+{
+    {
+        JournalWriter writer(path, 16);
+    }
+    // Clear the layout fields as a log written before they existed
+    std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(16);
+    const uint32_t zeros[2] = {0, 0};
+    file.write(reinterpret_cast<const char *>(zeros), sizeof(zeros));
+    file.close();
+
+    EXPECT_NO_THROW(check_journal_layout(path, 4, 2));
+    {
+        JournalWriter writer(path, 16, 4, 2);
+    }
+    EXPECT_THROW(check_journal_layout(path, 1, 0), std::runtime_error);
+}
+
+TEST_F(JournalTest, EngineJournalsCommandsBeforeMatching)
+{
+    MatchingEngineConfig config;
+    config.journal.path = path;
+    config.journal.initial_records = 64;
+
+    std::vector<uint64_t> order_ids;
+    {
+        MatchingEngine engine(config);
+        for (int i = 0; i < 10; ++i)
+        {
+            Order order(Strategy::OTHER, 10 + i, 50.0 + i, OrderSide::BUY, OrderType::LIMIT, 7);
+            order_ids.push_back(order.get_id());
+            engine.process_order(order);
+        }
+        engine.cancel_order(order_ids[3], 7);
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (engine.get_stats().commands_processed < 11 && std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        EngineStats stats = engine.get_stats();
+        EXPECT_EQ(stats.commands_processed, 11);
+        EXPECT_EQ(stats.journaled_commands, 11);
+        EXPECT_GE(stats.journal_syncs, 1);
+
+        // Snapshots pass through the journal stage but are not recorded
+        BookSnapshot snapshot;
+        ASSERT_TRUE(engine.get_snapshot(7, 0, snapshot));
+        EXPECT_EQ(snapshot.bids.size(), 9);
+        EXPECT_EQ(engine.get_stats().journaled_commands, 11);
+    }
+
+    std::vector<JournalRecord> records = read_all();
+    ASSERT_EQ(records.size(), 11);
+    for (int i = 0; i < 10; ++i)
+    {
+        EXPECT_EQ(records[i].type, JournalRecordType::SUBMIT);
+        EXPECT_EQ(records[i].order_id, order_ids[i]);
+        EXPECT_EQ(records[i].quantity, 10 + i);
+        EXPECT_DOUBLE_EQ(records[i].price, 50.0 + i);
+        EXPECT_EQ(records[i].symbol_id, 7);
+        EXPECT_EQ(records[i].side, static_cast<uint8_t>(OrderSide::BUY));
+    }
+    EXPECT_EQ(records[10].type, JournalRecordType::CANCEL);
+    EXPECT_EQ(records[10].order_id, order_ids[3]);
+}
+
+TEST_F(JournalTest, ShutdownJournalsAndMatchesEverythingAccepted)
+{
+    MatchingEngineConfig config;
+    config.journal.path = path;
+    config.journal.initial_records = 64;
+
+    const int orders = 2000;
+    {
+        MatchingEngine engine(config);
+        for (int i = 0; i < orders; ++i)
+        {
+            Order order(Strategy::OTHER, 1, 50.0, OrderSide::BUY, OrderType::LIMIT, 7);
+            ASSERT_TRUE(engine.process_order(order));
+        }
+        // Destroyed with most of them still queued
+    }
+    EXPECT_EQ(read_all().size(), static_cast<size_t>(orders));
+}
+
+TEST_F(JournalTest, FailedJournalRefusesCommandsInsteadOfMatchingThem)
+{
+    MatchingEngineConfig config;
+    config.journal.path = path;
+    config.journal.initial_records = 16;
+
+    // Growing the log past the file size limit fails, as a full disk would
+    struct rlimit saved;
+    ASSERT_EQ(::getrlimit(RLIMIT_FSIZE, &saved), 0);
+    auto saved_handler = std::signal(SIGXFSZ, SIG_IGN);
+    size_t matched = 0;
+    {
+        MatchingEngine engine(config);
+        const ExecutionStream &executions = engine.get_execution_stream();
+        uint64_t cursor = executions.published();
+        struct stat st;
+        ASSERT_EQ(::stat(path.c_str(), &st), 0);
+        struct rlimit limit = saved;
+        limit.rlim_cur = static_cast<rlim_t>(st.st_size);
+        ASSERT_EQ(::setrlimit(RLIMIT_FSIZE, &limit), 0);
+
+        int accepted = 0;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (!engine.get_stats().journal_failed && std::chrono::steady_clock::now() < deadline)
+        {
+            Order order(Strategy::OTHER, 1, 50.0, OrderSide::BUY, OrderType::LIMIT, 7);
+            accepted += engine.process_order(order) ? 1 : 0;
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        ::setrlimit(RLIMIT_FSIZE, &saved);
+
+        EngineStats stats = engine.get_stats();
+        ASSERT_TRUE(stats.journal_failed);
+        Order late(Strategy::OTHER, 1, 50.0, OrderSide::BUY, OrderType::LIMIT, 7);
+        EXPECT_FALSE(engine.process_order(late));
+        EXPECT_FALSE(engine.cancel_order(late.get_id(), 7));
+
+        OrderOutcome outcome;
+        ASSERT_TRUE(engine.process_order_sync(late, outcome));
+        EXPECT_EQ(outcome.status, OrderStatus::REJECTED);
+
+        // Only what reached the journal was matched
+        BookSnapshot snapshot;
+        ASSERT_TRUE(engine.get_snapshot(7, 0, snapshot));
+        ASSERT_EQ(snapshot.bids.size(), 1u);
+        matched = static_cast<size_t>(snapshot.bids[0].quantity);
+        EXPECT_EQ(matched, engine.get_stats().journaled_commands);
+        EXPECT_LT(engine.get_stats().journaled_commands, static_cast<uint64_t>(accepted));
+
+        // Every accepted order the journal then refused got a terminal report
+        uint64_t rejects = 0;
+        ExecutionEvent event;
+        while (executions.read(cursor, event) == ExecutionStream::ReadStatus::OK)
+        {
+            EXPECT_EQ(event.type, ExecutionType::REJECT);
+            ++rejects;
+        }
+        EXPECT_GT(rejects, 0u);
+        EXPECT_EQ(rejects, accepted - engine.get_stats().journaled_commands);
+    }
+    std::signal(SIGXFSZ, saved_handler);
+
+    // and the refused group left no records behind for recovery to replay
+    EXPECT_EQ(read_all().size(), matched);
+}
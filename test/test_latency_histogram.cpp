@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include "CycleClock.h"
+#include "LatencyHistogram.h"
+#include <thread>
+#include <vector>
+
+TEST(LatencyHistogramTest, EmptyHistogramReportsZero)
+{
+    LatencyHistogram histogram;
+    EXPECT_EQ(histogram.count(), 0);
+    EXPECT_EQ(histogram.max(), 0);
+    EXPECT_EQ(histogram.percentile(0.99), 0);
+}
+
+TEST(LatencyHistogramTest, PercentilesAreWithinBucketPrecision)
+{
+    LatencyHistogram histogram;
+    for (uint64_t value = 1; value <= 100000; ++value)
+    {
+        histogram.record(value);
+    }
+    EXPECT_EQ(histogram.count(), 100000);
+    EXPECT_EQ(histogram.max(), 100000);
+
+    // Exact below 128, then within 1/64 above
+    EXPECT_NEAR(static_cast<double>(histogram.percentile(0.50)), 50000.0, 50000.0 / 64);
+    EXPECT_NEAR(static_cast<double>(histogram.percentile(0.99)), 99000.0, 99000.0 / 64);
+    EXPECT_NEAR(static_cast<double>(histogram.percentile(0.999)), 99900.0, 99900.0 / 64);
+    EXPECT_EQ(histogram.percentile(1.0), 100000);
+    EXPECT_EQ(histogram.percentile(0.0001), 10);
+}
+
+TEST(LatencyHistogramTest, TailIsNotAveragedAway)
+{
+    LatencyHistogram histogram;
+    for (int i = 0; i < 9990; ++i)
+    {
+        histogram.record(200);
+    }
+    for (int i = 0; i < 10; ++i)
+    {
+        histogram.record(5000000);
+    }
+    EXPECT_LE(histogram.percentile(0.99), 203);
+    EXPECT_GE(histogram.percentile(0.9995), 5000000 - 5000000 / 64);
+    EXPECT_EQ(histogram.max(), 5000000);
+}
+
+TEST(LatencyHistogramTest, MergeAddsCounts)
+{
+    LatencyHistogram first;
+    LatencyHistogram second;
+    first.record(100);
+    second.record(300);
+    second.record(70000);
+
+    LatencyHistogram merged;
+    merged.merge(first);
+    merged.merge(second);
+    EXPECT_EQ(merged.count(), 3);
+    EXPECT_EQ(merged.max(), 70000);
+    EXPECT_EQ(merged.percentile(0.3), 100);
+}
+
+TEST(LatencyRecorderTest, MergesEveryThreadsHistograms)
+{
+    LatencyRecorder recorder;
+    const int threads = 4;
+    const int per_thread = 1000;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&recorder]
+                             {
+            for (int i = 0; i < per_thread; ++i)
+            {
+                uint64_t received = CycleClock::now();
+                recorder.record(LatencyStage::ENQUEUED, received, CycleClock::now());
+            } });
+    }
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+
+    LatencyHistogram enqueued;
+    recorder.merge_stage(LatencyStage::ENQUEUED, enqueued);
+    EXPECT_EQ(enqueued.count(), threads * per_thread);
+    LatencyHistogram acked;
+    recorder.merge_stage(LatencyStage::ACKED, acked);
+    EXPECT_EQ(acked.count(), 0);
+}
+
+TEST(LatencyRecorderTest, ExitedThreadsKeepTheirCounts)
+{
+    LatencyRecorder recorder;
+    for (int t = 0; t < 20; ++t)
+    {
+        std::thread worker([&recorder]
+                           {
+            uint64_t received = CycleClock::now();
+            recorder.record(LatencyStage::ACKED, received, CycleClock::now()); });
+        worker.join();
+    }
+
+    LatencyHistogram acked;
+    recorder.merge_stage(LatencyStage::ACKED, acked);
+    EXPECT_EQ(acked.count(), 20);
+}
+
+TEST(CycleClockTest, TicksConvertToElapsedTime)
+{
+    uint64_t start = CycleClock::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    uint64_t elapsed = CycleClock::to_nanoseconds(CycleClock::now() - start);
+    EXPECT_GE(elapsed, 15000000u);
+    EXPECT_LT(elapsed, 1000000000u);
+}
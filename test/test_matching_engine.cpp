@@ -5,6 +5,7 @@
 #include <atomic>   // Added for atomic operations in pressure tests
 #include <iostream> // Added for printing test results
 #include <vector>   // Added for vector containers
+#include <map>
 
 class MatchingEngineTest : public ::testing::Test
 {
@@ -134,6 +135,473 @@ TEST_F(MatchingEngineTest, LimitOrdersMatchAtCorrectPrice)
     EXPECT_EQ(sell_limit.get_quantity(), 150);     // Original unchanged
 }
 
+TEST_F(MatchingEngineTest, CancelOrderIsAccepted)
+{
+    MatchingEngine engine;
+
+    engine.process_order(*buy_order_1);
+    EXPECT_NO_THROW(engine.cancel_order(buy_order_1->get_id()));
+
+    // Cancelling an unknown id is a no-op on the matching thread
+    EXPECT_NO_THROW(engine.cancel_order(12345));
+    wait_for_processing();
+}
+
+// Test Wait Strategies
+TEST_F(MatchingEngineTest, EveryWaitStrategyProcessesOrders)
+{
+    for (WaitStrategyType type : {WaitStrategyType::BUSY_SPIN, WaitStrategyType::SPIN_YIELD, WaitStrategyType::BLOCKING})
+    {
+        MatchingEngineConfig config;
+        config.wait_strategy = type;
+        MatchingEngine engine(config);
+
+        EXPECT_NO_THROW({
+            engine.process_order(*sell_order_1);
+            engine.process_order(*buy_order_1);
+            engine.cancel_order(sell_order_1->get_id());
+        });
+        wait_for_processing(20);
+    }
+}
+
+TEST_F(MatchingEngineTest, BlockingEngineShutsDownWhileParked)
+{
+    MatchingEngineConfig config;
+    config.wait_strategy = WaitStrategyType::BLOCKING;
+    config.spin_iterations = 0; // park on the first empty poll
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        MatchingEngine engine(config);
+        wait_for_processing(20); // matching thread is parked by now
+        engine.process_order(*buy_order_1);
+        wait_for_processing(20);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_LT(elapsed, std::chrono::seconds(1));
+}
+
+TEST_F(MatchingEngineTest, BatchesAreBoundedAndCounted)
+{
+    std::atomic<int> batch_callbacks(0);
+    MatchingEngineConfig config;
+    config.batch_size = 8;
+    config.on_batch = [&](SymbolId, const OrderBook &)
+    { batch_callbacks.fetch_add(1); };
+    MatchingEngine engine(config);
+
+    const int num_orders = 1000;
+    for (int i = 0; i < num_orders; ++i)
+    {
+        Order order(Strategy::OTHER, 10, 50.0 + (i % 10) * 0.01, i % 2 ? OrderSide::BUY : OrderSide::SELL, OrderType::LIMIT);
+        engine.process_order(order);
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (engine.get_stats().commands_processed < num_orders && std::chrono::steady_clock::now() < deadline)
+    {
+        wait_for_processing(1);
+    }
+
+    EngineStats stats = engine.get_stats();
+    EXPECT_EQ(stats.commands_processed, num_orders);
+    EXPECT_EQ(stats.queue_depth, 0);
+    EXPECT_EQ(stats.queue_capacity, config.queue_capacity);
+    EXPECT_EQ(stats.journal_queue_capacity, 0);
+    EXPECT_EQ(stats.batch_size_limit, 8);
+    EXPECT_GE(stats.batches, num_orders / 8);
+    EXPECT_LE(stats.max_batch_size, 8);
+    EXPECT_GE(stats.max_batch_size, 1);
+    // The hook runs right after a batch is counted, so it may trail by one
+    EXPECT_LE(batch_callbacks.load(), static_cast<int>(stats.batches));
+    EXPECT_GE(batch_callbacks.load(), static_cast<int>(stats.batches) - 1);
+}
+
+TEST_F(MatchingEngineTest, FillsAppearOnExecutionStream)
+{
+    MatchingEngine engine;
+    const ExecutionStream &executions = engine.get_execution_stream();
+    uint64_t cursor = executions.published();
+
+    engine.process_order(*sell_order_1); // Sell 150 @ 51.0
+    Order buy(Strategy::OTHER, 100, 51.0, OrderSide::BUY, OrderType::LIMIT);
+    engine.process_order(buy);
+
+    ExecutionEvent event;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (executions.read(cursor, event) != ExecutionStream::ReadStatus::OK &&
+           std::chrono::steady_clock::now() < deadline)
+    {
+        wait_for_processing(1);
+    }
+
+    EXPECT_EQ(event.taker_order_id, buy.get_id());
+    EXPECT_EQ(event.maker_order_id, sell_order_1->get_id());
+    EXPECT_EQ(event.quantity, 100);
+    EXPECT_DOUBLE_EQ(event.price, 51.0);
+}
+
+TEST_F(MatchingEngineTest, AmendsReportTheBooksResult)
+{
+    MatchingEngine engine;
+    const ExecutionStream &executions = engine.get_execution_stream();
+    uint64_t cursor = executions.published();
+
+    Order maker(Strategy::OTHER, 100, 51.0, OrderSide::SELL, OrderType::POST_ONLY);
+    engine.process_order(maker);
+    Order bid(Strategy::OTHER, 100, 50.0, OrderSide::BUY, OrderType::LIMIT);
+    engine.process_order(bid);
+
+    OrderOutcome outcome;
+    ASSERT_TRUE(engine.amend_order_sync(maker.get_id(), 0, 52.0, 60, outcome));
+    EXPECT_EQ(outcome.status, OrderStatus::PENDING);
+    EXPECT_EQ(outcome.resting_quantity, 60);
+
+    // Crossing the bid is refused for a post-only order, which stays as it was
+    ASSERT_TRUE(engine.amend_order_sync(maker.get_id(), 0, 50.0, 60, outcome));
+    EXPECT_EQ(outcome.status, OrderStatus::REJECTED);
+
+    // A crossing amend trades the whole order
+    ASSERT_TRUE(engine.amend_order_sync(bid.get_id(), 0, 52.0, 60, outcome));
+    EXPECT_EQ(outcome.status, OrderStatus::FILLED);
+    EXPECT_EQ(outcome.resting_quantity, 0);
+
+    ASSERT_TRUE(engine.amend_order_sync(bid.get_id(), 0, 50.0, 10, outcome));
+    EXPECT_EQ(outcome.status, OrderStatus::REJECTED);
+
+    std::vector<ExecutionEvent> events;
+    ExecutionEvent event;
+    while (executions.read(cursor, event) == ExecutionStream::ReadStatus::OK)
+    {
+        events.push_back(event);
+    }
+    ASSERT_EQ(events.size(), 5);
+    EXPECT_EQ(events[0].type, ExecutionType::REPLACE);
+    EXPECT_EQ(events[0].taker_order_id, maker.get_id());
+    EXPECT_DOUBLE_EQ(events[0].price, 52.0);
+    EXPECT_EQ(events[0].quantity, 60);
+    EXPECT_EQ(events[1].type, ExecutionType::REPLACE_REJECT);
+    EXPECT_EQ(events[1].taker_order_id, maker.get_id());
+    // The replace precedes the fills it causes, so they count down from 60
+    EXPECT_EQ(events[2].type, ExecutionType::REPLACE);
+    EXPECT_EQ(events[2].taker_order_id, bid.get_id());
+    EXPECT_EQ(events[3].type, ExecutionType::FILL);
+    EXPECT_EQ(events[3].quantity, 60);
+    EXPECT_EQ(events[4].type, ExecutionType::REPLACE_REJECT);
+    EXPECT_EQ(events[4].taker_order_id, bid.get_id());
+}
+
+TEST_F(MatchingEngineTest, CancelsReportWhetherTheOrderWasRemoved)
+{
+    MatchingEngine engine;
+    const SymbolId symbol = 3;
+
+    Order bid(Strategy::OTHER, 100, 50.0, OrderSide::BUY, OrderType::LIMIT, symbol);
+    engine.process_order(bid);
+    const ExecutionStream &executions = engine.get_execution_stream();
+    uint64_t cursor = executions.published();
+
+    // The order is not on symbol 0, so a cancel that omits the symbol finds nothing
+    OrderOutcome outcome;
+    ASSERT_TRUE(engine.cancel_order_sync(bid.get_id(), 0, outcome));
+    EXPECT_EQ(outcome.status, OrderStatus::REJECTED);
+
+    ASSERT_TRUE(engine.cancel_order_sync(bid.get_id(), symbol, outcome));
+    EXPECT_EQ(outcome.status, OrderStatus::CANCELLED);
+
+    ASSERT_TRUE(engine.cancel_order_sync(bid.get_id(), symbol, outcome));
+    EXPECT_EQ(outcome.status, OrderStatus::REJECTED);
+
+    // Each cancel leaves one report on the execution stream
+    const ExecutionType expected[] = {ExecutionType::CANCEL_REJECT, ExecutionType::CANCEL, ExecutionType::CANCEL_REJECT};
+    for (ExecutionType type : expected)
+    {
+        ExecutionEvent event;
+        ASSERT_EQ(executions.read(cursor, event), ExecutionStream::ReadStatus::OK);
+        EXPECT_EQ(event.type, type);
+        EXPECT_EQ(event.taker_order_id, bid.get_id());
+    }
+}
+
+TEST_F(MatchingEngineTest, QueryReflectsEverythingQueuedBeforeIt)
+{
+    MatchingEngine engine;
+
+    Order ask(Strategy::OTHER, 100, 51.0, OrderSide::SELL, OrderType::LIMIT);
+    engine.process_order(ask);
+    Order buy(Strategy::OTHER, 30, 51.0, OrderSide::BUY, OrderType::LIMIT);
+    engine.process_order(buy);
+
+    OrderOutcome outcome;
+    ASSERT_TRUE(engine.query_order(ask.get_id(), 0, outcome));
+    EXPECT_EQ(outcome.status, OrderStatus::PENDING);
+    EXPECT_EQ(outcome.resting_quantity, 70);
+    // The fill is the only event published before the lookup ran
+    EXPECT_EQ(outcome.execution_sequence, engine.get_execution_stream().published());
+    EXPECT_EQ(outcome.execution_sequence, 1u);
+
+    ASSERT_TRUE(engine.query_order(buy.get_id(), 0, outcome));
+    EXPECT_EQ(outcome.status, OrderStatus::CANCELLED);
+    EXPECT_EQ(outcome.resting_quantity, 0);
+
+    engine.cancel_order(ask.get_id());
+    ASSERT_TRUE(engine.query_order(ask.get_id(), 0, outcome));
+    EXPECT_EQ(outcome.status, OrderStatus::CANCELLED);
+    EXPECT_EQ(outcome.execution_sequence, 2u);
+}
+
+TEST_F(MatchingEngineTest, SnapshotPlusDeltasTrackTheBook)
+{
+    MatchingEngine engine;
+    const SymbolId symbol = 9;
+
+    Order early_bid(Strategy::OTHER, 100, 50.0, OrderSide::BUY, OrderType::LIMIT, symbol);
+    engine.process_order(early_bid);
+
+    BookSnapshot snapshot;
+    ASSERT_TRUE(engine.get_snapshot(symbol, 0, snapshot));
+    ASSERT_EQ(snapshot.bids.size(), 1);
+    EXPECT_EQ(snapshot.bids[0].quantity, 100);
+
+    // Rebuild the book from the snapshot plus every later delta
+    std::map<double, int64_t> bids;
+    std::map<double, int64_t> asks;
+    for (const LevelQuantity &level : snapshot.bids)
+    {
+        bids[level.price] = level.quantity;
+    }
+
+    Order later_bid(Strategy::OTHER, 40, 49.0, OrderSide::BUY, OrderType::LIMIT, symbol);
+    Order ask(Strategy::OTHER, 70, 51.0, OrderSide::SELL, OrderType::LIMIT, symbol);
+    Order hit(Strategy::OTHER, 60, 0.0, OrderSide::SELL, OrderType::MARKET, symbol);
+    Order other_symbol(Strategy::OTHER, 5, 50.0, OrderSide::BUY, OrderType::LIMIT, symbol + 1);
+    engine.process_order(later_bid);
+    engine.process_order(ask);
+    engine.process_order(hit);
+    engine.process_order(other_symbol);
+
+    BookSnapshot final_snapshot;
+    ASSERT_TRUE(engine.get_snapshot(symbol, 0, final_snapshot));
+
+    // The final snapshot may be taken mid-batch; that batch's deltas are
+    // published after it, so wait for the batch to finish before draining
+    wait_for_processing(20);
+
+    const MarketDataStream &stream = engine.get_market_data_stream();
+    uint64_t cursor = snapshot.market_data_sequence;
+    LevelUpdate update;
+    MarketDataStream::ReadStatus status;
+    while ((status = stream.read(cursor, update)) != MarketDataStream::ReadStatus::EMPTY)
+    {
+        ASSERT_EQ(status, MarketDataStream::ReadStatus::OK);
+        if (update.symbol_id != symbol)
+        {
+            continue;
+        }
+        auto &side = update.side == OrderSide::BUY ? bids : asks;
+        if (update.quantity == 0)
+        {
+            side.erase(update.price);
+        }
+        else
+        {
+            side[update.price] = update.quantity;
+        }
+    }
+
+    ASSERT_EQ(bids.size(), final_snapshot.bids.size());
+    ASSERT_EQ(asks.size(), final_snapshot.asks.size());
+    for (const LevelQuantity &level : final_snapshot.bids)
+    {
+        EXPECT_EQ(bids[level.price], level.quantity);
+    }
+    for (const LevelQuantity &level : final_snapshot.asks)
+    {
+        EXPECT_EQ(asks[level.price], level.quantity);
+    }
+    EXPECT_EQ(bids[50.0], 40);
+}
+
+TEST_F(MatchingEngineTest, TopOfBookIsPublishedAfterEachBatch)
+{
+    MatchingEngine engine;
+    const SymbolId symbol = 4;
+
+    TopOfBook top;
+    EXPECT_FALSE(engine.get_top_of_book(symbol, top)); // no book yet
+
+    Order bid(Strategy::OTHER, 100, 50.0, OrderSide::BUY, OrderType::LIMIT, symbol);
+    Order better_bid(Strategy::OTHER, 30, 50.5, OrderSide::BUY, OrderType::LIMIT, symbol);
+    Order ask(Strategy::OTHER, 70, 51.0, OrderSide::SELL, OrderType::LIMIT, symbol);
+    Order hit(Strategy::OTHER, 10, 0.0, OrderSide::SELL, OrderType::MARKET, symbol);
+    engine.process_order(bid);
+    engine.process_order(better_bid);
+    engine.process_order(ask);
+    engine.process_order(hit);
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!(engine.get_top_of_book(symbol, top) && top.has_ask && top.bid_quantity == 20) &&
+           std::chrono::steady_clock::now() < deadline)
+    {
+        wait_for_processing(1);
+    }
+
+    EXPECT_EQ(top.symbol_id, symbol);
+    EXPECT_GT(top.sequence, 0);
+    ASSERT_TRUE(top.has_bid);
+    EXPECT_DOUBLE_EQ(top.bid_price, 50.5);
+    EXPECT_EQ(top.bid_quantity, 20);
+    ASSERT_TRUE(top.has_ask);
+    EXPECT_DOUBLE_EQ(top.ask_price, 51.0);
+    EXPECT_EQ(top.ask_quantity, 70);
+}
+
+TEST_F(MatchingEngineTest, DepthViewMatchesTheBook)
+{
+    MatchingEngineConfig config;
+    config.depth_levels = 2;
+    MatchingEngine engine(config);
+    const SymbolId symbol = 6;
+
+    DepthSnapshot depth;
+    EXPECT_FALSE(engine.get_depth(symbol, 0, depth));
+
+    Order bid(Strategy::OTHER, 100, 50.0, OrderSide::BUY, OrderType::LIMIT, symbol);
+    Order same_level(Strategy::OTHER, 20, 50.0, OrderSide::BUY, OrderType::LIMIT, symbol);
+    Order lower(Strategy::OTHER, 30, 49.0, OrderSide::BUY, OrderType::LIMIT, symbol);
+    Order lowest(Strategy::OTHER, 40, 48.0, OrderSide::BUY, OrderType::LIMIT, symbol);
+    engine.process_order(bid);
+    engine.process_order(same_level);
+    engine.process_order(lower);
+    engine.process_order(lowest);
+
+    // The snapshot round trip returns after the batch holding the orders was
+    // drained; the depth view is published when that batch finishes
+    BookSnapshot snapshot;
+    ASSERT_TRUE(engine.get_snapshot(symbol, 0, snapshot));
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!(engine.get_depth(symbol, 0, depth) && depth.bids.size() == 2) &&
+           std::chrono::steady_clock::now() < deadline)
+    {
+        wait_for_processing(1);
+    }
+
+    EXPECT_EQ(depth.symbol_id, symbol);
+    ASSERT_EQ(depth.bids.size(), 2);
+    for (size_t i = 0; i < depth.bids.size(); ++i)
+    {
+        EXPECT_DOUBLE_EQ(depth.bids[i].price, snapshot.bids[i].price);
+        EXPECT_EQ(depth.bids[i].quantity, snapshot.bids[i].quantity);
+    }
+    EXPECT_EQ(depth.bids[0].order_count, 2);
+    EXPECT_TRUE(depth.asks.empty());
+}
+
+TEST_F(MatchingEngineTest, LatencyIsRecordedAtEveryEngineStage)
+{
+    LatencyRecorder recorder;
+    MatchingEngineConfig config;
+    config.latency = &recorder;
+    const uint64_t orders = 50;
+    {
+        MatchingEngine engine(config);
+        for (uint64_t i = 0; i < orders; ++i)
+        {
+            Order order(Strategy::OTHER, 10, 50.0 + (i % 2), i % 2 ? OrderSide::SELL : OrderSide::BUY, OrderType::LIMIT);
+            engine.process_order(order);
+        }
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (engine.get_stats().commands_processed < orders && std::chrono::steady_clock::now() < deadline)
+        {
+            wait_for_processing(1);
+        }
+    }
+
+    LatencyHistogram enqueued, dequeued, matched, acked;
+    recorder.merge_stage(LatencyStage::ENQUEUED, enqueued);
+    recorder.merge_stage(LatencyStage::DEQUEUED, dequeued);
+    recorder.merge_stage(LatencyStage::MATCHED, matched);
+    recorder.merge_stage(LatencyStage::ACKED, acked);
+    EXPECT_EQ(enqueued.count(), orders);
+    EXPECT_EQ(dequeued.count(), orders);
+    EXPECT_EQ(matched.count(), orders);
+    EXPECT_EQ(acked.count(), 0); // acks are sent by the transport, not the engine
+    EXPECT_GE(matched.max(), dequeued.percentile(0.5));
+}
+
+TEST_F(MatchingEngineTest, ProcessOrderSyncReturnsTheOutcome)
+{
+    MatchingEngine engine;
+    OrderOutcome outcome;
+
+    Order ask(Strategy::OTHER, 100, 51.0, OrderSide::SELL, OrderType::LIMIT);
+    ASSERT_TRUE(engine.process_order_sync(ask, outcome));
+    EXPECT_EQ(outcome.order_id, ask.get_id());
+    EXPECT_EQ(outcome.status, OrderStatus::PENDING);
+    EXPECT_EQ(outcome.filled_quantity, 0);
+    EXPECT_EQ(outcome.resting_quantity, 100);
+
+    Order higher_ask(Strategy::OTHER, 100, 52.0, OrderSide::SELL, OrderType::LIMIT);
+    ASSERT_TRUE(engine.process_order_sync(higher_ask, outcome));
+
+    Order buy(Strategy::OTHER, 150, 52.0, OrderSide::BUY, OrderType::LIMIT);
+    ASSERT_TRUE(engine.process_order_sync(buy, outcome));
+    EXPECT_EQ(outcome.status, OrderStatus::FILLED);
+    EXPECT_EQ(outcome.filled_quantity, 150);
+    EXPECT_NEAR(outcome.average_price, (100 * 51.0 + 50 * 52.0) / 150, 1e-9);
+    EXPECT_EQ(outcome.resting_quantity, 0);
+
+    // Only 50 left at 52.0; a market order's remainder cannot rest
+    Order market(Strategy::OTHER, 80, 0.0, OrderSide::BUY, OrderType::MARKET);
+    ASSERT_TRUE(engine.process_order_sync(market, outcome));
+    EXPECT_EQ(outcome.status, OrderStatus::CANCELLED);
+    EXPECT_EQ(outcome.filled_quantity, 50);
+
+    // Same id again is refused by the book
+    Order duplicate(Strategy::OTHER, 10, 40.0, OrderSide::BUY, OrderType::LIMIT);
+    ASSERT_TRUE(engine.process_order_sync(duplicate, outcome));
+    ASSERT_TRUE(engine.process_order_sync(duplicate, outcome));
+    EXPECT_EQ(outcome.status, OrderStatus::REJECTED);
+}
+
+TEST(WaitStrategyTest, ParseNames)
+{
+    WaitStrategyType type;
+    EXPECT_TRUE(parse_wait_strategy("spin", type));
+    EXPECT_EQ(type, WaitStrategyType::BUSY_SPIN);
+    EXPECT_TRUE(parse_wait_strategy("yield", type));
+    EXPECT_EQ(type, WaitStrategyType::SPIN_YIELD);
+    EXPECT_TRUE(parse_wait_strategy("block", type));
+    EXPECT_EQ(type, WaitStrategyType::BLOCKING);
+    EXPECT_FALSE(parse_wait_strategy("sleep", type));
+    EXPECT_STREQ(wait_strategy_name(WaitStrategyType::SPIN_YIELD), "yield");
+}
+
+TEST(WaitStrategyTest, NotifyWakesParkedConsumer)
+{
+    WaitStrategy strategy(WaitStrategyType::BLOCKING, 0);
+    std::atomic<bool> published(false);
+    std::atomic<bool> consumed(false);
+
+    std::thread consumer([&]
+                         {
+        uint32_t idle_rounds = 0;
+        while (!published.load())
+        {
+            strategy.idle(idle_rounds++, [&] { return published.load(); });
+        }
+        consumed.store(true); });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(consumed.load());
+
+    published.store(true);
+    strategy.notify();
+    consumer.join();
+    EXPECT_TRUE(consumed.load());
+}
+
 // Test Concurrent Order Processing
 TEST_F(MatchingEngineTest, ConcurrentOrderProcessing)
 {
@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+#include "MpscRing.h"
+#include "OrderCommand.h"
+#include <memory>
+#include <thread>
+#include <vector>
+
+TEST(MpscRingTest, CapacityRoundsUpToPowerOfTwo)
+{
+    MpscRing<int> ring(1000);
+    EXPECT_EQ(ring.capacity(), 1024);
+}
+
+TEST(MpscRingTest, PopsInFifoOrderAcrossWraparound)
+{
+    MpscRing<int> ring(4, true);
+    int next_expected = 0;
+
+    for (int lap = 0; lap < 10; ++lap)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            ring.push(lap * 3 + i);
+        }
+        int value;
+        while (ring.try_pop(value))
+        {
+            EXPECT_EQ(value, next_expected++);
+        }
+    }
+    EXPECT_EQ(next_expected, 30);
+    EXPECT_FALSE(ring.has_next());
+}
+
+TEST(MpscRingTest, TryPushFailsWhenFull)
+{
+    MpscRing<int> ring(2);
+    EXPECT_TRUE(ring.try_push(1));
+    EXPECT_TRUE(ring.try_push(2));
+    EXPECT_FALSE(ring.try_push(3));
+
+    int value;
+    ASSERT_TRUE(ring.try_pop(value));
+    EXPECT_EQ(value, 1);
+    EXPECT_TRUE(ring.try_push(3));
+}
+
+TEST(MpscRingTest, SizeCountsUnconsumedItems)
+{
+    MpscRing<int> ring(4);
+    EXPECT_EQ(ring.size_approx(), 0);
+    ring.push(1);
+    ring.push(2);
+    ring.push(3);
+    EXPECT_EQ(ring.size_approx(), 3);
+
+    int value;
+    ASSERT_TRUE(ring.try_pop(value));
+    EXPECT_EQ(ring.size_approx(), 2);
+}
+
+TEST(MpscRingTest, ConsumeBatchStopsAtLimit)
+{
+    MpscRing<int> ring(16);
+    for (int i = 0; i < 10; ++i)
+    {
+        ring.push(i);
+    }
+
+    std::vector<int> seen;
+    auto collect = [&seen](int &value)
+    { seen.push_back(value); };
+
+    EXPECT_EQ(ring.consume_batch(collect, 4), 4);
+    EXPECT_EQ(ring.consume_batch(collect, 100), 6);
+    EXPECT_EQ(ring.consume_batch(collect, 100), 0);
+    ASSERT_EQ(seen.size(), 10);
+    for (int i = 0; i < 10; ++i)
+    {
+        EXPECT_EQ(seen[i], i);
+    }
+}
+
+TEST(MpscRingTest, StoresOrderCommandsByValue)
+{
+    MpscRing<OrderCommand> ring(8);
+    Order order(Strategy::HIGH_FREQUENCY, 100, 50.0, OrderSide::BUY, OrderType::LIMIT);
+
+    ring.push(OrderCommand{CommandType::NEW_ORDER, 0, order.get_id(), order, nullptr, 0, nullptr, 0, false});
+    order.set_quantity(1); // the slot holds its own copy
+
+    bool consumed = ring.consume_one([&](OrderCommand &command)
+                                     {
+        EXPECT_EQ(command.type, CommandType::NEW_ORDER);
+        EXPECT_EQ(command.order.get_id(), order.get_id());
+        EXPECT_EQ(command.order.get_quantity(), 100); });
+    EXPECT_TRUE(consumed);
+}
+
+TEST(MpscRingTest, DestroysUnconsumedItems)
+{
+    auto tracker = std::make_shared<int>(0);
+    {
+        MpscRing<std::shared_ptr<int>> ring(8);
+        ring.push(tracker);
+        ring.push(tracker);
+        EXPECT_EQ(tracker.use_count(), 3);
+    }
+    EXPECT_EQ(tracker.use_count(), 1);
+}
+
+TEST(MpscRingTest, MultipleProducersThroughSmallRing)
+{
+    // A small ring forces producers to wait on full slots
+    const int num_producers = 4;
+    const int per_producer = 20000;
+    MpscRing<uint64_t> ring(64);
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < num_producers; ++p)
+    {
+        producers.emplace_back([&ring, p]
+                               {
+            for (int i = 0; i < per_producer; ++i)
+            {
+                ring.push(static_cast<uint64_t>(p) << 32 | static_cast<uint64_t>(i));
+            } });
+    }
+
+    // Each producer's items must arrive complete and in its own order
+    std::vector<int64_t> last_seen(num_producers, -1);
+    int received = 0;
+    while (received < num_producers * per_producer)
+    {
+        uint64_t value;
+        if (ring.try_pop(value))
+        {
+            int producer = static_cast<int>(value >> 32);
+            int64_t sequence = static_cast<int64_t>(value & 0xffffffff);
+            EXPECT_EQ(sequence, last_seen[producer] + 1);
+            last_seen[producer] = sequence;
+            ++received;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    for (auto &producer : producers)
+    {
+        producer.join();
+    }
+    EXPECT_FALSE(ring.has_next());
+}
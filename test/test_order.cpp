@@ -236,4 +236,16 @@ TEST_F(OrderTest, AllOrderStatusesWork)
 
     order.set_status(OrderStatus::REJECTED);
     EXPECT_EQ(order.get_status(), OrderStatus::REJECTED);
-}
\ No newline at end of file
+}
+TEST_F(OrderTest, SymbolIdDefaultsToZeroAndIsCopied)
+{
+    Order defaultSymbol(Strategy::OTHER, 100, 10.0, OrderSide::BUY, OrderType::LIMIT);
+    EXPECT_EQ(defaultSymbol.get_symbol_id(), 0);
+
+    Order order(Strategy::OTHER, 100, 10.0, OrderSide::BUY, OrderType::LIMIT, 42);
+    Order copy(order);
+    EXPECT_EQ(copy.get_symbol_id(), 42);
+
+    order.set_symbol_id(7);
+    EXPECT_EQ(order.get_symbol_id(), 7);
+}
@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include "OrderCompletion.h"
+#include <chrono>
+#include <thread>
+
+TEST(OrderCompletionTest, CompletionWakesSleepingWaiter)
+{
+    OrderCompletion completion;
+    uint32_t ticket = completion.arm();
+
+    std::thread matcher([&]
+                        {
+        // Late enough that the waiter is past spinning and asleep on the futex
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        OrderOutcome outcome;
+        outcome.order_id = 42;
+        outcome.filled_quantity = 10;
+        outcome.status = OrderStatus::FILLED;
+        completion.complete(ticket, outcome); });
+
+    OrderOutcome outcome;
+    ASSERT_TRUE(completion.wait(ticket, outcome, std::chrono::seconds(5)));
+    EXPECT_EQ(outcome.order_id, 42);
+    EXPECT_EQ(outcome.filled_quantity, 10);
+    EXPECT_EQ(outcome.status, OrderStatus::FILLED);
+    matcher.join();
+}
+
+TEST(OrderCompletionTest, LateCompletionOfAbandonedTicketIsDropped)
+{
+    OrderCompletion completion;
+    uint32_t stale = completion.arm();
+    OrderOutcome outcome;
+    EXPECT_FALSE(completion.wait(stale, outcome, std::chrono::milliseconds(5)));
+
+    uint32_t ticket = completion.arm();
+    OrderOutcome late;
+    late.order_id = 1;
+    completion.complete(stale, late);
+
+    OrderOutcome current;
+    current.order_id = 2;
+    completion.complete(ticket, current);
+    ASSERT_TRUE(completion.wait(ticket, outcome, std::chrono::seconds(1)));
+    EXPECT_EQ(outcome.order_id, 2);
+}
+
+TEST(OrderCompletionTest, ListenerIsToldOnceTheOutcomeIsPublished)
+{
+    struct Listener : CompletionListener
+    {
+        uint32_t ticket = 0;
+        OrderOutcome outcome;
+        bool told = false;
+
+        void completed(OrderCompletion &completion) override
+        {
+            told = completion.take(ticket, outcome);
+        }
+    } listener;
+
+    OrderCompletion completion(&listener);
+    listener.ticket = completion.arm();
+    OrderOutcome outcome;
+    EXPECT_FALSE(completion.take(listener.ticket, outcome));
+
+    OrderOutcome published;
+    published.order_id = 7;
+    published.status = OrderStatus::CANCELLED;
+    completion.complete(listener.ticket, published);
+    ASSERT_TRUE(listener.told);
+    EXPECT_EQ(listener.outcome.order_id, 7);
+    EXPECT_EQ(listener.outcome.status, OrderStatus::CANCELLED);
+}
+
+TEST(OrderCompletionTest, EachThreadHasItsOwnSlot)
+{
+    OrderCompletion *main_slot = &OrderCompletion::for_this_thread();
+    OrderCompletion *other_slot = nullptr;
+    std::thread other([&]
+                      { other_slot = &OrderCompletion::for_this_thread(); });
+    other.join();
+    EXPECT_EQ(&OrderCompletion::for_this_thread(), main_slot);
+    EXPECT_NE(other_slot, main_slot);
+}
+
+TEST(OrderCompletionTest, ExitedThreadsHandTheirSlotOn)
+{
+    OrderCompletion *first_slot = nullptr;
+    uint32_t pending = 0;
+    std::thread first([&]
+                      {
+        first_slot = &OrderCompletion::for_this_thread();
+        pending = first_slot->arm(); // exits without waiting for it
+    });
+    first.join();
+
+    OrderCompletion *second_slot = nullptr;
+    uint32_t ticket = 0;
+    OrderOutcome outcome;
+    bool completed = false;
+    std::thread second([&]
+                       {
+        second_slot = &OrderCompletion::for_this_thread();
+        ticket = second_slot->arm();
+
+        // The first thread's ticket was abandoned as it exited, so it cannot
+        // land in the reused slot
+        OrderOutcome late;
+        late.order_id = 1;
+        second_slot->complete(pending, late);
+        OrderOutcome current;
+        current.order_id = 2;
+        second_slot->complete(ticket, current);
+        completed = second_slot->wait(ticket, outcome, std::chrono::seconds(1)); });
+    second.join();
+
+    EXPECT_EQ(second_slot, first_slot);
+    EXPECT_GT(ticket, pending);
+    ASSERT_TRUE(completed);
+    EXPECT_EQ(outcome.order_id, 2);
+}
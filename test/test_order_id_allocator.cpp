@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include "Order.h"
+#include "OrderIdAllocator.h"
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+TEST(OrderIdAllocatorTest, IdsAreUniqueAndIncreasingPerThread)
+{
+    const int threads = 8;
+    const int per_thread = 5000;
+    std::vector<std::vector<uint64_t>> ids(threads);
+    std::vector<std::thread> producers;
+    for (int t = 0; t < threads; ++t)
+    {
+        producers.emplace_back([&ids, t]
+                               {
+            for (int i = 0; i < per_thread; ++i)
+            {
+                Order order(Strategy::OTHER, 1, 10.0, OrderSide::BUY, OrderType::LIMIT);
+                ids[t].push_back(order.get_id());
+            } });
+    }
+    for (std::thread &producer : producers)
+    {
+        producer.join();
+    }
+
+    std::vector<uint64_t> all;
+    for (const std::vector<uint64_t> &thread_ids : ids)
+    {
+        EXPECT_TRUE(std::is_sorted(thread_ids.begin(), thread_ids.end()));
+        all.insert(all.end(), thread_ids.begin(), thread_ids.end());
+    }
+    std::sort(all.begin(), all.end());
+    EXPECT_EQ(std::adjacent_find(all.begin(), all.end()), all.end());
+    EXPECT_EQ(std::count(all.begin(), all.end(), 0u), 0);
+}
+
+TEST(OrderIdAllocatorTest, IdsAreDenseWithinAThread)
+{
+    uint64_t first = OrderIdAllocator::next();
+    uint64_t second = OrderIdAllocator::next();
+    // Consecutive unless the first id ended this thread's block
+    if (first % OrderIdAllocator::kBlockSize != 0)
+    {
+        EXPECT_EQ(second, first + 1);
+    }
+    EXPECT_GT(second, first);
+}
+
+TEST(OrderIdAllocatorTest, ReservedIdsAreSkippedByEveryThread)
+{
+    uint64_t before = OrderIdAllocator::next();
+    const uint64_t recovered = before + 10 * OrderIdAllocator::kBlockSize;
+    OrderIdAllocator::reserve_through(recovered);
+
+    // This thread's block predates the reservation and is dropped
+    EXPECT_GT(OrderIdAllocator::next(), recovered);
+    uint64_t other = 0;
+    std::thread producer([&other]
+                         { other = OrderIdAllocator::next(); });
+    producer.join();
+    EXPECT_GT(other, recovered);
+
+    // Reserving below what was already handed out changes nothing
+    OrderIdAllocator::reserve_through(1);
+    EXPECT_GT(OrderIdAllocator::next(), recovered);
+}
+
+TEST(OrderIdAllocatorTest, PlaceholderOrdersTakeNoId)
+{
+    Order placeholder;
+    EXPECT_EQ(placeholder.get_id(), 0);
+}
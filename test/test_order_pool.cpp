@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+#include "OrderPool.h"
+#include "OrderIndex.h"
+#include <chrono>
+#include <set>
+#include <vector>
+
+class OrderPoolTest : public ::testing::Test
+{
+protected:
+    Order sample_order{Strategy::HIGH_FREQUENCY, 100, 50.0, OrderSide::BUY, OrderType::LIMIT};
+};
+
+TEST_F(OrderPoolTest, AcquireCopiesOrderIntoNode)
+{
+    OrderPool pool(16);
+
+    OrderNode *node = pool.acquire(sample_order, 5000);
+
+    EXPECT_EQ(node->order.id, sample_order.get_id());
+    EXPECT_EQ(node->order.quantity, 100);
+    EXPECT_EQ(node->order.tick, 5000);
+    EXPECT_EQ(node->order.side, OrderSide::BUY);
+    EXPECT_EQ(node->order.strategy, Strategy::HIGH_FREQUENCY);
+    EXPECT_EQ(node->order.timestamp_ns, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                            sample_order.get_created_at().time_since_epoch())
+                                            .count());
+    EXPECT_EQ(pool.details(node).symbol_id, sample_order.get_symbol_id());
+    EXPECT_EQ(node->prev, nullptr);
+    EXPECT_EQ(node->next, nullptr);
+    EXPECT_EQ(pool.in_use(), 1);
+
+    pool.release(node);
+    EXPECT_EQ(pool.in_use(), 0);
+}
+
+TEST_F(OrderPoolTest, NodesAreCacheLineAligned)
+{
+    OrderPool pool(16);
+
+    OrderNode *a = pool.acquire(sample_order, 5000);
+    OrderNode *b = pool.acquire(sample_order, 5000);
+
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(a) % 64, 0u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(b) % 64, 0u);
+
+    pool.release(a);
+    pool.release(b);
+}
+
+TEST_F(OrderPoolTest, ReleasedNodesAreReused)
+{
+    OrderPool pool(16);
+
+    OrderNode *first = pool.acquire(sample_order, 5000);
+    pool.release(first);
+    OrderNode *second = pool.acquire(sample_order, 5000);
+
+    EXPECT_EQ(first, second);
+    pool.release(second);
+}
+
+TEST_F(OrderPoolTest, GrowsWhenSlabIsExhausted)
+{
+    OrderPool pool(8, true);
+    std::vector<OrderNode *> nodes;
+
+    for (int i = 0; i < 20; ++i)
+    {
+        nodes.push_back(pool.acquire(sample_order, 5000));
+    }
+
+    EXPECT_GE(pool.capacity(), 20u);
+    EXPECT_EQ(std::set<OrderNode *>(nodes.begin(), nodes.end()).size(), nodes.size());
+
+    for (OrderNode *node : nodes)
+    {
+        pool.release(node);
+    }
+    EXPECT_EQ(pool.in_use(), 0);
+}
+
+TEST_F(OrderPoolTest, ChurnNeverHandsOutAHeldNode)
+{
+    // The matching thread's pattern: orders rest, some leave, new ones arrive
+    OrderPool pool(64);
+    std::set<OrderNode *> held;
+    std::vector<OrderNode *> order;
+    for (int i = 0; i < 20000; ++i)
+    {
+        OrderNode *node = pool.acquire(sample_order, 5000 + i);
+        EXPECT_TRUE(held.insert(node).second);
+        order.push_back(node);
+        if (order.size() == 8)
+        {
+            // Release every other node, oldest first
+            for (size_t j = 0; j < order.size(); j += 2)
+            {
+                held.erase(order[j]);
+                pool.release(order[j]);
+            }
+            order.clear();
+        }
+    }
+    EXPECT_EQ(pool.in_use(), held.size());
+    for (OrderNode *node : held)
+    {
+        pool.release(node);
+    }
+    EXPECT_EQ(pool.in_use(), 0);
+}
+
+// OrderIndex
+TEST(OrderIndexTest, InsertFindErase)
+{
+    OrderIndex index(16);
+    OrderNode nodes[3] = {};
+
+    EXPECT_TRUE(index.insert(1, &nodes[0]));
+    EXPECT_TRUE(index.insert(2, &nodes[1]));
+    EXPECT_FALSE(index.insert(1, &nodes[2]));
+
+    EXPECT_EQ(index.find(1), &nodes[0]);
+    EXPECT_EQ(index.find(2), &nodes[1]);
+    EXPECT_EQ(index.find(3), nullptr);
+
+    EXPECT_EQ(index.erase(1), &nodes[0]);
+    EXPECT_EQ(index.erase(1), nullptr);
+    EXPECT_EQ(index.find(2), &nodes[1]);
+    EXPECT_EQ(index.size(), 1u);
+}
+
+TEST(OrderIndexTest, SurvivesGrowthAndChurn)
+{
+    OrderIndex index(16);
+    std::vector<OrderNode> nodes(5000);
+
+    for (uint64_t id = 0; id < nodes.size(); ++id)
+    {
+        ASSERT_TRUE(index.insert(id * 7919, &nodes[id]));
+    }
+    // Erase every other entry so probe runs get shifted back
+    for (uint64_t id = 0; id < nodes.size(); id += 2)
+    {
+        ASSERT_EQ(index.erase(id * 7919), &nodes[id]);
+    }
+    for (uint64_t id = 0; id < nodes.size(); ++id)
+    {
+        EXPECT_EQ(index.find(id * 7919), id % 2 ? &nodes[id] : nullptr);
+    }
+    EXPECT_EQ(index.size(), nodes.size() / 2);
+}
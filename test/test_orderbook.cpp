@@ -1,5 +1,9 @@
 #include <gtest/gtest.h>
 #include "OrderBook.h"
+#include <cmath>
+#include <limits>
+#include <tuple>
+#include <vector>
 
 class OrderBookTest : public ::testing::Test
 {
@@ -164,4 +168,514 @@ TEST_F(OrderBookTest, CancelOrderRemovesFromBook)
 
     OrderQueue bids_after_cancel = orderbook->get_bids(50.0);
     EXPECT_EQ(bids_after_cancel.size(), 0);
-}
\ No newline at end of file
+}
+// Test price ladder behaviour
+TEST_F(OrderBookTest, PricesSnapToTicks)
+{
+    OrderBook book(0.05);
+
+    Order buy(Strategy::OTHER, 100, 50.02, OrderSide::BUY, OrderType::LIMIT);
+    book.add_order(buy);
+
+    // 50.02 rounds to the nearest 0.05 tick
+    EXPECT_DOUBLE_EQ(book.get_best_bid(), 50.0);
+    EXPECT_EQ(book.get_bids(50.0).size(), 1);
+    EXPECT_EQ(book.price_to_tick(50.0), 1000);
+}
+
+TEST_F(OrderBookTest, InvalidTickSizeThrows)
+{
+    EXPECT_THROW(OrderBook(0.0), std::invalid_argument);
+    EXPECT_THROW(OrderBook(-0.01), std::invalid_argument);
+}
+
+TEST_F(OrderBookTest, LadderGrowsForDistantPrices)
+{
+    Order near_bid(Strategy::OTHER, 10, 50.0, OrderSide::BUY, OrderType::LIMIT);
+    Order far_low_bid(Strategy::OTHER, 10, 1.0, OrderSide::BUY, OrderType::LIMIT);
+    Order far_high_bid(Strategy::OTHER, 10, 500.0, OrderSide::BUY, OrderType::LIMIT);
+
+    orderbook->add_order(near_bid);
+    orderbook->add_order(far_low_bid);
+    orderbook->add_order(far_high_bid);
+
+    EXPECT_DOUBLE_EQ(orderbook->get_best_bid(), 500.0);
+    EXPECT_EQ(orderbook->get_bids(1.0).size(), 1);
+    EXPECT_EQ(orderbook->get_bids(50.0).size(), 1);
+}
+
+TEST_F(OrderBookTest, BestBidMovesWhenTopLevelEmpties)
+{
+    orderbook->add_order(*buy_order_1); // 50.0
+    orderbook->add_order(*buy_order_2); // 49.0
+
+    orderbook->remove_order(*buy_order_1);
+
+    EXPECT_DOUBLE_EQ(orderbook->get_best_bid(), 49.0);
+
+    orderbook->remove_order(*buy_order_2);
+    EXPECT_THROW(orderbook->get_best_bid(), std::exception);
+}
+
+TEST_F(OrderBookTest, MarketOrderSweepsMultipleLevels)
+{
+    orderbook->add_order(*sell_order_1); // Sell 150 @ 51.0
+    orderbook->add_order(*sell_order_2); // Sell 75 @ 52.0
+
+    Order market_buy(Strategy::OTHER, 200, 0.0, OrderSide::BUY, OrderType::MARKET);
+    orderbook->match_orders(market_buy);
+
+    EXPECT_EQ(market_buy.get_quantity(), 0);
+    EXPECT_EQ(orderbook->get_asks(51.0).size(), 0);
+    EXPECT_DOUBLE_EQ(orderbook->get_best_ask(), 52.0);
+    EXPECT_EQ(orderbook->get_asks(52.0).front().get_quantity(), 25);
+}
+
+TEST_F(OrderBookTest, LimitOrderStopsAtLimitPriceAndRests)
+{
+    orderbook->add_order(*sell_order_1); // Sell 150 @ 51.0
+    orderbook->add_order(*sell_order_2); // Sell 75 @ 52.0
+
+    Order limit_buy(Strategy::OTHER, 200, 51.0, OrderSide::BUY, OrderType::LIMIT);
+    orderbook->match_orders(limit_buy);
+
+    // 150 filled at 51.0, the remaining 50 rests as the new best bid
+    EXPECT_EQ(limit_buy.get_quantity(), 50);
+    EXPECT_DOUBLE_EQ(orderbook->get_best_bid(), 51.0);
+    EXPECT_DOUBLE_EQ(orderbook->get_best_ask(), 52.0);
+}
+
+// Test execution events
+TEST_F(OrderBookTest, FillsArePublishedToExecutionStream)
+{
+    ExecutionStream stream(16);
+    orderbook->set_execution_stream(&stream);
+
+    orderbook->add_order(*sell_order_1); // Sell 150 @ 51.0
+    orderbook->add_order(*sell_order_2); // Sell 75 @ 52.0
+
+    Order market_buy(Strategy::OTHER, 200, 0.0, OrderSide::BUY, OrderType::MARKET, 3);
+    orderbook->match_orders(market_buy);
+
+    uint64_t cursor = 0;
+    ExecutionEvent first;
+    ExecutionEvent second;
+    ExecutionEvent none;
+    ASSERT_EQ(stream.read(cursor, first), ExecutionStream::ReadStatus::OK);
+    ASSERT_EQ(stream.read(cursor, second), ExecutionStream::ReadStatus::OK);
+    EXPECT_EQ(stream.read(cursor, none), ExecutionStream::ReadStatus::EMPTY);
+
+    EXPECT_EQ(first.sequence, 1);
+    EXPECT_EQ(first.taker_order_id, market_buy.get_id());
+    EXPECT_EQ(first.maker_order_id, sell_order_1->get_id());
+    EXPECT_DOUBLE_EQ(first.price, 51.0);
+    EXPECT_EQ(first.quantity, 150);
+    EXPECT_EQ(first.symbol_id, 3);
+    EXPECT_EQ(first.taker_side, OrderSide::BUY);
+    EXPECT_GT(first.timestamp_ns, 0);
+
+    EXPECT_EQ(second.sequence, 2);
+    EXPECT_EQ(second.maker_order_id, sell_order_2->get_id());
+    EXPECT_DOUBLE_EQ(second.price, 52.0);
+    EXPECT_EQ(second.quantity, 50);
+}
+
+TEST_F(OrderBookTest, NoFillsAreLostWithoutAStream)
+{
+    orderbook->add_order(*sell_order_1);
+    Order market_buy(Strategy::OTHER, 100, 0.0, OrderSide::BUY, OrderType::MARKET);
+    EXPECT_NO_THROW(orderbook->match_orders(market_buy));
+    EXPECT_EQ(market_buy.get_quantity(), 0);
+}
+
+TEST_F(OrderBookTest, CancelIsPublishedToExecutionStream)
+{
+    ExecutionStream stream(16);
+    orderbook->set_execution_stream(&stream);
+
+    orderbook->add_order(*buy_order_1);
+    ASSERT_TRUE(orderbook->cancel_order(buy_order_1->get_id()));
+    EXPECT_FALSE(orderbook->cancel_order(buy_order_1->get_id()));
+
+    uint64_t cursor = 0;
+    ExecutionEvent event;
+    ExecutionEvent none;
+    ASSERT_EQ(stream.read(cursor, event), ExecutionStream::ReadStatus::OK);
+    EXPECT_EQ(stream.read(cursor, none), ExecutionStream::ReadStatus::EMPTY);
+
+    EXPECT_EQ(event.type, ExecutionType::CANCEL);
+    EXPECT_EQ(event.taker_order_id, buy_order_1->get_id());
+    EXPECT_EQ(event.quantity, buy_order_1->get_quantity());
+}
+
+TEST_F(OrderBookTest, UnfilledMarketRemainderExpires)
+{
+    ExecutionStream stream(16);
+    orderbook->set_execution_stream(&stream);
+
+    orderbook->add_order(*sell_order_2); // Sell 75 @ 52.0
+    Order market_buy(Strategy::OTHER, 100, 0.0, OrderSide::BUY, OrderType::MARKET);
+    orderbook->match_orders(market_buy);
+
+    uint64_t cursor = 0;
+    ExecutionEvent fill;
+    ExecutionEvent expire;
+    ASSERT_EQ(stream.read(cursor, fill), ExecutionStream::ReadStatus::OK);
+    ASSERT_EQ(stream.read(cursor, expire), ExecutionStream::ReadStatus::OK);
+
+    EXPECT_EQ(fill.type, ExecutionType::FILL);
+    EXPECT_EQ(expire.type, ExecutionType::EXPIRE);
+    EXPECT_EQ(expire.taker_order_id, market_buy.get_id());
+    EXPECT_EQ(expire.quantity, 25);
+}
+
+// Test L2 depth and level change tracking
+TEST_F(OrderBookTest, DepthIsReportedBestFirst)
+{
+    orderbook->add_order(*buy_order_1);  // Buy 100 @ 50.0
+    orderbook->add_order(*buy_order_2);  // Buy 200 @ 49.0
+    orderbook->add_order(*sell_order_1); // Sell 150 @ 51.0
+    orderbook->add_order(*sell_order_2); // Sell 75 @ 52.0
+    Order another_bid(Strategy::OTHER, 30, 50.0, OrderSide::BUY, OrderType::LIMIT);
+    orderbook->add_order(another_bid);
+
+    std::vector<LevelQuantity> bids;
+    std::vector<LevelQuantity> asks;
+    orderbook->get_depth(0, bids, asks);
+    ASSERT_EQ(bids.size(), 2);
+    ASSERT_EQ(asks.size(), 2);
+    EXPECT_DOUBLE_EQ(bids[0].price, 50.0);
+    EXPECT_EQ(bids[0].quantity, 130);
+    EXPECT_DOUBLE_EQ(bids[1].price, 49.0);
+    EXPECT_DOUBLE_EQ(asks[0].price, 51.0);
+    EXPECT_DOUBLE_EQ(asks[1].price, 52.0);
+
+    orderbook->get_depth(1, bids, asks);
+    EXPECT_EQ(bids.size(), 1);
+    EXPECT_EQ(asks.size(), 1);
+}
+
+TEST_F(OrderBookTest, LevelChangesAreCoalescedUntilDrained)
+{
+    orderbook->set_level_tracking(true);
+    orderbook->add_order(*sell_order_1); // Sell 150 @ 51.0
+    orderbook->add_order(*sell_order_2); // Sell 75 @ 52.0
+    Order market_buy(Strategy::OTHER, 160, 0.0, OrderSide::BUY, OrderType::MARKET);
+    orderbook->match_orders(market_buy);
+
+    std::vector<std::tuple<OrderSide, double, int64_t>> changes;
+    auto collect = [&](OrderSide side, double price, int64_t quantity)
+    { changes.emplace_back(side, price, quantity); };
+
+    orderbook->drain_level_changes(collect);
+    ASSERT_EQ(changes.size(), 2); // each level once, with its final quantity
+    EXPECT_EQ(changes[0], std::make_tuple(OrderSide::SELL, 51.0, int64_t(0)));
+    EXPECT_EQ(changes[1], std::make_tuple(OrderSide::SELL, 52.0, int64_t(65)));
+
+    changes.clear();
+    orderbook->drain_level_changes(collect);
+    EXPECT_TRUE(changes.empty());
+}
+
+// Test order id index
+TEST_F(OrderBookTest, FindOrderById)
+{
+    orderbook->add_order(*buy_order_1);
+
+    const RestingOrder *found = orderbook->find_order(buy_order_1->get_id());
+    ASSERT_NE(found, nullptr);
+    EXPECT_EQ(found->quantity, 100);
+    EXPECT_EQ(orderbook->find_order(sell_order_1->get_id()), nullptr);
+}
+
+TEST_F(OrderBookTest, LevelCopiesRestoreColdFields)
+{
+    Order order(Strategy::PENSION_FUND, 40, 50.0, OrderSide::BUY, OrderType::LIMIT, 7);
+    orderbook->add_order(order);
+
+    OrderQueue level = orderbook->get_bids(50.0);
+    ASSERT_EQ(level.size(), 1);
+    EXPECT_EQ(level[0].get_id(), order.get_id());
+    EXPECT_EQ(level[0].get_strategy(), Strategy::PENSION_FUND);
+    EXPECT_EQ(level[0].get_symbol_id(), 7);
+    EXPECT_EQ(level[0].get_created_at(), order.get_created_at());
+    EXPECT_DOUBLE_EQ(level[0].get_price(), 50.0);
+}
+
+TEST_F(OrderBookTest, CancelByIdFromMiddleOfLevelKeepsFifo)
+{
+    Order first(Strategy::OTHER, 10, 50.0, OrderSide::BUY, OrderType::LIMIT);
+    Order middle(Strategy::OTHER, 20, 50.0, OrderSide::BUY, OrderType::LIMIT);
+    Order last(Strategy::OTHER, 30, 50.0, OrderSide::BUY, OrderType::LIMIT);
+
+    orderbook->add_order(first);
+    orderbook->add_order(middle);
+    orderbook->add_order(last);
+
+    EXPECT_TRUE(orderbook->cancel_order(middle.get_id()));
+    EXPECT_FALSE(orderbook->cancel_order(middle.get_id())); // already gone
+
+    OrderQueue level = orderbook->get_bids(50.0);
+    ASSERT_EQ(level.size(), 2);
+    EXPECT_EQ(level[0].get_id(), first.get_id());
+    EXPECT_EQ(level[1].get_id(), last.get_id());
+    EXPECT_EQ(orderbook->order_count(), 2);
+}
+
+TEST_F(OrderBookTest, DuplicateOrderIdIsRejected)
+{
+    EXPECT_TRUE(orderbook->add_order(*buy_order_1));
+    EXPECT_FALSE(orderbook->add_order(*buy_order_1));
+    EXPECT_EQ(orderbook->get_bids(50.0).size(), 1);
+}
+
+TEST_F(OrderBookTest, DuplicateIdIsRejectedBeforeMatching)
+{
+    orderbook->add_order(*sell_order_1); // Sell 150 @ 51.0
+    orderbook->add_order(*buy_order_1);
+
+    // Would cross the ask, but its id is already resting: nothing may trade
+    Order duplicate(buy_order_1->get_id(), Strategy::OTHER, 40, 51.0, OrderSide::BUY, OrderType::LIMIT, 0,
+                    std::chrono::system_clock::now());
+    MatchResult result = orderbook->match_orders(duplicate);
+    EXPECT_TRUE(result.rejected);
+    EXPECT_EQ(result.filled_quantity, 0);
+    EXPECT_EQ(orderbook->get_asks(51.0)[0].get_quantity(), 150);
+    EXPECT_EQ(orderbook->order_count(), 2);
+}
+
+TEST_F(OrderBookTest, FilledOrdersLeaveTheIndex)
+{
+    orderbook->add_order(*sell_order_2); // Sell 75 @ 52.0
+
+    Order market_buy(Strategy::OTHER, 75, 0.0, OrderSide::BUY, OrderType::MARKET);
+    orderbook->match_orders(market_buy);
+
+    EXPECT_EQ(orderbook->find_order(sell_order_2->get_id()), nullptr);
+    EXPECT_EQ(orderbook->order_count(), 0);
+    EXPECT_FALSE(orderbook->cancel_order(sell_order_2->get_id()));
+}
+
+TEST_F(OrderBookTest, MatchResultReportsFillsAndRemainder)
+{
+    orderbook->add_order(*sell_order_1); // Sell 150 @ 51.0
+    orderbook->add_order(*sell_order_2); // Sell 75 @ 52.0
+
+    Order sweep(Strategy::OTHER, 250, 52.0, OrderSide::BUY, OrderType::LIMIT);
+    MatchResult result = orderbook->match_orders(sweep);
+    EXPECT_EQ(result.filled_quantity, 225);
+    EXPECT_DOUBLE_EQ(orderbook->tick_to_price(result.filled_notional_ticks), 150 * 51.0 + 75 * 52.0);
+    EXPECT_EQ(result.resting_quantity, 25);
+    EXPECT_EQ(result.expired_quantity, 0);
+    EXPECT_FALSE(result.rejected);
+
+    Order market_sell(Strategy::OTHER, 40, 0.0, OrderSide::SELL, OrderType::MARKET);
+    result = orderbook->match_orders(market_sell);
+    EXPECT_EQ(result.filled_quantity, 25);
+    EXPECT_EQ(result.resting_quantity, 0);
+    EXPECT_EQ(result.expired_quantity, 15);
+}
+
+// Test IOC, FOK and post-only orders
+TEST_F(OrderBookTest, IocRemainderExpiresInsteadOfResting)
+{
+    orderbook->add_order(*sell_order_1); // Sell 150 @ 51.0
+    orderbook->add_order(*sell_order_2); // Sell 75 @ 52.0
+
+    Order ioc(Strategy::OTHER, 200, 51.0, OrderSide::BUY, OrderType::IOC);
+    MatchResult result = orderbook->match_orders(ioc);
+    EXPECT_EQ(result.filled_quantity, 150);
+    EXPECT_EQ(result.resting_quantity, 0);
+    EXPECT_EQ(result.expired_quantity, 50);
+    EXPECT_EQ(orderbook->find_order(ioc.get_id()), nullptr);
+    EXPECT_EQ(orderbook->level_count(OrderSide::BUY), 0u);
+    EXPECT_DOUBLE_EQ(orderbook->get_best_ask(), 52.0);
+}
+
+TEST_F(OrderBookTest, FokThatCannotFillLeavesTheBookUntouched)
+{
+    ExecutionStream stream(16);
+    orderbook->set_execution_stream(&stream);
+    orderbook->add_order(*sell_order_1); // Sell 150 @ 51.0
+    orderbook->add_order(*sell_order_2); // Sell 75 @ 52.0
+
+    // 225 rest through 52.0, but only 150 within the limit
+    Order fok(Strategy::OTHER, 200, 51.0, OrderSide::BUY, OrderType::FOK);
+    MatchResult result = orderbook->match_orders(fok);
+    EXPECT_EQ(result.filled_quantity, 0);
+    EXPECT_EQ(result.expired_quantity, 200);
+    EXPECT_EQ(orderbook->find_order(sell_order_1->get_id())->quantity, 150);
+    EXPECT_EQ(orderbook->find_order(sell_order_2->get_id())->quantity, 75);
+
+    uint64_t cursor = 0;
+    ExecutionEvent expire;
+    ExecutionEvent none;
+    ASSERT_EQ(stream.read(cursor, expire), ExecutionStream::ReadStatus::OK);
+    EXPECT_EQ(stream.read(cursor, none), ExecutionStream::ReadStatus::EMPTY);
+    EXPECT_EQ(expire.type, ExecutionType::EXPIRE);
+    EXPECT_EQ(expire.quantity, 200);
+
+    Order fills(Strategy::OTHER, 200, 52.0, OrderSide::BUY, OrderType::FOK);
+    result = orderbook->match_orders(fills);
+    EXPECT_EQ(result.filled_quantity, 200);
+    EXPECT_EQ(result.expired_quantity, 0);
+    EXPECT_EQ(orderbook->find_order(sell_order_2->get_id())->quantity, 25);
+}
+
+TEST_F(OrderBookTest, FokSellCountsBidsAtOrAboveTheLimit)
+{
+    orderbook->add_order(*buy_order_1); // Buy 100 @ 50.0
+    orderbook->add_order(*buy_order_2); // Buy 200 @ 49.0
+
+    Order short_fok(Strategy::OTHER, 101, 50.0, OrderSide::SELL, OrderType::FOK);
+    EXPECT_EQ(orderbook->match_orders(short_fok).filled_quantity, 0);
+
+    Order fok(Strategy::OTHER, 300, 49.0, OrderSide::SELL, OrderType::FOK);
+    EXPECT_EQ(orderbook->match_orders(fok).filled_quantity, 300);
+    EXPECT_EQ(orderbook->order_count(), 0u);
+}
+
+TEST_F(OrderBookTest, PostOnlyRestsOrIsRejected)
+{
+    ExecutionStream stream(16);
+    orderbook->set_execution_stream(&stream);
+    orderbook->add_order(*sell_order_1); // Sell 150 @ 51.0
+
+    Order crossing(Strategy::OTHER, 10, 51.0, OrderSide::BUY, OrderType::POST_ONLY);
+    MatchResult result = orderbook->match_orders(crossing);
+    EXPECT_TRUE(result.rejected);
+    EXPECT_EQ(result.filled_quantity, 0);
+    EXPECT_EQ(orderbook->find_order(crossing.get_id()), nullptr);
+    EXPECT_EQ(orderbook->find_order(sell_order_1->get_id())->quantity, 150);
+
+    uint64_t cursor = 0;
+    ExecutionEvent reject;
+    ASSERT_EQ(stream.read(cursor, reject), ExecutionStream::ReadStatus::OK);
+    EXPECT_EQ(reject.type, ExecutionType::REJECT);
+    EXPECT_EQ(reject.taker_order_id, crossing.get_id());
+
+    Order passive(Strategy::OTHER, 10, 50.99, OrderSide::BUY, OrderType::POST_ONLY);
+    result = orderbook->match_orders(passive);
+    EXPECT_FALSE(result.rejected);
+    EXPECT_EQ(result.resting_quantity, 10);
+    EXPECT_DOUBLE_EQ(orderbook->get_best_bid(), 50.99);
+}
+
+// Test amend
+TEST_F(OrderBookTest, AmendDownKeepsTimePriority)
+{
+    Order first(Strategy::OTHER, 100, 50.0, OrderSide::BUY, OrderType::LIMIT);
+    Order second(Strategy::OTHER, 100, 50.0, OrderSide::BUY, OrderType::LIMIT);
+    orderbook->add_order(first);
+    orderbook->add_order(second);
+
+    ASSERT_TRUE(orderbook->amend_order(first.get_id(), 50.0, 40));
+    OrderQueue level = orderbook->get_bids(50.0);
+    ASSERT_EQ(level.size(), 2u);
+    EXPECT_EQ(level[0].get_id(), first.get_id());
+    EXPECT_EQ(level[0].get_quantity(), 40);
+
+    std::vector<LevelQuantity> bids;
+    std::vector<LevelQuantity> asks;
+    orderbook->get_depth(0, bids, asks);
+    ASSERT_EQ(bids.size(), 1u);
+    EXPECT_EQ(bids[0].quantity, 140);
+}
+
+TEST_F(OrderBookTest, AmendUpOrRepriceMovesToTheBack)
+{
+    Order first(Strategy::OTHER, 100, 50.0, OrderSide::BUY, OrderType::LIMIT);
+    Order second(Strategy::OTHER, 100, 50.0, OrderSide::BUY, OrderType::LIMIT);
+    Order other_level(Strategy::OTHER, 10, 49.0, OrderSide::BUY, OrderType::LIMIT);
+    orderbook->add_order(first);
+    orderbook->add_order(second);
+    orderbook->add_order(other_level);
+
+    ASSERT_TRUE(orderbook->amend_order(first.get_id(), 50.0, 150));
+    OrderQueue level = orderbook->get_bids(50.0);
+    ASSERT_EQ(level.size(), 2u);
+    EXPECT_EQ(level[0].get_id(), second.get_id());
+    EXPECT_EQ(level[1].get_id(), first.get_id());
+
+    ASSERT_TRUE(orderbook->amend_order(second.get_id(), 49.0, 100));
+    EXPECT_EQ(orderbook->get_bids(50.0).size(), 1u);
+    level = orderbook->get_bids(49.0);
+    ASSERT_EQ(level.size(), 2u);
+    EXPECT_EQ(level[0].get_id(), other_level.get_id());
+    EXPECT_EQ(level[1].get_id(), second.get_id());
+    EXPECT_EQ(orderbook->find_order(second.get_id())->tick, orderbook->price_to_tick(49.0));
+}
+
+TEST_F(OrderBookTest, AmendThroughTheTouchTradesFirst)
+{
+    orderbook->add_order(*sell_order_1); // Sell 150 @ 51.0
+    orderbook->add_order(*buy_order_1);  // Buy 100 @ 50.0
+
+    ASSERT_TRUE(orderbook->amend_order(buy_order_1->get_id(), 51.0, 200));
+    EXPECT_EQ(orderbook->find_order(sell_order_1->get_id()), nullptr);
+    const RestingOrder *remainder = orderbook->find_order(buy_order_1->get_id());
+    ASSERT_NE(remainder, nullptr);
+    EXPECT_EQ(remainder->quantity, 50);
+    EXPECT_DOUBLE_EQ(orderbook->get_best_bid(), 51.0);
+}
+
+TEST_F(OrderBookTest, AmendIsRefusedForUnknownOrCrossingPostOnly)
+{
+    orderbook->add_order(*sell_order_1); // Sell 150 @ 51.0
+    EXPECT_FALSE(orderbook->amend_order(12345, 50.0, 10));
+    EXPECT_FALSE(orderbook->amend_order(sell_order_1->get_id(), 51.0, 0));
+
+    Order maker(Strategy::OTHER, 10, 50.0, OrderSide::BUY, OrderType::POST_ONLY);
+    orderbook->match_orders(maker);
+    EXPECT_FALSE(orderbook->amend_order(maker.get_id(), 51.0, 10));
+    EXPECT_EQ(orderbook->find_order(maker.get_id())->tick, orderbook->price_to_tick(50.0));
+    EXPECT_EQ(orderbook->find_order(sell_order_1->get_id())->quantity, 150);
+}
+
+// Test price validation and the price band
+TEST_F(OrderBookTest, InvalidLimitPricesAreRejectedBeforeMatching)
+{
+    orderbook->add_order(*buy_order_1); // Buy 100 @ 50.0
+    for (double price : {0.0, -5.0, std::nan(""), std::numeric_limits<double>::infinity(), 1e300})
+    {
+        Order sell(Strategy::OTHER, 10, price, OrderSide::SELL, OrderType::LIMIT);
+        MatchResult result = orderbook->match_orders(sell);
+        EXPECT_TRUE(result.rejected) << price;
+        EXPECT_EQ(result.filled_quantity, 0) << price;
+        EXPECT_FALSE(orderbook->add_order(sell)) << price;
+    }
+    EXPECT_EQ(orderbook->find_order(buy_order_1->get_id())->quantity, 100);
+    EXPECT_EQ(orderbook->order_count(), 1u);
+
+    Order market_sell(Strategy::OTHER, 10, std::nan(""), OrderSide::SELL, OrderType::MARKET);
+    EXPECT_EQ(orderbook->match_orders(market_sell).filled_quantity, 10);
+}
+
+TEST_F(OrderBookTest, OrdersOutsideThePriceBandAreRejected)
+{
+    OrderBook book(0.01, 1024);
+    Order ask(Strategy::OTHER, 10, 100.0, OrderSide::SELL, OrderType::LIMIT);
+    Order bid(Strategy::OTHER, 10, 99.0, OrderSide::BUY, OrderType::LIMIT);
+    ASSERT_TRUE(book.add_order(ask));
+    ASSERT_TRUE(book.add_order(bid));
+
+    // Would widen the ask side far past 1024 ticks
+    Order far_ask(Strategy::OTHER, 10, 1e9, OrderSide::SELL, OrderType::LIMIT);
+    EXPECT_TRUE(book.match_orders(far_ask).rejected);
+    EXPECT_EQ(book.find_order(far_ask.get_id()), nullptr);
+
+    // Rejected before the sweep, so the ask it would have lifted stays
+    Order far_bid(Strategy::OTHER, 20, 1e9, OrderSide::BUY, OrderType::LIMIT);
+    EXPECT_TRUE(book.match_orders(far_bid).rejected);
+    EXPECT_EQ(book.find_order(ask.get_id())->quantity, 10);
+
+    // An IOC never rests, so its limit may be anywhere
+    Order ioc(Strategy::OTHER, 5, 1e9, OrderSide::BUY, OrderType::IOC);
+    EXPECT_EQ(book.match_orders(ioc).filled_quantity, 5);
+
+    Order near_ask(Strategy::OTHER, 10, 105.0, OrderSide::SELL, OrderType::LIMIT);
+    EXPECT_FALSE(book.match_orders(near_ask).rejected);
+    EXPECT_FALSE(book.amend_order(near_ask.get_id(), 1e9, 10));
+    EXPECT_FALSE(book.amend_order(near_ask.get_id(), 0.0, 10));
+    EXPECT_EQ(book.find_order(near_ask.get_id())->tick, book.price_to_tick(105.0));
+}
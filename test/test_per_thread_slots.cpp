@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include "PerThreadSlots.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct Count
+    {
+        int value = 0;
+    };
+
+    size_t slot_count(const PerThreadSlots<Count> &slots)
+    {
+        size_t count = 0;
+        slots.for_each([&](const Count &) { ++count; });
+        return count;
+    }
+
+    int sum(const PerThreadSlots<Count> &slots)
+    {
+        int total = 0;
+        slots.for_each([&](const Count &slot) { total += slot.value; });
+        return total;
+    }
+}
+
+TEST(PerThreadSlotsTest, EachThreadKeepsItsSlot)
+{
+    PerThreadSlots<Count> slots;
+    Count &mine = slots.local();
+    mine.value = 7;
+    EXPECT_EQ(&slots.local(), &mine);
+
+    std::thread other([&] { slots.local().value = 1; });
+    other.join();
+    EXPECT_EQ(mine.value, 7);
+    EXPECT_EQ(sum(slots), 8);
+}
+
+TEST(PerThreadSlotsTest, ExitedThreadsHandTheirSlotsOn)
+{
+    PerThreadSlots<Count> slots;
+    for (int i = 0; i < 50; ++i)
+    {
+        std::thread worker([&] { ++slots.local().value; });
+        worker.join();
+    }
+    // One slot passed from thread to thread, counts and all
+    EXPECT_EQ(slot_count(slots), 1u);
+    EXPECT_EQ(sum(slots), 50);
+}
+
+TEST(PerThreadSlotsTest, ConcurrentThreadsGetSeparateSlots)
+{
+    PerThreadSlots<Count> slots;
+    const int threads = 4;
+    std::atomic<int> claimed(0);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&]
+                             {
+            ++slots.local().value;
+            // Hold the slot until every thread has one
+            claimed.fetch_add(1);
+            while (claimed.load() < threads)
+            {
+                std::this_thread::yield();
+            } });
+    }
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+    EXPECT_EQ(slot_count(slots), static_cast<size_t>(threads));
+    EXPECT_EQ(sum(slots), threads);
+}
+
+TEST(PerThreadSlotsTest, ThreadMayOutliveTheOwner)
+{
+    std::thread worker([]
+                       {
+        for (int i = 0; i < 10; ++i)
+        {
+            PerThreadSlots<Count> slots;
+            slots.local().value = i;
+            EXPECT_EQ(sum(slots), i);
+        } });
+    worker.join();
+}
@@ -0,0 +1,413 @@
+#include <gtest/gtest.h>
+#include "MatchingEngine.h"
+#include "OrderIdAllocator.h"
+#include "Recovery.h"
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+class RecoveryTest : public ::testing::Test
+{
+protected:
+    std::string journal_path;
+    std::string snapshot_path;
+
+    void SetUp() override
+    {
+        std::string name = ::testing::UnitTest::GetInstance()->current_test_info()->name();
+        journal_path = ::testing::TempDir() + "recovery_test_" + name + ".log";
+        snapshot_path = ::testing::TempDir() + "recovery_test_" + name + ".snap";
+        std::remove(journal_path.c_str());
+        std::remove(snapshot_path.c_str());
+    }
+
+    void TearDown() override
+    {
+        std::remove(journal_path.c_str());
+        std::remove(snapshot_path.c_str());
+    }
+
+    MatchingEngineConfig make_config(bool recover)
+    {
+        MatchingEngineConfig config;
+        config.journal.path = journal_path;
+        config.journal.initial_records = 1024;
+        config.journal.recover = recover;
+        return config;
+    }
+
+    static void wait_for(MatchingEngine &engine, uint64_t commands)
+    {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (engine.get_stats().commands_processed < commands && std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    // Crossing flow over two symbols: fills, partial fills, rests, amends and cancels
+    static uint64_t drive(MatchingEngine &engine, int rounds)
+    {
+        uint64_t commands = 0;
+        for (int i = 0; i < rounds; ++i)
+        {
+            SymbolId symbol = i % 2;
+            Order bid(Strategy::OTHER, 10 + i % 7, 100.0 - (i % 5) * 0.01, OrderSide::BUY, OrderType::LIMIT, symbol);
+            Order ask(Strategy::OTHER, 8 + i % 5, 100.02 - (i % 4) * 0.01, OrderSide::SELL, OrderType::LIMIT, symbol);
+            engine.process_order(bid);
+            engine.process_order(ask);
+            commands += 2;
+            if (i % 3 == 0)
+            {
+                engine.cancel_order(bid.get_id(), symbol);
+                ++commands;
+            }
+            if (i % 4 == 1)
+            {
+                engine.amend_order(ask.get_id(), symbol, 100.03 - (i % 3) * 0.01, 4);
+                ++commands;
+            }
+        }
+        return commands;
+    }
+
+    static BookSnapshot depth(MatchingEngine &engine, SymbolId symbol)
+    {
+        BookSnapshot snapshot;
+        EXPECT_TRUE(engine.get_snapshot(symbol, 0, snapshot));
+        return snapshot;
+    }
+
+    static void expect_same_levels(const std::vector<LevelQuantity> &lhs, const std::vector<LevelQuantity> &rhs)
+    {
+        ASSERT_EQ(lhs.size(), rhs.size());
+        for (size_t i = 0; i < lhs.size(); ++i)
+        {
+            EXPECT_DOUBLE_EQ(lhs[i].price, rhs[i].price);
+            EXPECT_EQ(lhs[i].quantity, rhs[i].quantity);
+        }
+    }
+};
+
+TEST_F(RecoveryTest, ReplayRebuildsTheSameBooks)
+{
+    std::map<SymbolId, BookSnapshot> before;
+    {
+        MatchingEngine engine(make_config(false));
+        uint64_t commands = drive(engine, 200);
+        wait_for(engine, commands);
+        before[0] = depth(engine, 0);
+        before[1] = depth(engine, 1);
+    }
+
+    MatchingEngine engine(make_config(true));
+    const RecoveryStats &stats = engine.get_recovery_stats();
+    EXPECT_EQ(stats.snapshot_sequence, 0);
+    EXPECT_EQ(stats.replayed_commands, stats.last_sequence);
+    EXPECT_GT(stats.replayed_commands, 0);
+
+    for (SymbolId symbol : {0u, 1u})
+    {
+        BookSnapshot after = depth(engine, symbol);
+        expect_same_levels(before[symbol].bids, after.bids);
+        expect_same_levels(before[symbol].asks, after.asks);
+    }
+
+    // New commands are journaled after the replayed ones
+    Order order(Strategy::OTHER, 1, 90.0, OrderSide::BUY, OrderType::LIMIT, 0);
+    engine.process_order(order);
+    depth(engine, 0); // queued behind the order, so it has been journaled
+    EXPECT_EQ(engine.get_stats().journaled_commands, stats.last_sequence + 1);
+}
+
+TEST_F(RecoveryTest, RestartReplaysOnlyTheTailAfterTheSnapshot)
+{
+    std::map<SymbolId, BookSnapshot> before;
+    uint64_t journaled;
+    {
+        MatchingEngineConfig config = make_config(false);
+        config.journal.snapshot_path = snapshot_path;
+        config.journal.snapshot_interval = 50;
+        MatchingEngine engine(config);
+
+        uint64_t commands = drive(engine, 100);
+        wait_for(engine, commands);
+        // Wait for a snapshot, then add a tail it does not cover
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (engine.get_stats().snapshots_written == 0 && std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        ASSERT_GE(engine.get_stats().snapshots_written, 1);
+        commands += drive(engine, 10);
+        wait_for(engine, commands);
+
+        before[0] = depth(engine, 0);
+        before[1] = depth(engine, 1);
+        journaled = engine.get_stats().journaled_commands;
+    }
+
+    MatchingEngineConfig config = make_config(true);
+    config.journal.snapshot_path = snapshot_path;
+    MatchingEngine engine(config);
+    const RecoveryStats &stats = engine.get_recovery_stats();
+    EXPECT_GT(stats.snapshot_sequence, 0);
+    EXPECT_EQ(stats.last_sequence, journaled);
+    EXPECT_EQ(stats.replayed_commands, journaled - stats.snapshot_sequence);
+    EXPECT_LT(stats.replayed_commands, journaled);
+
+    for (SymbolId symbol : {0u, 1u})
+    {
+        BookSnapshot after = depth(engine, symbol);
+        expect_same_levels(before[symbol].bids, after.bids);
+        expect_same_levels(before[symbol].asks, after.asks);
+    }
+}
+
+TEST_F(RecoveryTest, SnapshotKeepsTimePriority)
+{
+    OrderBook book;
+    std::vector<uint64_t> ids;
+    for (int i = 0; i < 5; ++i)
+    {
+        Order order(Strategy::OTHER, 10 + i, 50.0, OrderSide::BUY, OrderType::LIMIT, 3);
+        ids.push_back(order.get_id());
+        book.add_order(order);
+    }
+    Order ask(Strategy::OTHER, 4, 51.0, OrderSide::SELL, OrderType::LIMIT, 3);
+    book.add_order(ask);
+
+    ASSERT_TRUE(write_book_snapshot(snapshot_path, 42, {{3, &book}}));
+
+    MappedBookSnapshot snapshot(snapshot_path);
+    EXPECT_EQ(snapshot.journal_sequence(), 42);
+    ASSERT_EQ(snapshot.book_count(), 1);
+    EXPECT_EQ(snapshot.order_count(), 6);
+    EXPECT_TRUE(snapshot.verify());
+
+    OrderBook restored;
+    ASSERT_TRUE(snapshot.restore(snapshot.books()[0], restored));
+    OrderQueue level = restored.get_bids(50.0);
+    ASSERT_EQ(level.size(), ids.size());
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+        EXPECT_EQ(level[i].get_id(), ids[i]);
+        EXPECT_EQ(level[i].get_quantity(), 10 + static_cast<int>(i));
+    }
+    EXPECT_DOUBLE_EQ(restored.get_best_ask(), 51.0);
+}
+
+TEST_F(RecoveryTest, MissingSnapshotReplaysTheWholeJournal)
+{
+    {
+        JournalWriter writer(journal_path, 16);
+        Order order(Strategy::OTHER, 5, 50.0, OrderSide::BUY, OrderType::LIMIT, 1);
+        JournalRecord record{};
+        record.type = JournalRecordType::SUBMIT;
+        record.order_id = order.get_id();
+        record.price = order.get_price();
+        record.quantity = order.get_quantity();
+        record.symbol_id = 1;
+        record.side = static_cast<uint8_t>(OrderSide::BUY);
+        record.order_type = static_cast<uint8_t>(OrderType::LIMIT);
+        record.strategy = static_cast<uint8_t>(Strategy::OTHER);
+        writer.append(record);
+    }
+
+    std::map<SymbolId, std::unique_ptr<OrderBook>> books;
+    RecoveryStats stats = recover_books(snapshot_path, journal_path, TickSizes(), PriceLadder::kDefaultMaxLevels,
+                                        [&](SymbolId symbol_id) -> OrderBook &
+                                        {
+        std::unique_ptr<OrderBook> &book = books[symbol_id];
+        if (!book)
+        {
+            book = std::make_unique<OrderBook>();
+        }
+        return *book; });
+    EXPECT_EQ(stats.snapshot_sequence, 0);
+    EXPECT_EQ(stats.replayed_commands, 1);
+    ASSERT_EQ(books.count(1), 1);
+    EXPECT_DOUBLE_EQ(books[1]->get_best_bid(), 50.0);
+}
+
+TEST_F(RecoveryTest, SnapshotNewerThanJournalIsRejected)
+{
+    ASSERT_TRUE(write_book_snapshot(snapshot_path, 10, {}));
+    {
+        JournalWriter writer(journal_path, 16);
+        JournalRecord record{};
+        record.type = JournalRecordType::CANCEL;
+        writer.append(record);
+    }
+
+    std::map<SymbolId, std::unique_ptr<OrderBook>> books;
+    auto book_for = [&](SymbolId symbol_id) -> OrderBook &
+    {
+        std::unique_ptr<OrderBook> &book = books[symbol_id];
+        if (!book)
+        {
+            book = std::make_unique<OrderBook>();
+        }
+        return *book;
+    };
+    EXPECT_THROW(recover_books(snapshot_path, journal_path, TickSizes(), PriceLadder::kDefaultMaxLevels, book_for),
+                 std::runtime_error);
+}
+
+TEST_F(RecoveryTest, SnapshotOrderTheBookRefusesFailsRecovery)
+{
+    OrderBook book;
+    Order order(Strategy::OTHER, 5, 50.0, OrderSide::BUY, OrderType::LIMIT, 1);
+    book.add_order(order);
+    ASSERT_TRUE(write_book_snapshot(snapshot_path, 0, {{1, &book}}));
+
+    // The target book already holds the id, as a damaged or doubled snapshot would leave it
+    OrderBook target;
+    Order resting(order);
+    target.add_order(resting);
+    EXPECT_THROW(recover_books(snapshot_path, journal_path, TickSizes(), PriceLadder::kDefaultMaxLevels,
+                               [&](SymbolId) -> OrderBook & { return target; }),
+                 std::runtime_error);
+}
+
+TEST_F(RecoveryTest, SnapshotsAndReplayKeepTheEnginesPriceBand)
+{
+    MatchingEngineConfig config = make_config(false);
+    config.max_price_levels = 100;
+    config.journal.snapshot_path = snapshot_path;
+    config.journal.snapshot_interval = 1;
+    {
+        MatchingEngine engine(config);
+        Order near(Strategy::OTHER, 10, 100.0, OrderSide::BUY, OrderType::LIMIT, 0);
+        Order far(Strategy::OTHER, 5, 50.0, OrderSide::BUY, OrderType::LIMIT, 0); // outside the band: rejected
+        engine.process_order(near);
+        engine.process_order(far);
+        wait_for(engine, 2);
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (engine.get_stats().snapshots_written < 2 && std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        ASSERT_GE(engine.get_stats().snapshots_written, 2);
+    }
+
+    {
+        MappedBookSnapshot snapshot(snapshot_path);
+        EXPECT_EQ(snapshot.journal_sequence(), 2);
+        ASSERT_EQ(snapshot.book_count(), 1);
+        EXPECT_EQ(snapshot.books()[0].max_price_levels, 100);
+        EXPECT_EQ(snapshot.order_count(), 1);
+    }
+
+    config.journal.recover = true;
+    {
+        MatchingEngine engine(config);
+        BookSnapshot after = depth(engine, 0);
+        ASSERT_EQ(after.bids.size(), 1);
+        EXPECT_DOUBLE_EQ(after.bids[0].price, 100.0);
+    }
+
+    // Books with another band would have accepted the rejected order
+    config.max_price_levels = PriceLadder::kDefaultMaxLevels;
+    EXPECT_THROW(MatchingEngine engine(config), std::runtime_error);
+    std::map<SymbolId, std::unique_ptr<OrderBook>> books;
+    auto book_for = [&](SymbolId symbol_id) -> OrderBook &
+    {
+        std::unique_ptr<OrderBook> &book = books[symbol_id];
+        if (!book)
+        {
+            book = std::make_unique<OrderBook>();
+        }
+        return *book;
+    };
+    EXPECT_THROW(recover_books(snapshot_path, journal_path, TickSizes(), PriceLadder::kDefaultMaxLevels, book_for),
+                 std::runtime_error);
+    EXPECT_THROW(recover_books("", journal_path, TickSizes(), PriceLadder::kDefaultMaxLevels, book_for), std::runtime_error);
+}
+
+TEST_F(RecoveryTest, SnapshotsAndReplayKeepEachSymbolsTickSize)
+{
+    MatchingEngineConfig config = make_config(false);
+    config.tick_sizes.per_symbol[1] = 0.25;
+    config.journal.snapshot_path = snapshot_path;
+    config.journal.snapshot_interval = 1;
+    {
+        MatchingEngine engine(config);
+        Order quarter(Strategy::OTHER, 10, 100.25, OrderSide::BUY, OrderType::LIMIT, 1);
+        Order cent(Strategy::OTHER, 5, 99.99, OrderSide::BUY, OrderType::LIMIT, 0);
+        engine.process_order(quarter);
+        engine.process_order(cent);
+        wait_for(engine, 2);
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (engine.get_stats().snapshots_written < 2 && std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        ASSERT_GE(engine.get_stats().snapshots_written, 2);
+    }
+
+    {
+        MappedBookSnapshot snapshot(snapshot_path);
+        ASSERT_EQ(snapshot.book_count(), 2);
+        for (size_t i = 0; i < snapshot.book_count(); ++i)
+        {
+            const SnapshotBook &entry = snapshot.books()[i];
+            EXPECT_DOUBLE_EQ(entry.tick_size, entry.symbol_id == 1 ? 0.25 : 0.01);
+        }
+    }
+
+    config.journal.recover = true;
+    {
+        MatchingEngine engine(config);
+        BookSnapshot quarter = depth(engine, 1);
+        ASSERT_EQ(quarter.bids.size(), 1);
+        EXPECT_DOUBLE_EQ(quarter.bids[0].price, 100.25);
+        BookSnapshot cent = depth(engine, 0);
+        ASSERT_EQ(cent.bids.size(), 1);
+        EXPECT_DOUBLE_EQ(cent.bids[0].price, 99.99);
+    }
+
+    // On another grid the journaled prices would land on other levels
+    config.tick_sizes.per_symbol[1] = 0.5;
+    EXPECT_THROW(MatchingEngine engine(config), std::runtime_error);
+    std::map<SymbolId, std::unique_ptr<OrderBook>> books;
+    auto book_for = [&](SymbolId symbol_id) -> OrderBook &
+    {
+        std::unique_ptr<OrderBook> &book = books[symbol_id];
+        if (!book)
+        {
+            book = std::make_unique<OrderBook>(config.tick_sizes.for_symbol(symbol_id));
+        }
+        return *book;
+    };
+    EXPECT_THROW(recover_books(snapshot_path, journal_path, config.tick_sizes, PriceLadder::kDefaultMaxLevels, book_for),
+                 std::runtime_error);
+}
+
+TEST_F(RecoveryTest, NewOrderIdsStayAboveRecoveredOnes)
+{
+    // As if journaled by an earlier process whose ids ran far ahead of ours
+    const uint64_t recovered_id = OrderIdAllocator::next() + 1000000;
+    {
+        JournalWriter writer(journal_path, 16);
+        JournalRecord record{};
+        record.type = JournalRecordType::SUBMIT;
+        record.order_id = recovered_id;
+        record.symbol_id = 3;
+        record.price = 10.0;
+        record.quantity = 5;
+        record.side = static_cast<uint8_t>(OrderSide::BUY);
+        record.order_type = static_cast<uint8_t>(OrderType::LIMIT);
+        writer.append(record);
+        ASSERT_TRUE(writer.sync());
+    }
+
+    MatchingEngine engine(make_config(true));
+    EXPECT_EQ(engine.get_recovery_stats().max_order_id, recovered_id);
+    Order order(Strategy::OTHER, 1, 9.0, OrderSide::BUY, OrderType::LIMIT, 3);
+    EXPECT_GT(order.get_id(), recovered_id);
+}
@@ -0,0 +1,190 @@
+#include <gtest/gtest.h>
+#include "ShardedMatchingEngine.h"
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+
+class ShardedMatchingEngineTest : public ::testing::Test
+{
+protected:
+    // Books reported by the per-batch hook: symbol -> (matching thread, resting orders)
+    struct BookView
+    {
+        std::set<std::thread::id> threads;
+        size_t resting_orders = 0;
+    };
+
+    std::mutex mutex;
+    std::map<SymbolId, BookView> books;
+
+    ShardedEngineConfig make_config(size_t shard_count)
+    {
+        ShardedEngineConfig config;
+        config.shard_count = shard_count;
+        config.engine.on_batch = [this](SymbolId symbol_id, const OrderBook &book)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            books[symbol_id].threads.insert(std::this_thread::get_id());
+            books[symbol_id].resting_orders = book.order_count();
+        };
+        return config;
+    }
+
+    void wait_for(ShardedMatchingEngine &engine, uint64_t commands)
+    {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (engine.get_stats().commands_processed < commands && std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10)); // let the last hook run
+    }
+};
+
+TEST_F(ShardedMatchingEngineTest, ZeroShardsThrows)
+{
+    ShardedEngineConfig config;
+    config.shard_count = 0;
+    EXPECT_THROW(ShardedMatchingEngine engine(config), std::invalid_argument);
+}
+
+TEST_F(ShardedMatchingEngineTest, SymbolsMapToStableShards)
+{
+    ShardedEngineConfig config;
+    config.shard_count = 4;
+    ShardedMatchingEngine engine(config);
+
+    EXPECT_EQ(engine.shard_count(), 4);
+    for (SymbolId symbol = 0; symbol < 64; ++symbol)
+    {
+        EXPECT_EQ(engine.shard_for(symbol), engine.shard_for(symbol));
+        EXPECT_LT(engine.shard_for(symbol), 4);
+    }
+}
+
+TEST_F(ShardedMatchingEngineTest, EachSymbolHasItsOwnBookAndThread)
+{
+    ShardedMatchingEngine engine(make_config(3));
+
+    const SymbolId num_symbols = 12;
+    const int orders_per_symbol = 50;
+    for (int i = 0; i < orders_per_symbol; ++i)
+    {
+        for (SymbolId symbol = 0; symbol < num_symbols; ++symbol)
+        {
+            // Same price on both sides of different symbols must never cross
+            OrderSide side = symbol % 2 ? OrderSide::BUY : OrderSide::SELL;
+            Order order(Strategy::OTHER, 10, 50.0, side, OrderType::LIMIT, symbol);
+            engine.process_order(order);
+        }
+    }
+    wait_for(engine, num_symbols * orders_per_symbol);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_EQ(books.size(), num_symbols);
+    std::set<std::thread::id> all_threads;
+    for (const auto &entry : books)
+    {
+        EXPECT_EQ(entry.second.threads.size(), 1) << "symbol " << entry.first << " matched on several threads";
+        EXPECT_EQ(entry.second.resting_orders, orders_per_symbol);
+        all_threads.insert(*entry.second.threads.begin());
+    }
+    EXPECT_EQ(all_threads.size(), 3);
+}
+
+TEST_F(ShardedMatchingEngineTest, CancelIsRoutedToTheOrdersSymbol)
+{
+    ShardedMatchingEngine engine(make_config(2));
+
+    Order order(Strategy::OTHER, 10, 50.0, OrderSide::BUY, OrderType::LIMIT, 5);
+    engine.process_order(order);
+    engine.cancel_order(order.get_id(), 4); // wrong symbol: no-op
+    wait_for(engine, 2);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        EXPECT_EQ(books[5].resting_orders, 1);
+    }
+
+    engine.cancel_order(order.get_id(), 5);
+    wait_for(engine, 3);
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(books[5].resting_orders, 0);
+}
+
+TEST_F(ShardedMatchingEngineTest, PinnedShardsStillMatch)
+{
+    ShardedEngineConfig config = make_config(2);
+    config.cpus = {0}; // second shard stays unpinned
+    ShardedMatchingEngine engine(config);
+
+    Order sell(Strategy::OTHER, 10, 50.0, OrderSide::SELL, OrderType::LIMIT, 1);
+    Order buy(Strategy::OTHER, 10, 50.0, OrderSide::BUY, OrderType::LIMIT, 1);
+    engine.process_order(sell);
+    engine.process_order(buy);
+    wait_for(engine, 2);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(books[1].resting_orders, 0);
+}
+
+TEST_F(ShardedMatchingEngineTest, ExecutionWaitWakesOnAnyShard)
+{
+    ShardedMatchingEngine engine(make_config(2));
+    std::vector<uint64_t> cursors;
+    for (size_t shard = 0; shard < engine.shard_count(); ++shard)
+    {
+        cursors.push_back(engine.get_shard(shard).get_execution_stream().published());
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    engine.wait_for_executions(cursors, std::chrono::milliseconds(20));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(20));
+
+    const SymbolId symbol = 1;
+    std::thread trader([&]
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        Order sell(Strategy::OTHER, 10, 50.0, OrderSide::SELL, OrderType::LIMIT, symbol);
+        Order buy(Strategy::OTHER, 10, 50.0, OrderSide::BUY, OrderType::LIMIT, symbol);
+        engine.process_order(sell);
+        engine.process_order(buy);
+    });
+    start = std::chrono::steady_clock::now();
+    engine.wait_for_executions(cursors, std::chrono::seconds(5));
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+    trader.join();
+    EXPECT_GT(engine.get_shard(engine.shard_for(symbol)).get_execution_stream().published(),
+              cursors[engine.shard_for(symbol)]);
+}
+
+TEST_F(ShardedMatchingEngineTest, RefusesJournalsFromAnotherShardCount)
+{
+    const std::string path = ::testing::TempDir() + "sharded_layout_test.log";
+    for (const std::string &file : {path, path + ".0", path + ".1", path + ".2"})
+    {
+        std::remove(file.c_str());
+    }
+
+    ShardedEngineConfig config = make_config(2);
+    config.engine.journal.path = path;
+    config.engine.journal.initial_records = 16;
+    {
+        ShardedMatchingEngine engine(config);
+    }
+
+    // A single shard would read the bare path and three would misroute symbols
+    config.shard_count = 1;
+    EXPECT_THROW(ShardedMatchingEngine engine(config), std::runtime_error);
+    config.shard_count = 3;
+    EXPECT_THROW(ShardedMatchingEngine engine(config), std::runtime_error);
+    config.shard_count = 2;
+    EXPECT_NO_THROW(ShardedMatchingEngine engine(config));
+
+    for (const std::string &file : {path, path + ".0", path + ".1", path + ".2"})
+    {
+        std::remove(file.c_str());
+    }
+}
@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+#include "ThroughputMeter.h"
+#include <chrono>
+#include <thread>
+#include <vector>
+
+TEST(ThroughputMeterTest, TotalSumsEveryThread)
+{
+    ThroughputMeter meter;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&meter]
+                             {
+            for (int i = 0; i < 10000; ++i)
+            {
+                meter.add();
+            } });
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+    meter.add(5);
+    EXPECT_EQ(meter.total(), 40005);
+    EXPECT_EQ(meter.stats().total, 40005);
+}
+
+TEST(ThroughputMeterTest, ExitedThreadsStillCount)
+{
+    ThroughputMeter meter;
+    for (int t = 0; t < 20; ++t)
+    {
+        std::thread thread([&meter] { meter.add(3); });
+        thread.join();
+    }
+    EXPECT_EQ(meter.total(), 60);
+}
+
+TEST(ThroughputMeterTest, WindowedRateTracksRecentEvents)
+{
+    ThroughputMeter meter(std::chrono::milliseconds(10));
+    // About 20000/s for 1.2s, then nothing
+    auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(1200);
+    while (std::chrono::steady_clock::now() < end)
+    {
+        meter.add(20);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    ThroughputStats busy = meter.stats();
+    EXPECT_GT(busy.per_second_1s, 1000.0);
+    EXPECT_LT(busy.per_second_1s, 25000.0);
+    EXPECT_GT(busy.peak_per_second, 1000.0);
+
+    // The 1s window empties once the burst is a second old; the peak stays
+    std::this_thread::sleep_for(std::chrono::milliseconds(1200));
+    ThroughputStats idle = meter.stats();
+    EXPECT_DOUBLE_EQ(idle.per_second_1s, 0.0);
+    EXPECT_GT(idle.per_second_10s, 0.0);
+    EXPECT_GE(idle.peak_per_second, busy.peak_per_second);
+}
@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+#include "TickSizes.h"
+
+TEST(TickSizesTest, OverridesFallBackToTheDefault)
+{
+    TickSizes tick_sizes;
+    tick_sizes.default_tick_size = 0.01;
+    ASSERT_TRUE(tick_sizes.add_override("7=0.25"));
+    EXPECT_DOUBLE_EQ(tick_sizes.for_symbol(7), 0.25);
+    EXPECT_DOUBLE_EQ(tick_sizes.for_symbol(8), 0.01);
+    EXPECT_TRUE(tick_sizes.valid());
+
+    tick_sizes.per_symbol[9] = 0.0;
+    EXPECT_FALSE(tick_sizes.valid());
+}
+
+TEST(TickSizesTest, MalformedOverridesAreRefused)
+{
+    TickSizes tick_sizes;
+    EXPECT_FALSE(tick_sizes.add_override("7"));
+    EXPECT_FALSE(tick_sizes.add_override("=0.5"));
+    EXPECT_FALSE(tick_sizes.add_override("7="));
+    EXPECT_FALSE(tick_sizes.add_override("x=0.5"));
+    EXPECT_FALSE(tick_sizes.add_override("-1=0.5"));
+    EXPECT_FALSE(tick_sizes.add_override("7=0.5abc"));
+    EXPECT_FALSE(tick_sizes.add_override("99999999999=0.5"));
+    EXPECT_TRUE(tick_sizes.per_symbol.empty());
+}
+
+TEST(TickSizesTest, DigestIgnoresInsertionOrderButNotTicks)
+{
+    TickSizes forward;
+    forward.per_symbol[1] = 0.5;
+    forward.per_symbol[2] = 0.05;
+    TickSizes backward;
+    backward.per_symbol[2] = 0.05;
+    backward.per_symbol[1] = 0.5;
+    EXPECT_EQ(forward.digest(), backward.digest());
+
+    // Spelling out the default changes no book
+    TickSizes spelled;
+    spelled.per_symbol[3] = spelled.default_tick_size;
+    EXPECT_EQ(spelled.digest(), TickSizes().digest());
+
+    backward.per_symbol[1] = 0.25;
+    EXPECT_NE(forward.digest(), backward.digest());
+    TickSizes coarser;
+    coarser.default_tick_size = 0.05;
+    EXPECT_NE(coarser.digest(), TickSizes().digest());
+}
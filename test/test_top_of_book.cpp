@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include "TopOfBook.h"
+#include <atomic>
+#include <thread>
+
+namespace
+{
+    // Quantities always mirror the sequence, so a torn read breaks the pattern
+    TopOfBook make_top(SymbolId symbol_id, uint64_t sequence)
+    {
+        TopOfBook top{};
+        top.sequence = sequence;
+        top.symbol_id = symbol_id;
+        top.has_bid = true;
+        top.bid_price = 50.0;
+        top.bid_quantity = static_cast<int64_t>(sequence);
+        top.has_ask = true;
+        top.ask_price = 51.0;
+        top.ask_quantity = -static_cast<int64_t>(sequence);
+        return top;
+    }
+}
+
+TEST(TopOfBookTableTest, UnknownSymbolReadsNothing)
+{
+    TopOfBookTable table(8);
+    TopOfBook top;
+    EXPECT_FALSE(table.read(3, top));
+
+    // Claimed but never published
+    table.claim(3);
+    EXPECT_FALSE(table.read(3, top));
+}
+
+TEST(TopOfBookTableTest, ReadsLatestPerSymbol)
+{
+    TopOfBookTable table(8);
+    size_t first = table.claim(1);
+    size_t second = table.claim(2);
+    ASSERT_NE(first, second);
+    EXPECT_EQ(table.claim(1), first);
+
+    table.publish(first, make_top(1, 10));
+    table.publish(second, make_top(2, 20));
+    table.publish(first, make_top(1, 11));
+
+    TopOfBook top;
+    ASSERT_TRUE(table.read(1, top));
+    EXPECT_EQ(top.symbol_id, 1);
+    EXPECT_EQ(top.sequence, 11);
+    EXPECT_EQ(top.bid_quantity, 11);
+    ASSERT_TRUE(table.read(2, top));
+    EXPECT_EQ(top.sequence, 20);
+}
+
+TEST(TopOfBookTableTest, FullTableRefusesNewSymbols)
+{
+    TopOfBookTable table(2);
+    EXPECT_NE(table.claim(1), TopOfBookTable::kNoSlot);
+    EXPECT_NE(table.claim(2), TopOfBookTable::kNoSlot);
+    EXPECT_EQ(table.claim(3), TopOfBookTable::kNoSlot);
+    TopOfBook top;
+    EXPECT_FALSE(table.read(3, top));
+}
+
+TEST(TopOfBookTableTest, ConcurrentReaderNeverSeesTornRecords)
+{
+    TopOfBookTable table(8);
+    size_t slot = table.claim(7);
+    table.publish(slot, make_top(7, 1));
+    const uint64_t total = 200000;
+    std::atomic<bool> done(false);
+
+    std::thread reader([&]
+                       {
+        uint64_t last_sequence = 0;
+        TopOfBook top;
+        while (!done.load())
+        {
+            ASSERT_TRUE(table.read(7, top));
+            EXPECT_EQ(top.bid_quantity, static_cast<int64_t>(top.sequence));
+            EXPECT_EQ(top.ask_quantity, -static_cast<int64_t>(top.sequence));
+            EXPECT_GE(top.sequence, last_sequence);
+            last_sequence = top.sequence;
+        } });
+
+    for (uint64_t i = 2; i <= total; ++i)
+    {
+        table.publish(slot, make_top(7, i));
+    }
+    done.store(true);
+    reader.join();
+}